@@ -2,9 +2,20 @@
 
 #include "utils/logging/logger.h"
 #include "core_structures.h"
+#include "message_dispatcher.h"
+#include "epoch_readers.h"
+#include "dependency_graph.h"
+#include "topology_tracker.h"
+#include "utils/executor/work_stealing_executor.h"
+#include "utils/memory_allocation/allocator_interface_core.h"
+#include "utils/memory_allocation/allocation_tracker.h"
 
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace aergo::core
 {
@@ -24,11 +35,16 @@ namespace aergo::core
         void initialize(const char* modules_dir, const char* data_dir);
 
         virtual void sendMessage(aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept override final;
+        virtual aergo::module::IPublishHandle* getPublishHandle(aergo::module::ChannelIdentifier source_channel) noexcept override final;
+        virtual void sendMessage(aergo::module::IPublishHandle* publish_handle, aergo::module::message::MessageHeader message) noexcept override final;
         virtual void sendResponse(aergo::module::ChannelIdentifier source_channel, aergo::module::ChannelIdentifier target_channel, aergo::module::message::MessageHeader message) noexcept override final;
         virtual void sendRequest(aergo::module::ChannelIdentifier source_channel, aergo::module::ChannelIdentifier target_channel, aergo::module::message::MessageHeader message) noexcept override final;
-        virtual aergo::module::IAllocator* createDynamicAllocator() noexcept override final;
-        virtual aergo::module::IAllocator* createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots) noexcept override final;
+        virtual aergo::module::IAllocator* createDynamicAllocator(uint64_t module_id, aergo::module::AllocationOptions options) noexcept override final;
+        virtual aergo::module::IAllocator* createBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::module::AllocationOptions options) noexcept override final;
+        virtual aergo::module::IAllocator* createElasticBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, aergo::module::ElasticBufferOptions options, aergo::module::AllocationOptions allocation_options) noexcept override final;
+        virtual aergo::module::IAllocator* createMappedFileAllocator(uint64_t module_id, const char* path, aergo::module::MappedFileOptions options) noexcept override final;
         virtual void deleteAllocator(aergo::module::IAllocator* allocator) noexcept override final;
+        virtual aergo::module::IExecutor* getExecutor(bool prioritized) noexcept override final;
 
         /// @return nullptr if out of range
         virtual const aergo::module::ModuleInfo* getLoadedModulesInfo(uint64_t loaded_module_id) noexcept override final;
@@ -41,7 +57,7 @@ namespace aergo::core
         /// For example if we create A,B,C,D,E -> 5; if we now remove C, D -> 5; if we add F -> 6.
         uint64_t getCreatedModulesCount();
 
-        /// @brief ID of the module mapping state. ID changes when modules get created or destroyed.
+        /// @brief ID of the module mapping state. ID changes when modules get created or destroyed. Does not lock (reads the routing table in a read section).
         virtual uint64_t getModulesMappingStateId() noexcept override final;
 
         /// @brief Get existing publish channels for specified channel type identifier. 
@@ -69,26 +85,107 @@ namespace aergo::core
         /// @return true on success (module added), false otherwise (module not added)
         virtual bool addModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info) noexcept override final;
 
+        /// @brief Timing of initialize, by module and phase (also logged at the end of initialize).
+        structures::StartupReport getStartupReport();
+
         /// @brief Find all dependent modules and return them in a vector. Vector includes the calling module 
-        /// (if no dependent modules, the vector will have size 1 and contain only the calling id).
+        /// (if no dependent modules, the vector will have size 1 and contain only the calling id). Sorted by ID, dependencies before dependents.
         std::vector<uint64_t> collectDependentModules(uint64_t id);
 
 
         virtual bool removeModuleById(uint64_t id, bool recursive) noexcept override final;
+        virtual bool applyModuleBatch(aergo::module::ModuleBatch batch) noexcept override final;
         virtual aergo::module::RunningModuleInfo getRunningModulesInfo(uint64_t running_module_id) noexcept override final;  // wrapper, does not lock
         virtual uint64_t getRunningModulesCount() noexcept override final; // wrapper, does not lock
         virtual aergo::module::message::SharedDataBlob collectDependencies(uint64_t id) noexcept override final; // wrapper, does not lock
         virtual aergo::module::message::SharedDataBlob getExistingPublishChannelsByName(const char* channel_type_identifier) noexcept override final; // wrapper, does not lock
         virtual aergo::module::message::SharedDataBlob getExistingResponseChannelsByName(const char* channel_type_identifier) noexcept override final; // wrapper, does not lock
+        virtual aergo::module::message::SharedDataBlob getTopologySnapshot() noexcept override final;
+        virtual aergo::module::MemoryStats getModuleMemoryStats(uint64_t module_id) noexcept override final;
+        virtual aergo::module::message::SharedDataBlob getModuleAllocatorsMemoryStats(uint64_t module_id) noexcept override final;
+        virtual void setModuleMemoryQuota(uint64_t module_id, uint64_t quota_bytes) noexcept override final;
+        virtual void setAllocationSampling(uint32_t sample_period) noexcept override final;
+        virtual aergo::module::message::SharedDataBlob getOutstandingAllocations(uint64_t min_age_ns) noexcept override final;
+
+        static constexpr uint64_t CORE_MEMORY_ACCOUNT_ID = UINT64_MAX;    // module ID the core's own allocations are accounted to
 
 
     private:
         enum class ConsumerType { SUBSCRIBE, REQUEST };
 
+        /// @brief Results of control queries for the current mapping state, shared by all callers until commitMappingChange clears them.
+        struct QueryCache
+        {
+            std::unordered_map<uint64_t, aergo::module::RunningModuleInfo> running_modules_info_;
+            std::unordered_map<uint64_t, aergo::module::message::SharedDataBlob> dependencies_;
+            std::unordered_map<std::string, aergo::module::message::SharedDataBlob> publish_channels_;
+            std::unordered_map<std::string, aergo::module::message::SharedDataBlob> response_channels_;
+            std::unordered_map<uint64_t, aergo::module::message::SharedDataBlob> topology_snapshot_;   // single entry (key 0), the state is fixed by the cache clear
+        };
+
+        /// @brief Module registration state (running modules, their mappings, channel names and dependencies), saved before
+        /// a module batch so that the batch can be undone after its commit if an added module fails to start.
+        struct RegistrationBackup
+        {
+            struct ModuleMappings
+            {
+                std::vector<std::vector<aergo::module::ChannelIdentifier>> subscribe_;
+                std::vector<std::vector<aergo::module::ChannelIdentifier>> request_;
+                std::vector<std::vector<aergo::module::ChannelIdentifier>> publish_;
+                std::vector<std::vector<aergo::module::ChannelIdentifier>> response_;
+            };
+
+            std::vector<std::shared_ptr<structures::ModuleData>> running_modules_;
+            std::vector<ModuleMappings> mappings_;  // by module ID
+            DependencyGraph dependency_graph_;
+            std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_publish_channels_;
+            std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_response_channels_;
+            std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_subscribe_auto_all_channels_;
+            std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_request_auto_all_channels_;
+            std::map<uint64_t, std::shared_ptr<memory_allocation::MemoryAccount>> module_memory_accounts_;  // of running modules
+        };
+
         void log(aergo::module::logging::LogType log_type, const char* message);
         void loadModules(const char* modules_dir, const char* data_dir);
         void autoCreateModules();
+        void logStartupReport();
         uint64_t getNextModuleId();
+
+        /// @brief Account of module "module_id", created on first use. Call with allocators_mutex_ locked.
+        std::shared_ptr<memory_allocation::MemoryAccount> getModuleMemoryAccount(uint64_t module_id);
+
+        /// @brief Store allocator created by module "module_id" with its account (child of "module_account"). Call with allocators_mutex_ locked.
+        aergo::module::IAllocator* registerAllocator(uint64_t module_id, std::shared_ptr<memory_allocation::MemoryAccount> module_account,
+            std::unique_ptr<memory_allocation::MemoryAccount> account, std::unique_ptr<memory_allocation::ICoreAllocator> allocator);
+
+        /// @brief Forget the accounts of removed "module_ids", so a reused ID starts with no quota and empty stats.
+        /// Allocators the modules did not delete keep charging the old accounts.
+        void releaseModuleMemoryAccounts(const std::vector<uint64_t>& module_ids);
+
+        /// @brief Respond to request "request_id" of "source_channel" to "target_channel" that could not be dispatched with success_ = false,
+        /// delivered to the requester directly (a request is never left unanswered).
+        void answerUndeliveredRequest(const structures::RoutingTable::ModuleRoutes& requester_routes, aergo::module::ChannelIdentifier source_channel,
+            aergo::module::ChannelIdentifier target_channel, uint64_t request_id);
+
+        /// @brief Note the channel sampled blobs of "message" are sent on (no-op while nothing is sampled).
+        void trackSentBlobs(aergo::module::ChannelIdentifier channel, aergo::module::message::MessageHeader& message);
+
+        /// @brief Bump module_mapping_state_id_, publish a new routing table built from running_modules_ and point publish handles at it.
+        /// Waits until no sender reads the previous table (EpochReaders::synchronize). Call with core_mutex_ locked after every change of the module mapping.
+        void commitMappingChange();
+
+        /// @brief Send "events" of the change committed as "routing_table" to its topology subscribers. Changes without events are not sent.
+        void publishTopologyChange(const structures::RoutingTable* routing_table, const std::vector<aergo::module::TopologyEvent>& events);
+
+        /// @brief Value cached for "key" in "cache", otherwise the result of "build" (called with core_mutex_ locked), cached unless it is incomplete.
+        template<typename Key, typename Value, typename Build>
+        Value cachedQuery(std::unordered_map<Key, Value> QueryCache::* cache, const Key& key, Build build);
+
+        // control query results, call with core_mutex_ locked
+        aergo::module::RunningModuleInfo buildRunningModuleInfo(uint64_t running_module_id);
+        aergo::module::message::SharedDataBlob buildDependenciesBlob(uint64_t id);
+        aergo::module::message::SharedDataBlob buildChannelsBlob(const std::vector<aergo::module::ChannelIdentifier>& channels);
+        aergo::module::message::SharedDataBlob buildTopologySnapshot();
         void registerModuleChannelNames(uint64_t module_id, const aergo::module::ModuleInfo* module_info);  // register to existing_publish_channels_, existing_response_channels_, existing_subscribe_auto_all_channels_ and existing_request_auto_all_channels_
 
         /// @brief register to publishing / response module mappings and module's own mappings.
@@ -105,23 +202,73 @@ namespace aergo::core
         const std::vector<aergo::module::ChannelIdentifier>& getExistingPublishChannelsImpl(const char* channel_type_identifier);
         const std::vector<aergo::module::ChannelIdentifier>& getExistingResponseChannelsImpl(const char* channel_type_identifier);
         
-        /// @brief Attempt to create and start module identified by loaded_module_id.
+        /// @brief Attempt to create module identified by loaded_module_id, publish it (commitMappingChange) and start its threads,
+        /// so anything it sends from its first cycle is routed. If the threads fail to start, the module is taken out again with a second commit.
         /// @return true on success, false on failure
         bool createAndStartModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info, uint32_t module_thread_timeout_ms); 
 
+        /// @brief Create module identified by loaded_module_id and register its channels and connections, without starting its threads.
+        /// @return true on success (module is the last of running_modules_), false on failure
+        bool createAndRegisterModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info);
+
+        /// @brief Create module identified by loaded_module_id with ID "module_id", nullptr on failure.
+        /// Reads loaded_modules_ only, so it can run in parallel for different modules.
+        std::unique_ptr<structures::ModuleData> instantiateModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info, uint64_t module_id);
+
+        /// @brief Add created module as the next running module and register its channels and connections.
+        void registerModule(std::unique_ptr<structures::ModuleData> module_data, aergo::module::InputChannelMapInfo channel_map_info);
+
+        /// @brief Unregister and destroy modules from "first_module_id" up, created since the last commitMappingChange. Their threads must not run.
+        void discardCreatedModules(uint64_t first_module_id);
+
+        /// @brief Start threads of all "module_ids" in parallel. If any fails, all are stopped again.
+        bool startModuleThreads(const std::vector<uint64_t>& module_ids, uint32_t module_thread_timeout_ms);
+
+        /// @brief Stop threads of all "modules" in parallel, true if all stopped in time.
+        bool stopModuleThreads(const std::vector<std::shared_ptr<structures::ModuleData>>& modules);
+
         std::vector<uint64_t> collectDependentModulesImpl(uint64_t id);
-        void collectDependentModulesHelper(structures::ModuleData* module, std::vector<uint64_t>& dependent_modules, ConsumerType consumer_type);
-        void removeMappingProducers(uint64_t module_id, ConsumerType consumer_type);
-        void removeMappingSubscribers(uint64_t module_id, ConsumerType consumer_type);
+
+        /// @brief Detach "module_ids" (a module with all its dependents), commit the change and stop their threads once senders no longer
+        /// route to them. Modules are released with the last routing table referencing them. True if all threads stopped in time.
+        bool removeModulesImpl(const std::vector<uint64_t>& module_ids);
+
+        /// @brief Remove mappings, channel names and dependencies of "module_ids" and take them out of running_modules_ (IDs stay used).
+        /// They keep running and receiving until the next commitMappingChange.
+        std::vector<std::shared_ptr<structures::ModuleData>> detachModules(const std::vector<uint64_t>& module_ids);
+
+        RegistrationBackup saveRegistration();
+
+        /// @brief Return to "backup". Modules created since the backup are detached, their IDs stay used.
+        void restoreRegistration(RegistrationBackup&& backup);
+
+        /// @brief Remove "module_id" from the dependency graph and the existing channel maps (mappings are removed by removeMappings).
+        void unregisterModule(uint64_t module_id);
+
+        /// @brief Remove all mappings between "module_ids" and the other modules (and between each other), one pass over each affected channel.
+        void removeMappings(const std::vector<uint64_t>& module_ids);
 
         /// @param channel_type_identifier_function return channel name and if it needs to be removed from "existing_channels"
         void removeFromExistingMap(uint64_t module_id, uint32_t channel_count, std::function<std::pair<const char*, bool>(uint32_t)> channel_type_identifier_function, std::map<std::string, std::vector<aergo::module::ChannelIdentifier>>& existing_channels);
 
         bool initialized_;
+        memory_allocation::AllocationTracker allocation_tracker_;  // used by all allocators, declared before modules and allocators so it outlives them
+        executor::WorkStealingExecutor prioritized_executor_;  // declared before modules, so it outlives them
+        executor::WorkStealingExecutor regular_executor_;
         std::vector<structures::ModuleLoaderData> loaded_modules_;
-        std::vector<std::unique_ptr<structures::ModuleData>> running_modules_;
-        std::vector<std::unique_ptr<aergo::module::IAllocator>> allocators_;
+        std::vector<std::shared_ptr<structures::ModuleData>> running_modules_;
+        DependencyGraph dependency_graph_;  // non AUTO_ALL consumer -> producer edges of running_modules_, guarded by core_mutex_
+        EpochReaders routing_readers_;  // sections of senders reading current_routing_table_ and publish handles
+        std::shared_ptr<const structures::RoutingTable> routing_table_;   // owns the current routing table, guarded by core_mutex_
+        std::atomic<const structures::RoutingTable*> current_routing_table_;  // read by senders in routing_readers_ sections, written under core_mutex_
+        MessageDispatcher dispatcher_;  // delivers messages, requests and responses, so senders never run target module code inline
+        uint64_t next_allocator_id_ = 0;
+        std::map<uint64_t, std::shared_ptr<memory_allocation::MemoryAccount>> module_memory_accounts_;   // erased on module removal, allocators hold the accounts they charge
+        std::vector<structures::AllocatorData> allocators_;
         uint64_t module_mapping_state_id_;
+        structures::StartupReport startup_report_;
+        TopologyTracker topology_tracker_;
+        uint64_t topology_published_state_id_ = 0;  // state ID of the last change with topology events, guarded by core_mutex_
 
         std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_publish_channels_;
         std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_response_channels_;
@@ -129,9 +276,13 @@ namespace aergo::core
         std::map<std::string, std::vector<aergo::module::ChannelIdentifier>> existing_request_auto_all_channels_;
 
         std::mutex core_mutex_;
+        std::mutex allocators_mutex_;   // guards allocators_ and module_memory_accounts_ only, so modules creating allocators do not contend with module management
 
         logging::ILogger* logger_;
 
         AllocatorPtr core_dynamic_allocator_;
+
+        std::mutex query_cache_mutex_;  // taken after core_mutex_ (or alone for cache hits)
+        QueryCache query_cache_;        // holds blobs of core_dynamic_allocator_, declared after it so it is released first
     };
 }
\ No newline at end of file
@@ -2,9 +2,13 @@
 
 #include "utils/module_interface/module_loader.h"
 #include "utils/logging/logger.h"
+#include "utils/memory_allocation/memory_account.h"
 
 #include <filesystem>
+#include <string>
 #include <vector>
+#include <memory>
+#include <atomic>
 
 
 
@@ -46,10 +50,56 @@ namespace aergo::core::structures
         uint64_t module_id_;
     };
 
+    struct ModuleData;
+
+    /// @brief Immutable snapshot of the module mapping, published by the core every time the mapping changes (RCU-style).
+    /// Senders read the current snapshot in a read section (EpochReaders) instead of taking the core mutex, the core releases
+    /// a replaced snapshot only after the sections that could have read it ended. Tasks queued in the dispatcher hold their
+    /// snapshot, so a module removed in the meantime is destroyed only after the last task referencing it is delivered.
+    struct RoutingTable : public std::enable_shared_from_this<RoutingTable>
+    {
+        struct Route
+        {
+            aergo::module::dll::IDllModule* module_;    // target module, kept alive by ModuleRoutes::module_data_ of the target
+            uint32_t channel_id_;                       // target subscribe channel
+        };
+
+        /// @brief Pre-resolved subscribers of a publish channel, what a PublishHandle points to.
+        struct PublishRoutes
+        {
+            const RoutingTable* table_ = nullptr;       // snapshot owning the routes
+            std::vector<Route> routes_;
+        };
+
+        struct ModuleRoutes
+        {
+            std::shared_ptr<ModuleData> module_data_;   // nullptr if module was destroyed
+            std::vector<PublishRoutes> publish_;        // for each publish channel
+            uint32_t response_channel_count_ = 0;
+            uint32_t request_channel_count_ = 0;
+        };
+
+        uint64_t state_id_ = 0;               // module_mapping_state_id_ the snapshot was built for
+        std::vector<ModuleRoutes> modules_;   // indexed by module ID
+        std::vector<Route> topology_;         // AUTO_ALL subscribers of TOPOLOGY_CHANNEL_TYPE_IDENTIFIER
+
+        /// @return routes of an existing module or nullptr if module_id is out of range or the module was destroyed
+        const ModuleRoutes* module(uint64_t module_id) const;
+    };
+
+    /// @brief Publish channel of a running module (aergo::module::ICoreBase::getPublishHandle), pointed at the channel's routes
+    /// in the current routing table by every mapping commit. Read in a read section like the routing table.
+    struct PublishHandle : public aergo::module::IPublishHandle
+    {
+        aergo::module::ChannelIdentifier channel_;
+        std::atomic<const RoutingTable::PublishRoutes*> routes_{nullptr};   // nullptr until the module is committed and after it is removed
+    };
+
     struct ModuleData
     {
         ModuleData(ModuleLogger&& logger, ModuleLoaderData* module_loader_data);
 
+        std::vector<PublishHandle> publish_handles_;   // by publish channel, declared first so handles outlive the module using them
         aergo::core::ModuleLoader::ModulePtr module_;
         ModuleLogger logger_;
         ModuleLoaderData* module_loader_data_;
@@ -59,5 +109,35 @@ namespace aergo::core::structures
         std::vector<std::vector<aergo::module::ChannelIdentifier>> mapping_publish_;    // for sending messages + cascade destruction
         std::vector<std::vector<aergo::module::ChannelIdentifier>> mapping_response_;   // for cascade destruction
     };
+
+    /// @brief Time spent on one loaded module in Core::initialize.
+    struct ModuleStartupTiming
+    {
+        std::string module_name_;
+        uint64_t load_ns_ = 0;          // loading the library (relocation, static constructors) and reading its API version
+        uint64_t module_info_ns_ = 0;   // readModuleInfo
+        uint64_t create_ns_ = 0;        // createModule (module constructor), auto-created modules only
+        uint64_t start_ns_ = 0;         // threadStart, auto-created modules only
+    };
+
+    /// @brief Timing of Core::initialize. Module phases run in parallel, so per-module times overlap and do not add up to phase times.
+    struct StartupReport
+    {
+        std::vector<ModuleStartupTiming> modules_;  // by loaded module ID
+        uint64_t discovery_ns_ = 0;     // listing the modules directory
+        uint64_t load_ns_ = 0;          // loading all libraries
+        uint64_t create_ns_ = 0;        // creating and registering auto-created modules
+        uint64_t start_ns_ = 0;         // starting threads of auto-created modules
+        uint64_t total_ns_ = 0;
+    };
+
+    /// @brief Allocator created through ICoreBase, attributed to the creating module.
+    struct AllocatorData
+    {
+        uint64_t module_id_;
+        std::shared_ptr<aergo::core::memory_allocation::MemoryAccount> module_account_;   // parent of account_, kept alive after the module is removed
+        std::unique_ptr<aergo::core::memory_allocation::MemoryAccount> account_;   // child of the module's account, declared first so it outlives the allocator
+        std::unique_ptr<aergo::module::IAllocator> allocator_;
+    };
     
 }
\ No newline at end of file
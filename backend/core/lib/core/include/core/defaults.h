@@ -7,4 +7,9 @@
 namespace aergo::core::defaults
 {
     uint32_t module_thread_timeout_ms_ = 100;   
+    uint32_t dispatcher_thread_count_ = 2;
+    uint32_t dispatcher_queue_capacity_ = 4096;
+    uint32_t executor_prioritized_thread_count_ = 2;
+    uint32_t executor_regular_thread_count_ = 0;    // 0 = number of hardware threads
+    uint32_t module_load_thread_count_ = 0;         // loading and auto-creating modules in Core::initialize, 0 = number of hardware threads
 }
\ No newline at end of file
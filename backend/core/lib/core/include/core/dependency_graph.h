@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace aergo::core
+{
+    /// @brief Index of module dependencies with reverse edges. Module B depends on module A if a channel of B that is not AUTO_ALL
+    /// consumes a publish or response channel of A (B has to be removed with A). Updated incrementally as modules are connected
+    /// and removed, so collecting dependents visits only the affected edges. A module can only map existing producers,
+    /// so dependencies always point from older to newer modules and ascending IDs are a valid creation order.
+    /// Not thread safe, used under the core mutex.
+    class DependencyGraph
+    {
+    public:
+        /// @brief Module "consumer_module_id" depends on module "producer_module_id". Repeated edges are stored once.
+        void addDependency(uint64_t producer_module_id, uint64_t consumer_module_id);
+
+        /// @brief Drop all edges of "module_id" (in both directions).
+        void removeModule(uint64_t module_id);
+
+        /// @brief "module_id" and all modules depending on it directly or transitively, in ascending ID order (dependencies first).
+        std::vector<uint64_t> collectDependents(uint64_t module_id);
+
+        /// @brief Number of modules directly depending on "module_id".
+        size_t dependentCount(uint64_t module_id) const;
+
+    private:
+        struct Node
+        {
+            std::unordered_set<uint64_t> dependents_;       // consumers that depend on this module
+            std::unordered_set<uint64_t> dependencies_;     // producers this module depends on (reverse edges)
+            uint64_t visit_epoch_ = 0;
+        };
+
+        Node& node(uint64_t module_id);
+
+        std::vector<Node> nodes_;       // by module ID
+        uint64_t visit_epoch_ = 0;      // incremented per collectDependents, nodes visited in the current walk carry it
+    };
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+namespace aergo::core
+{
+    /// @brief Read sections over data published by a single writer (RCU-style). A reader enters a Section, loads the published pointer
+    /// and uses the pointed data until the Section ends. The writer replaces the pointer, calls synchronize() and may then free
+    /// the old data, no reader can still use it. Entering and leaving a section is one atomic increment and decrement of a counter
+    /// on the reader thread's own cache line, so readers never lock and never share a reference count.
+    class EpochReaders
+    {
+        static constexpr uint32_t SLOT_COUNT = 64;  // threads beyond SLOT_COUNT share slots, which stays correct
+
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> active_[2] = { 0, 0 };  // sections entered in each epoch parity
+        };
+
+    public:
+        class Section
+        {
+        public:
+            explicit Section(EpochReaders& readers) noexcept;
+            ~Section();
+
+            Section(const Section& other) = delete;
+            Section& operator=(const Section& other) = delete;
+
+        private:
+            Slot& slot_;
+            uint32_t parity_;
+        };
+
+        EpochReaders() = default;
+
+        EpochReaders(const EpochReaders& other) = delete;
+        EpochReaders& operator=(const EpochReaders& other) = delete;
+
+        /// @brief Wait until every section entered before this call has ended. Sections entered meanwhile are not waited for,
+        /// they see anything published before the call. Load published pointers in a section with memory_order_seq_cst
+        /// and store them before the call with memory_order_seq_cst. Must not be called from a section.
+        void synchronize() noexcept;
+
+    private:
+        /// @brief Flip the epoch and wait until no section of the previous epoch parity remains.
+        void waitForParity() noexcept;
+
+        std::array<Slot, SLOT_COUNT> slots_;
+        std::atomic<uint32_t> epoch_{0};
+    };
+}
\ No newline at end of file
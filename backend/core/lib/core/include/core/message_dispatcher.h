@@ -0,0 +1,103 @@
+#pragma once
+
+#include "utils/logging/logger.h"
+#include "core_structures.h"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+namespace aergo::core
+{
+    /// @brief Delivers messages, requests and responses to target modules on dedicated dispatcher threads, so the sending
+    /// module only copies the message and enqueues it. Tasks are sharded by source module ID (one shard per dispatcher thread),
+    /// so everything sent by a single module is delivered in the order it was sent.
+    class MessageDispatcher
+    {
+    public:
+        /// @param thread_count number of dispatcher threads (and shards), min 1
+        /// @param queue_capacity maximum number of waiting tasks per shard (beyond that, new messages are dropped and requests / responses wait), min 1
+        MessageDispatcher(uint32_t thread_count, uint32_t queue_capacity, logging::ILogger* logger);
+        ~MessageDispatcher();
+
+        MessageDispatcher(const MessageDispatcher& other) = delete;
+        MessageDispatcher& operator=(const MessageDispatcher& other) = delete;
+
+        /// @brief Enqueue message for all subscribers in "routes". Message data and blobs are copied once into an envelope shared by all subscribers.
+        /// @param routing_table snapshot owning "routes" (owned by a shared_ptr), kept alive by the shard until the message is delivered.
+        /// The caller keeps it alive for the call (read section or own reference).
+        /// @return true if enqueued, false if dropped (shard queue full, dispatcher stopped or envelope allocation failed)
+        bool dispatchMessage(const structures::RoutingTable* routing_table, const std::vector<structures::RoutingTable::Route>* routes,
+            aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept;
+
+        /// @brief Enqueue request or response for a single target. Message data and blobs are copied into an envelope.
+        /// Requests and responses are not dropped when the shard queue is full, the sender waits for space instead. Calls from
+        /// dispatcher threads (made by a target module while a task is delivered) do not wait, they would wait for themselves,
+        /// and are enqueued beyond the capacity.
+        /// @param routing_table snapshot owning the target module, kept alive like in dispatchMessage
+        /// @return true if enqueued, false if dropped (dispatcher stopped or envelope allocation failed)
+        bool dispatchSingle(aergo::module::IModule::ProcessingType type, const structures::RoutingTable* routing_table, structures::RoutingTable::Route target,
+            aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept;
+
+        /// @brief Stop and join the dispatcher threads. Tasks that were not delivered yet are discarded. Subsequent dispatch calls fail.
+        void stop() noexcept;
+
+        /// @brief Number of messages dropped because a shard queue was full.
+        uint64_t droppedCount() const noexcept;
+
+        /// @brief Release routing tables the shards keep for reuse while no queued task references them. Called by the core after
+        /// replacing the routing table, so modules removed with it are not kept alive by an idle shard.
+        void releaseIdleTables() noexcept;
+
+    private:
+        struct Task
+        {
+            aergo::module::IModule::ProcessingType type_;
+            const std::vector<structures::RoutingTable::Route>* routes_;    // MESSAGE only
+            structures::RoutingTable::Route target_;                        // REQUEST / RESPONSE only
+            aergo::module::ChannelIdentifier source_channel_;
+
+            aergo::module::message::EnvelopeRef envelope_;
+        };
+
+        /// @brief Routing table referenced by consecutive tasks of a shard. The reference is taken once per table change instead of per task.
+        struct TableReference
+        {
+            std::shared_ptr<const structures::RoutingTable> routing_table_;
+            uint64_t task_count_ = 0;   // queued or delivered tasks referencing the table
+        };
+
+        struct Shard
+        {
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            std::condition_variable space_cv_;  // notified when a task is taken, for requests and responses waiting on a full queue
+            std::deque<Task> tasks_;
+            std::deque<TableReference> tables_;    // in task order, the front is referenced by the oldest task, the back is kept while idle
+            std::thread thread_;
+        };
+
+        /// @brief Fill task envelope from "message" and push the task to the shard of its source module, referencing "routing_table".
+        bool enqueue(Task&& task, const structures::RoutingTable* routing_table, const aergo::module::message::MessageHeader& message) noexcept;
+
+        /// @brief Drop the reference of a delivered task, call with the shard mutex locked.
+        /// @return table no longer referenced by any task, to be released without the shard mutex
+        std::shared_ptr<const structures::RoutingTable> releaseDeliveredTask(Shard& shard);
+        void dispatcherThreadFunc(Shard* shard);
+        void deliver(Task& task);
+
+        void log(aergo::module::logging::LogType log_type, const char* message);
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+        uint32_t queue_capacity_;
+
+        std::atomic<bool> stop_threads_{false};
+        std::atomic<uint64_t> dropped_count_{0};
+
+        logging::ILogger* logger_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core_structures.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aergo::core
+{
+    /// @brief Keeps the module mapping as of the last commit and turns the next one into TopologyEvents.
+    /// Every connection is stored once, on its consumer side, so a removed producer shows up as removed connections of its consumers.
+    /// Not thread safe, used under the core mutex.
+    class TopologyTracker
+    {
+    public:
+        /// @brief Diff "running_modules" against the state of the previous call and remember it.
+        /// @param loaded_modules start of the loaded modules array, to derive loaded module IDs
+        /// @return events ordered as described in TopologyChange
+        std::vector<aergo::module::TopologyEvent> update(const std::vector<std::shared_ptr<structures::ModuleData>>& running_modules, const structures::ModuleLoaderData* loaded_modules);
+
+        /// @brief State of the last update as events from an empty mapping: MODULE_ADDED for every module, then CONNECTION_ADDED for every connection.
+        std::vector<aergo::module::TopologyEvent> snapshot() const;
+
+    private:
+        struct Connection
+        {
+            bool request_;
+            uint32_t consumer_channel_id_;
+            aergo::module::ChannelIdentifier producer_;
+
+            bool operator==(const Connection& other) const = default;
+            bool operator<(const Connection& other) const;
+        };
+
+        struct ModuleState
+        {
+            bool exists_ = false;
+            uint64_t loaded_module_id_ = 0;
+            std::vector<Connection> inputs_;   // sorted
+        };
+
+        static std::vector<Connection> collectInputs(const structures::ModuleData* module_data);
+        static aergo::module::TopologyEvent connectionEvent(aergo::module::TopologyEvent::Type type, uint64_t module_id, const Connection& connection);
+        static aergo::module::TopologyEvent moduleEvent(aergo::module::TopologyEvent::Type type, uint64_t module_id, uint64_t loaded_module_id);
+
+        std::vector<ModuleState> modules_;     // by module ID
+    };
+}
\ No newline at end of file
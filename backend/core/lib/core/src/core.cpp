@@ -2,20 +2,124 @@
 #include "core/defaults.h"
 #include "utils/memory_allocation/dynamic_allocator.h"
 #include "utils/memory_allocation/static_allocator.h"
+#include "utils/memory_allocation/elastic_allocator.h"
+#include "utils/memory_allocation/mapped_file_allocator.h"
 #include "utils/memory_allocation/allocator_wrapper.h"
 
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 
 using namespace aergo::core;
 
 
 
+namespace
+{
+    /// @brief Run "function" for indices 0 to count - 1 on up to "thread_count" threads (the calling thread is one of them).
+    /// Default runs every index on its own thread.
+    /// @return true if all calls returned true
+    bool runParallel(size_t count, const std::function<bool(size_t)>& function, size_t thread_count = SIZE_MAX)
+    {
+        std::vector<char> results(count, false);
+        std::atomic<size_t> next_index = 0;
+        auto worker = [&results, &function, &next_index, count]() {
+            for (size_t i = next_index++; i < count; i = next_index++)
+            {
+                results[i] = function(i);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        thread_count = std::min(thread_count, count);
+        threads.reserve(thread_count);
+        for (size_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        return std::all_of(results.begin(), results.end(), [](char result) { return result; });
+    }
+
+
+
+    size_t moduleLoadThreadCount()
+    {
+        return (defaults::module_load_thread_count_ > 0) ? defaults::module_load_thread_count_ : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+
+
+    uint64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+
+
+    /// @brief Does "channel_map_info" map any channel of "module_ids".
+    bool mapsAnyModule(aergo::module::InputChannelMapInfo channel_map_info, const std::set<uint64_t>& module_ids)
+    {
+        auto maps_any = [&module_ids](aergo::module::InputChannelMapInfo::IndividualChannelInfo* consumer_info, uint32_t consumer_info_count) {
+            for (uint32_t channel_id = 0; channel_id < consumer_info_count; ++channel_id)
+            {
+                for (uint32_t channel_i = 0; channel_i < consumer_info[channel_id].channel_identifier_count_; ++channel_i)
+                {
+                    if (module_ids.contains(consumer_info[channel_id].channel_identifier_[channel_i].producer_module_id_))
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        return maps_any(channel_map_info.subscribe_consumer_info_, channel_map_info.subscribe_consumer_info_count_)
+            || maps_any(channel_map_info.request_consumer_info_, channel_map_info.request_consumer_info_count_);
+    }
+
+
+
+    /// @brief Query results that failed to allocate are not cached, so the next call retries.
+    bool isComplete(aergo::module::message::SharedDataBlob& blob)
+    {
+        return blob.valid();
+    }
+
+
+
+    bool isComplete(aergo::module::RunningModuleInfo& info)
+    {
+        return !info.exists_ || info.channel_map_.valid();
+    }
+}
+
+
+
 Core::Core(logging::ILogger* logger)
-: logger_(logger), initialized_(false), module_mapping_state_id_(0)
+: initialized_(false),
+  prioritized_executor_(defaults::executor_prioritized_thread_count_),
+  regular_executor_((defaults::executor_regular_thread_count_ > 0) ? defaults::executor_regular_thread_count_ : std::max(2u, std::thread::hardware_concurrency())),
+  routing_table_(std::make_shared<const structures::RoutingTable>()), current_routing_table_(routing_table_.get()),
+  dispatcher_(defaults::dispatcher_thread_count_, defaults::dispatcher_queue_capacity_, logger),
+  module_mapping_state_id_(0), logger_(logger)
 {
     core_dynamic_allocator_ = std::move(std::unique_ptr<aergo::module::IAllocator, std::function<void(aergo::module::IAllocator*)>>(
-        createDynamicAllocator(),
+        createDynamicAllocator(CORE_MEMORY_ACCOUNT_ID, {}),
         [this](aergo::module::IAllocator* allocator_ref) { deleteAllocator(allocator_ref); }
     ));
 }
@@ -24,13 +128,12 @@ Core::Core(logging::ILogger* logger)
 
 Core::~Core()
 {
-    for (auto& module : running_modules_)
-    {
-        if (module.get() != nullptr)
-        {
-            module->module_->threadStop(defaults::module_thread_timeout_ms_);
-        }
-    }
+    // no deliveries may run into modules whose threads are stopping
+    dispatcher_.stop();
+
+    std::vector<std::shared_ptr<structures::ModuleData>> modules;
+    std::copy_if(running_modules_.begin(), running_modules_.end(), std::back_inserter(modules), [](const auto& module_data) { return module_data.get() != nullptr; });
+    stopModuleThreads(modules);
 }
 
 
@@ -45,8 +148,13 @@ void Core::initialize(const char* modules_dir, const char* data_dir)
     }
     initialized_ = true;
 
+    uint64_t start_ns = nowNs();
+
     loadModules(modules_dir, data_dir);
     autoCreateModules();
+
+    startup_report_.total_ns_ = nowNs() - start_ns;
+    logStartupReport();
 }
 
 
@@ -61,8 +169,48 @@ void Core::loadModules(const char* modules_dir, const char* data_dir)
         return;
     }
 
-    for (const auto& entry : std::filesystem::directory_iterator(modules_dir_entry))
+    uint64_t start_ns = nowNs();
+
+    // sorted, so loaded module IDs do not depend on the directory iteration order
+    std::vector<std::filesystem::directory_entry> entries { std::filesystem::directory_iterator(modules_dir_entry), std::filesystem::directory_iterator() };
+    std::sort(entries.begin(), entries.end());
+
+    startup_report_.discovery_ns_ = nowNs() - start_ns;
+    start_ns = nowNs();
+
+    struct LoadResult
+    {
+        std::expected<std::unique_ptr<ModuleLoader>, ModuleLoadError> loaded_module_ = std::unexpected(ModuleLoadError::FAILED_TO_LOAD);
+        uint64_t module_api_version_ = 0;
+        uint64_t load_ns_ = 0;
+        uint64_t module_info_ns_ = 0;
+    };
+    std::vector<LoadResult> load_results(entries.size());
+
+    // libraries are loaded (relocated, their static constructors run) in parallel, results are processed in order
+    runParallel(entries.size(), [&entries, &load_results](size_t i) {
+        LoadResult& result = load_results[i];
+        uint64_t load_start_ns = nowNs();
+
+        result.loaded_module_ = ModuleLoader::loadModule(entries[i].path().string().c_str());
+        if (result.loaded_module_)
+        {
+            result.module_api_version_ = (*result.loaded_module_)->readPluginApiVersion();
+            uint64_t loaded_ns = nowNs();
+            result.load_ns_ = loaded_ns - load_start_ns;
+
+            if (result.module_api_version_ == CORE_API_VERSION)
+            {
+                (*result.loaded_module_)->readModuleInfo();
+                result.module_info_ns_ = nowNs() - loaded_ns;
+            }
+        }
+        return true;
+    }, moduleLoadThreadCount());
+
+    for (size_t i = 0; i < entries.size(); ++i)
     {
+        const auto& entry = entries[i];
         auto module_path = entry.path();
         std::string module_path_str = module_path.string();
 
@@ -77,20 +225,27 @@ void Core::loadModules(const char* modules_dir, const char* data_dir)
         
         std::filesystem::path data_path = std::filesystem::path(data_dir) / module_filename;
 
-        auto loaded_module = ModuleLoader::loadModule(module_path_str.c_str());
+        auto& loaded_module = load_results[i].loaded_module_;
         if (loaded_module)
         {
-            uint64_t module_api_version = (*loaded_module)->readPluginApiVersion();
+            uint64_t module_api_version = load_results[i].module_api_version_;
             if (module_api_version != CORE_API_VERSION)
             {
                 std::stringstream log_message;
                 log_message << "Failed to load module, mismatched interface API version (core=" << CORE_API_VERSION << " / module=" << module_api_version << "): " << module_filename;
+                log(aergo::module::logging::LogType::WARNING, log_message.str().c_str());
             }
             else
             {
                 std::string log_message = std::string("Module loaded successfully: ") + module_filename;
                 log(aergo::module::logging::LogType::INFO, log_message.c_str());
 
+                startup_report_.modules_.push_back({
+                    .module_name_ = module_filename,
+                    .load_ns_ = load_results[i].load_ns_,
+                    .module_info_ns_ = load_results[i].module_info_ns_
+                });
+
                 loaded_modules_.emplace_back(
                     std::move(*loaded_module),
                     std::move(data_path.string()),
@@ -114,6 +269,8 @@ void Core::loadModules(const char* modules_dir, const char* data_dir)
             log(aergo::module::logging::LogType::WARNING, log_message.c_str());
         }
     }
+
+    startup_report_.load_ns_ = nowNs() - start_ns;
 }
 
 
@@ -128,7 +285,9 @@ void Core::autoCreateModules()
         .request_consumer_info_count_ = 0
     };
 
+    uint64_t start_ns = nowNs();
 
+    std::vector<uint64_t> loaded_module_ids;
     for (size_t i = 0; i < loaded_modules_.size(); ++i)
     {
         const aergo::module::ModuleInfo* module_info = loaded_modules_[i]->readModuleInfo();
@@ -154,16 +313,7 @@ void Core::autoCreateModules()
 
             if (valid_mapping)
             {
-                if (createAndStartModule(i, empty_channel_info, defaults::module_thread_timeout_ms_))
-                {
-                    std::string success_message = std::string("Successfully auto-created module: ") + loaded_modules_[i].getModuleUniqueName();
-                    log(aergo::module::logging::LogType::INFO, success_message.c_str());
-                }
-                else
-                {
-                    std::string failure_message = std::string("Failed to auto-create module: ") + loaded_modules_[i].getModuleUniqueName();
-                    log(aergo::module::logging::LogType::WARNING, failure_message.c_str());
-                }
+                loaded_module_ids.push_back(i);
             }
             else
             {
@@ -172,17 +322,147 @@ void Core::autoCreateModules()
             }
         }
     }
+
+    // module IDs follow loaded module order, constructors run in parallel
+    uint64_t first_module_id = getNextModuleId();
+    std::vector<std::unique_ptr<structures::ModuleData>> created_modules(loaded_module_ids.size());
+    runParallel(loaded_module_ids.size(), [&](size_t i) {
+        uint64_t create_start_ns = nowNs();
+        created_modules[i] = instantiateModule(loaded_module_ids[i], empty_channel_info, first_module_id + i);
+        startup_report_.modules_[loaded_module_ids[i]].create_ns_ = nowNs() - create_start_ns;
+        return true;
+    }, moduleLoadThreadCount());
+
+    std::vector<uint64_t> module_ids;
+    for (size_t i = 0; i < created_modules.size(); ++i)
+    {
+        if (created_modules[i].get() != nullptr)
+        {
+            registerModule(std::move(created_modules[i]), empty_channel_info);
+            module_ids.push_back(first_module_id + i);
+        }
+        else
+        {
+            // module was created with the ID, so it stays unused
+            running_modules_.push_back(nullptr);
+
+            std::string failure_message = std::string("Failed to auto-create module: ") + loaded_modules_[loaded_module_ids[i]].getModuleUniqueName();
+            log(aergo::module::logging::LogType::WARNING, failure_message.c_str());
+        }
+    }
+
+    // published before the threads start, so anything the modules send from their first cycle is routed
+    commitMappingChange();
+
+    startup_report_.create_ns_ = nowNs() - start_ns;
+    start_ns = nowNs();
+
+    std::vector<char> started(module_ids.size(), false);
+    runParallel(module_ids.size(), [&](size_t i) {
+        uint64_t thread_start_ns = nowNs();
+        started[i] = running_modules_[module_ids[i]]->module_->threadStart(defaults::module_thread_timeout_ms_);
+        startup_report_.modules_[loaded_module_ids[module_ids[i] - first_module_id]].start_ns_ = nowNs() - thread_start_ns;
+        return (bool)started[i];
+    });
+
+    std::vector<uint64_t> failed_module_ids;
+    for (size_t i = 0; i < module_ids.size(); ++i)
+    {
+        const std::string& module_name = running_modules_[module_ids[i]]->module_loader_data_->getModuleUniqueName();
+        if (started[i])
+        {
+            std::string success_message = std::string("Successfully auto-created module: ") + module_name;
+            log(aergo::module::logging::LogType::INFO, success_message.c_str());
+        }
+        else
+        {
+            bool stop_success = running_modules_[module_ids[i]]->module_->threadStop(defaults::module_thread_timeout_ms_);
+            std::string failure_message = std::string("Failed to auto-create module (failed to start thread, stop success: ") + (stop_success ? "TRUE" : "false") + "): " + module_name;
+            log(aergo::module::logging::LogType::WARNING, failure_message.c_str());
+            failed_module_ids.push_back(module_ids[i]);
+        }
+    }
+
+    if (!failed_module_ids.empty())
+    {
+        detachModules(failed_module_ids);
+        commitMappingChange();
+    }
+
+    startup_report_.start_ns_ = nowNs() - start_ns;
+}
+
+
+
+void Core::logStartupReport()
+{
+    auto ms = [](uint64_t ns) { return ns / 1'000'000.0; };
+
+    std::stringstream report;
+    report << std::fixed << std::setprecision(3) << "Startup took " << ms(startup_report_.total_ns_) << " ms (discovery " << ms(startup_report_.discovery_ns_)
+        << " ms, load " << ms(startup_report_.load_ns_) << " ms, create " << ms(startup_report_.create_ns_) << " ms, start " << ms(startup_report_.start_ns_) << " ms)";
+    for (const auto& module_timing : startup_report_.modules_)
+    {
+        report << "\n    " << module_timing.module_name_ << ": load " << ms(module_timing.load_ns_) << " ms, module info " << ms(module_timing.module_info_ns_)
+            << " ms, create " << ms(module_timing.create_ns_) << " ms, start " << ms(module_timing.start_ns_) << " ms";
+    }
+
+    log(aergo::module::logging::LogType::INFO, report.str().c_str());
+}
+
+
+
+structures::StartupReport Core::getStartupReport()
+{
+    std::lock_guard<std::mutex> lock(core_mutex_);
+    return startup_report_;
 }
 
 
 
 bool Core::createAndStartModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info, uint32_t module_thread_timeout_ms)
+{
+    uint64_t module_id = getNextModuleId();
+    if (!createAndRegisterModule(loaded_module_id, channel_map_info))
+    {
+        return false;
+    }
+
+    commitMappingChange();
+
+    if (!startModuleThreads({ module_id }, module_thread_timeout_ms))
+    {
+        detachModules({ module_id });
+        commitMappingChange();
+        return false;
+    }
+
+    return true;
+}
+
+
+
+bool Core::createAndRegisterModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info)
 {
     if (loaded_module_id >= loaded_modules_.size())
     {
         return false;
     }
 
+    auto module_data = instantiateModule(loaded_module_id, channel_map_info, getNextModuleId());
+    if (module_data.get() == nullptr)
+    {
+        return false;
+    }
+
+    registerModule(std::move(module_data), channel_map_info);
+    return true;
+}
+
+
+
+std::unique_ptr<structures::ModuleData> Core::instantiateModule(uint64_t loaded_module_id, aergo::module::InputChannelMapInfo channel_map_info, uint64_t module_id)
+{
     const char* data_path;
     if (std::filesystem::exists(loaded_modules_[loaded_module_id].getModuleDataPath()))
     {
@@ -193,55 +473,257 @@ bool Core::createAndStartModule(uint64_t loaded_module_id, aergo::module::InputC
         data_path = nullptr;
     }
 
-    
-    uint64_t next_module_id = getNextModuleId();
     auto module_data = std::make_unique<structures::ModuleData>(
         structures::ModuleLogger(
             logger_, 
             loaded_modules_[loaded_module_id].getModuleUniqueName(), 
-            next_module_id
+            module_id
         ), 
         &(loaded_modules_[loaded_module_id])
     );
 
-    ModuleLoader::ModulePtr created_module(loaded_modules_[loaded_module_id]->createModule(data_path, this, channel_map_info, &(module_data->logger_), next_module_id));
+    // routed by commitMappingChange once the module is registered
+    module_data->publish_handles_ = std::vector<structures::PublishHandle>(module_data->mapping_publish_.size());
+    for (uint32_t channel_id = 0; channel_id < module_data->publish_handles_.size(); ++channel_id)
+    {
+        module_data->publish_handles_[channel_id].channel_ = { .producer_module_id_ = module_id, .producer_channel_id_ = channel_id };
+    }
+
+    module_data->module_ = loaded_modules_[loaded_module_id]->createModule(data_path, this, channel_map_info, &(module_data->logger_), module_id);
 
-    if (created_module.get() == nullptr)
+    if (module_data->module_.get() == nullptr)
     {
         std::string error_message = std::string("Failed to create module (createModule call failed) for module: ") + module_data->module_loader_data_->getModuleUniqueName();
         log(aergo::module::logging::LogType::WARNING, error_message.c_str());
-        return false;
+        return nullptr;
     }
-    else
+
+    return module_data;
+}
+
+
+
+void Core::registerModule(std::unique_ptr<structures::ModuleData> module_data, aergo::module::InputChannelMapInfo channel_map_info)
+{
+    uint64_t module_id = getNextModuleId();
+    const aergo::module::ModuleInfo* module_info = (*module_data->module_loader_data_)->readModuleInfo();
+    running_modules_.push_back(std::move(module_data));
+
+    registerModuleChannelNames(module_id, module_info);
+    registerModuleConnections(module_id, channel_map_info);
+}
+
+
+
+void Core::discardCreatedModules(uint64_t first_module_id)
+{
+    std::vector<uint64_t> module_ids;
+    for (uint64_t module_id = first_module_id; module_id < running_modules_.size(); ++module_id)
     {
-        bool result = created_module->threadStart(module_thread_timeout_ms);
-        if (!result)
-        {
-            bool result2 = created_module->threadStop(module_thread_timeout_ms);
+        module_ids.push_back(module_id);
+    }
+
+    removeMappings(module_ids);
+    for (uint64_t module_id : module_ids)
+    {
+        unregisterModule(module_id);
+    }
+    releaseModuleMemoryAccounts(module_ids);
+
+    // IDs were never published, so they are reused
+    running_modules_.resize(first_module_id);
+}
+
+
+
+bool Core::startModuleThreads(const std::vector<uint64_t>& module_ids, uint32_t module_thread_timeout_ms)
+{
+    std::vector<char> started(module_ids.size(), false);
+    bool success = runParallel(module_ids.size(), [&](size_t i) {
+        started[i] = running_modules_[module_ids[i]]->module_->threadStart(module_thread_timeout_ms);
+        return (bool)started[i];
+    });
 
-            std::string error_message = std::string("Failed to start thread for module: \"") + module_data->module_loader_data_->getModuleUniqueName() + std::string("\", stop success: ") + (result2 ? "TRUE" : "false");
+    if (success)
+    {
+        return true;
+    }
+
+    // all or nothing, threads that did start are stopped too
+    runParallel(module_ids.size(), [&](size_t i) {
+        bool stop_success = running_modules_[module_ids[i]]->module_->threadStop(module_thread_timeout_ms);
+        if (!started[i])
+        {
+            std::string error_message = std::string("Failed to start thread for module: \"") + running_modules_[module_ids[i]]->module_loader_data_->getModuleUniqueName() + std::string("\", stop success: ") + (stop_success ? "TRUE" : "false");
             log(aergo::module::logging::LogType::WARNING, error_message.c_str());
+        }
+        return stop_success;
+    });
 
-            return false;
+    return false;
+}
+
+
+
+bool Core::stopModuleThreads(const std::vector<std::shared_ptr<structures::ModuleData>>& modules)
+{
+    return runParallel(modules.size(), [&](size_t i) {
+        return modules[i]->module_->threadStop(defaults::module_thread_timeout_ms_);
+    });
+}
+
+
+
+uint64_t Core::getNextModuleId()
+{
+    return running_modules_.size();
+}
+
+
+
+void Core::commitMappingChange()
+{
+    ++module_mapping_state_id_;
+
+    auto routing_table = std::make_shared<structures::RoutingTable>();
+    routing_table->state_id_ = module_mapping_state_id_;
+    routing_table->modules_.resize(running_modules_.size());
+
+    for (size_t module_id = 0; module_id < running_modules_.size(); ++module_id)
+    {
+        if (running_modules_[module_id].get() == nullptr)
+        {
+            continue;
         }
-        else
+
+        structures::RoutingTable::ModuleRoutes& module_routes = routing_table->modules_[module_id];
+        module_routes.module_data_ = running_modules_[module_id];
+        module_routes.response_channel_count_ = (uint32_t)running_modules_[module_id]->mapping_response_.size();
+        module_routes.request_channel_count_ = (uint32_t)running_modules_[module_id]->mapping_request_.size();
+        module_routes.publish_.resize(running_modules_[module_id]->mapping_publish_.size());
+
+        for (size_t channel_id = 0; channel_id < running_modules_[module_id]->mapping_publish_.size(); ++channel_id)
+        {
+            module_routes.publish_[channel_id].table_ = routing_table.get();
+            auto& routes = module_routes.publish_[channel_id].routes_;
+            routes.reserve(running_modules_[module_id]->mapping_publish_[channel_id].size());
+
+            for (auto other_channel_id : running_modules_[module_id]->mapping_publish_[channel_id])
+            {
+                if (other_channel_id.producer_module_id_ >= running_modules_.size() || running_modules_[other_channel_id.producer_module_id_].get() == nullptr)
+                {
+                    log(aergo::module::logging::LogType::WARNING, "Other module identified by producer_module_id_ does not exist, in commitMappingChange");
+                    continue;
+                }
+
+                auto other_module_data = running_modules_[other_channel_id.producer_module_id_].get();
+
+                if (other_channel_id.producer_channel_id_ >= other_module_data->mapping_subscribe_.size())
+                {
+                    log(aergo::module::logging::LogType::WARNING, "Other channel identified by producer_channel_id_ does not exist, in commitMappingChange");
+                    continue;
+                }
+
+                routes.push_back({
+                    .module_ = other_module_data->module_.get(),
+                    .channel_id_ = other_channel_id.producer_channel_id_
+                });
+            }
+        }
+    }
+
+    auto subscribers = existing_subscribe_auto_all_channels_.find(aergo::module::TOPOLOGY_CHANNEL_TYPE_IDENTIFIER);
+    if (subscribers != existing_subscribe_auto_all_channels_.end())
+    {
+        for (auto subscriber_channel : subscribers->second)
         {
-            module_data->module_ = std::move(created_module);
-            running_modules_.push_back(std::move(module_data));
+            routing_table->topology_.push_back({
+                .module_ = running_modules_[subscriber_channel.producer_module_id_]->module_.get(),
+                .channel_id_ = subscriber_channel.producer_channel_id_
+            });
+        }
+    }
 
-            registerModuleChannelNames(next_module_id, loaded_modules_[loaded_module_id]->readModuleInfo());
-            registerModuleConnections(next_module_id, channel_map_info);
+    for (size_t module_id = 0; module_id < routing_table->modules_.size(); ++module_id)
+    {
+        const structures::RoutingTable::ModuleRoutes& module_routes = routing_table->modules_[module_id];
+        for (size_t channel_id = 0; module_routes.module_data_ != nullptr && channel_id < module_routes.publish_.size(); ++channel_id)
+        {
+            module_routes.module_data_->publish_handles_[channel_id].routes_.store(&module_routes.publish_[channel_id], std::memory_order_seq_cst);
+        }
+    }
 
-            return true;
+    // removed modules may still run until their threads stop, their handles route nowhere
+    for (size_t module_id = 0; module_id < routing_table_->modules_.size(); ++module_id)
+    {
+        const std::shared_ptr<structures::ModuleData>& module_data = routing_table_->modules_[module_id].module_data_;
+        if (module_data != nullptr && (module_id >= routing_table->modules_.size() || routing_table->modules_[module_id].module_data_ != module_data))
+        {
+            for (auto& publish_handle : module_data->publish_handles_)
+            {
+                publish_handle.routes_.store(nullptr, std::memory_order_seq_cst);
+            }
         }
     }
+
+    std::shared_ptr<const structures::RoutingTable> previous_routing_table = std::move(routing_table_);
+    routing_table_ = std::move(routing_table);
+    current_routing_table_.store(routing_table_.get(), std::memory_order_seq_cst);
+
+    // once no sender reads the previous table, it lives on only in the dispatcher tasks still referencing it
+    routing_readers_.synchronize();
+    dispatcher_.releaseIdleTables();
+
+    {
+        std::lock_guard<std::mutex> cache_lock(query_cache_mutex_);
+        query_cache_ = QueryCache();
+    }
+
+    publishTopologyChange(routing_table_.get(), topology_tracker_.update(running_modules_, loaded_modules_.data()));
 }
 
 
 
-uint64_t Core::getNextModuleId()
+void Core::publishTopologyChange(const structures::RoutingTable* routing_table, const std::vector<aergo::module::TopologyEvent>& events)
 {
-    return running_modules_.size();
+    if (events.empty())
+    {
+        return;
+    }
+
+    // every change with events counts as published, also if it fails below, so subscribers see the gap
+    uint64_t previous_state_id = topology_published_state_id_;
+    topology_published_state_id_ = routing_table->state_id_;
+
+    if (routing_table->topology_.empty())
+    {
+        return;
+    }
+
+    aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(events.size() * sizeof(aergo::module::TopologyEvent));
+    if (!blob.valid())
+    {
+        log(aergo::module::logging::LogType::WARNING, "Failed to allocate topology events, in publishTopologyChange");
+        return;
+    }
+    std::memcpy(blob.data(), events.data(), events.size() * sizeof(aergo::module::TopologyEvent));
+
+    aergo::module::TopologyChange change {
+        .previous_state_id_ = previous_state_id,
+        .state_id_ = routing_table->state_id_,
+        .event_count_ = events.size()
+    };
+
+    dispatcher_.dispatchMessage(routing_table, &routing_table->topology_, aergo::module::TOPOLOGY_CHANNEL, {
+        .data_ = reinterpret_cast<uint8_t*>(&change),
+        .data_len_ = sizeof(change),
+        .blobs_ = &blob,
+        .blob_count_ = 1,
+        .id_ = change.state_id_,
+        .timestamp_ns_ = nowNs(),
+        .success_ = true,
+        .deadline_ns_ = 0
+    });
 }
 
 
@@ -321,18 +803,23 @@ void Core::registerConsumers(uint64_t module_id, aergo::module::InputChannelMapI
 {
     auto& running_module = running_modules_[module_id];
 
+    const aergo::module::ModuleInfo* module_info = (*running_module->module_loader_data_)->readModuleInfo();
+
     uint32_t consumer_info_count;
     aergo::module::InputChannelMapInfo::IndividualChannelInfo* consumer_info;
+    const aergo::module::communication_channel::Consumer* module_info_consumers;
 
     if (consumer_type == ConsumerType::SUBSCRIBE)
     {
         consumer_info_count = channel_map_info.subscribe_consumer_info_count_;
         consumer_info = channel_map_info.subscribe_consumer_info_;
+        module_info_consumers = module_info->subscribe_consumers_;
     }
     else if (consumer_type == ConsumerType::REQUEST)
     {
         consumer_info_count = channel_map_info.request_consumer_info_count_;
         consumer_info = channel_map_info.request_consumer_info_;
+        module_info_consumers = module_info->request_consumers_;
     }
     else
     {
@@ -357,6 +844,14 @@ void Core::registerConsumers(uint64_t module_id, aergo::module::InputChannelMapI
 
             mapping_consumer[channel_id].push_back(channel_identifier);
         }
+
+        if (module_info_consumers[channel_id].count_ != aergo::module::communication_channel::Consumer::Count::AUTO_ALL)
+        {
+            for (uint32_t channel_i = 0; channel_i < consumer_channel_info.channel_identifier_count_; ++channel_i)
+            {
+                dependency_graph_.addDependency(consumer_channel_info.channel_identifier_[channel_i].producer_module_id_, module_id);
+            }
+        }
     }
 }
 
@@ -558,9 +1053,8 @@ uint64_t Core::getCreatedModulesCount()
 
 uint64_t Core::getModulesMappingStateId() noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
-
-    return module_mapping_state_id_;
+    EpochReaders::Section section(routing_readers_);
+    return current_routing_table_.load(std::memory_order_seq_cst)->state_id_;
 }
 
 
@@ -631,61 +1125,7 @@ Core::RemoveResult Core::removeModule(uint64_t id, bool recursive)
         return Core::RemoveResult::HAS_DEPENDENCIES;
     }
 
-    bool stop_success = true;
-    for (size_t dependent_modules_id_p_1 = dependent_modules.size(); dependent_modules_id_p_1 > 0; --dependent_modules_id_p_1)
-    {
-        size_t dependent_modules_id = dependent_modules_id_p_1 - 1;
-        uint64_t module_id = dependent_modules[dependent_modules_id];
-
-        removeMappingProducers(module_id, ConsumerType::SUBSCRIBE);
-        removeMappingProducers(module_id, ConsumerType::REQUEST);
-        removeMappingSubscribers(module_id, ConsumerType::SUBSCRIBE);
-        removeMappingSubscribers(module_id, ConsumerType::REQUEST);
-        
-        auto module_data = running_modules_[module_id].get();
-        auto module_info = (*module_data->module_loader_data_)->readModuleInfo();
-
-        removeFromExistingMap(
-            module_id, module_info->publish_producer_count_, 
-            [module_info](uint32_t channel_id) { return std::make_pair(
-                module_info->publish_producers_[channel_id].channel_type_identifier_, 
-                true
-            ); }, 
-            existing_publish_channels_
-        );
-        removeFromExistingMap(
-            module_id, module_info->response_producer_count_, 
-            [module_info](uint32_t channel_id) { return std::make_pair(
-                module_info->response_producers_[channel_id].channel_type_identifier_,
-                true
-            ); }, 
-            existing_response_channels_
-        );
-        removeFromExistingMap(
-            module_id, module_info->subscribe_consumer_count_, 
-            [module_info](uint32_t channel_id) { return std::make_pair(
-                module_info->subscribe_consumers_[channel_id].channel_type_identifier_,
-                module_info->subscribe_consumers_[channel_id].count_ == aergo::module::communication_channel::Consumer::Count::AUTO_ALL
-            ); }, 
-            existing_subscribe_auto_all_channels_
-        );
-        removeFromExistingMap(
-            module_id, module_info->request_consumer_count_, 
-            [module_info](uint32_t channel_id) { return std::make_pair(
-                module_info->request_consumers_[channel_id].channel_type_identifier_,
-                module_info->request_consumers_[channel_id].count_ == aergo::module::communication_channel::Consumer::Count::AUTO_ALL
-            ); }, 
-            existing_request_auto_all_channels_
-        );
-
-        bool res = running_modules_[module_id]->module_->threadStop(defaults::module_thread_timeout_ms_);
-        stop_success = stop_success && res;    // stop_success: T->{T,F}; F->F (never F->T)
-        running_modules_[module_id] = nullptr; // only if stop successful? 
-    }
-
-    ++module_mapping_state_id_;
-
-    if (!stop_success)
+    if (!removeModulesImpl(dependent_modules))
     {
         return Core::RemoveResult::FAILED_TO_STOP_THREADS;   
     }
@@ -695,208 +1135,350 @@ Core::RemoveResult Core::removeModule(uint64_t id, bool recursive)
 
 
 
-std::vector<uint64_t> Core::collectDependentModules(uint64_t id)
+bool Core::removeModulesImpl(const std::vector<uint64_t>& module_ids)
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    std::vector<std::shared_ptr<structures::ModuleData>> removed_modules = detachModules(module_ids);
 
-    if (id >= running_modules_.size() || running_modules_[id].get() == nullptr)
-    {
-        return std::vector<uint64_t>();
-    }
+    // senders stop routing to the modules before their threads stop
+    commitMappingChange();
 
-    return collectDependentModulesImpl(id);
+    return stopModuleThreads(removed_modules);
 }
 
 
 
-std::vector<uint64_t> Core::collectDependentModulesImpl(uint64_t id)
+std::vector<std::shared_ptr<structures::ModuleData>> Core::detachModules(const std::vector<uint64_t>& module_ids)
 {
-    std::vector<uint64_t> dependent_modules;
-    std::map<uint64_t, size_t> explored_modules;
-    dependent_modules.push_back(id);
+    removeMappings(module_ids);
 
-    for (size_t i = 0; i < dependent_modules.size(); ++i)
+    std::vector<std::shared_ptr<structures::ModuleData>> detached_modules;
+    detached_modules.reserve(module_ids.size());
+    for (uint64_t module_id : module_ids)
     {
-        uint64_t module_id = dependent_modules[i];
-        auto it = explored_modules.find(module_id);
-        if (it != explored_modules.end())
-        {
-            it->second = i;
-            continue;
-        }
+        unregisterModule(module_id);
+        detached_modules.push_back(std::move(running_modules_[module_id])); // module is destroyed once no routing table references it
+    }
+    releaseModuleMemoryAccounts(module_ids);
 
-        structures::ModuleData* module_data = running_modules_[module_id].get();
+    return detached_modules;
+}
 
-        collectDependentModulesHelper(module_data, dependent_modules, ConsumerType::SUBSCRIBE);
-        collectDependentModulesHelper(module_data, dependent_modules, ConsumerType::REQUEST);
 
-        explored_modules[module_id] = i;
-    }
 
-    std::vector<uint64_t> result;
-    result.reserve(dependent_modules.size());
-    for (size_t i = 0; i < dependent_modules.size(); ++i)
+Core::RegistrationBackup Core::saveRegistration()
+{
+    RegistrationBackup backup {
+        .running_modules_ = running_modules_,
+        .mappings_ = std::vector<RegistrationBackup::ModuleMappings>(running_modules_.size()),
+        .dependency_graph_ = dependency_graph_,
+        .existing_publish_channels_ = existing_publish_channels_,
+        .existing_response_channels_ = existing_response_channels_,
+        .existing_subscribe_auto_all_channels_ = existing_subscribe_auto_all_channels_,
+        .existing_request_auto_all_channels_ = existing_request_auto_all_channels_
+    };
+
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+    for (size_t module_id = 0; module_id < running_modules_.size(); ++module_id)
     {
-        uint64_t module_id = dependent_modules[i];
-        if (explored_modules[module_id] == i)
+        if (running_modules_[module_id].get() != nullptr)
         {
-            result.push_back(module_id);
+            backup.mappings_[module_id] = {
+                .subscribe_ = running_modules_[module_id]->mapping_subscribe_,
+                .request_ = running_modules_[module_id]->mapping_request_,
+                .publish_ = running_modules_[module_id]->mapping_publish_,
+                .response_ = running_modules_[module_id]->mapping_response_
+            };
+
+            auto account_it = module_memory_accounts_.find(module_id);
+            if (account_it != module_memory_accounts_.end())
+            {
+                backup.module_memory_accounts_.insert(*account_it);
+            }
         }
     }
 
-    return result;
+    return backup;
 }
 
 
 
-void Core::collectDependentModulesHelper(structures::ModuleData* module_data, std::vector<uint64_t>& dependent_modules, ConsumerType consumer_type)
+void Core::restoreRegistration(RegistrationBackup&& backup)
 {
-    std::vector<std::vector<aergo::module::ChannelIdentifier>>& mapping_producer = (consumer_type == ConsumerType::SUBSCRIBE) ? module_data->mapping_publish_ : module_data->mapping_response_;
+    size_t module_count = running_modules_.size();
+    running_modules_ = std::move(backup.running_modules_);
+    running_modules_.resize(module_count);
 
-    for (auto& connected_channels : mapping_producer)
+    for (size_t module_id = 0; module_id < backup.mappings_.size(); ++module_id)
     {
-        for (auto channel_identifier : connected_channels)
+        if (running_modules_[module_id].get() != nullptr)
         {
-            if (channel_identifier.producer_module_id_ >= running_modules_.size())
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ too large in collectDependentModulesHelper, terminating!");
-                std::terminate();
-            }
-            if (running_modules_[channel_identifier.producer_module_id_].get() == nullptr)
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ references destroyed module in collectDependentModulesHelper, terminating!");
-                std::terminate();
-            }
+            running_modules_[module_id]->mapping_subscribe_ = std::move(backup.mappings_[module_id].subscribe_);
+            running_modules_[module_id]->mapping_request_ = std::move(backup.mappings_[module_id].request_);
+            running_modules_[module_id]->mapping_publish_ = std::move(backup.mappings_[module_id].publish_);
+            running_modules_[module_id]->mapping_response_ = std::move(backup.mappings_[module_id].response_);
+        }
+    }
 
-            const aergo::module::ModuleInfo* other_module_info = (*running_modules_[channel_identifier.producer_module_id_]->module_loader_data_)->readModuleInfo();
+    dependency_graph_ = std::move(backup.dependency_graph_);
+    existing_publish_channels_ = std::move(backup.existing_publish_channels_);
+    existing_response_channels_ = std::move(backup.existing_response_channels_);
+    existing_subscribe_auto_all_channels_ = std::move(backup.existing_subscribe_auto_all_channels_);
+    existing_request_auto_all_channels_ = std::move(backup.existing_request_auto_all_channels_);
 
-            uint32_t consumer_count = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumer_count_ : other_module_info->request_consumer_count_;
-            const aergo::module::communication_channel::Consumer* consumers = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumers_ : other_module_info->request_consumers_;
+    // modules removed since the backup get their accounts back, the ones created since are gone
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+    for (size_t module_id = backup.mappings_.size(); module_id < module_count; ++module_id)
+    {
+        module_memory_accounts_.erase(module_id);
+    }
+    module_memory_accounts_.insert(backup.module_memory_accounts_.begin(), backup.module_memory_accounts_.end());
+}
 
-            if (channel_identifier.producer_channel_id_ >= consumer_count)
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_channel_id_ too large in hasDependenciesHelper, terminating!");
-                std::terminate();
-            }
 
-            if (consumers[channel_identifier.producer_channel_id_].count_ != aergo::module::communication_channel::Consumer::Count::AUTO_ALL)
-            {
-                dependent_modules.push_back(channel_identifier.producer_module_id_);
-            }
-        }
-    }
+
+void Core::unregisterModule(uint64_t module_id)
+{
+    dependency_graph_.removeModule(module_id);
+
+    auto module_data = running_modules_[module_id].get();
+    auto module_info = (*module_data->module_loader_data_)->readModuleInfo();
+
+    removeFromExistingMap(
+        module_id, module_info->publish_producer_count_, 
+        [module_info](uint32_t channel_id) { return std::make_pair(
+            module_info->publish_producers_[channel_id].channel_type_identifier_, 
+            true
+        ); }, 
+        existing_publish_channels_
+    );
+    removeFromExistingMap(
+        module_id, module_info->response_producer_count_, 
+        [module_info](uint32_t channel_id) { return std::make_pair(
+            module_info->response_producers_[channel_id].channel_type_identifier_,
+            true
+        ); }, 
+        existing_response_channels_
+    );
+    removeFromExistingMap(
+        module_id, module_info->subscribe_consumer_count_, 
+        [module_info](uint32_t channel_id) { return std::make_pair(
+            module_info->subscribe_consumers_[channel_id].channel_type_identifier_,
+            module_info->subscribe_consumers_[channel_id].count_ == aergo::module::communication_channel::Consumer::Count::AUTO_ALL
+        ); }, 
+        existing_subscribe_auto_all_channels_
+    );
+    removeFromExistingMap(
+        module_id, module_info->request_consumer_count_, 
+        [module_info](uint32_t channel_id) { return std::make_pair(
+            module_info->request_consumers_[channel_id].channel_type_identifier_,
+            module_info->request_consumers_[channel_id].count_ == aergo::module::communication_channel::Consumer::Count::AUTO_ALL
+        ); }, 
+        existing_request_auto_all_channels_
+    );
 }
 
 
 
-void Core::removeMappingProducers(uint64_t module_id, ConsumerType consumer_type)
+bool Core::applyModuleBatch(aergo::module::ModuleBatch batch) noexcept
 {
-    structures::ModuleData* module_data = running_modules_[module_id].get();
+    std::lock_guard<std::mutex> lock(core_mutex_);
 
-    std::vector<std::vector<aergo::module::ChannelIdentifier>>& mapping_producer = (consumer_type == ConsumerType::SUBSCRIBE) ? module_data->mapping_publish_ : module_data->mapping_response_;
+    if ((batch.remove_count_ > 0 && batch.remove_ids_ == nullptr) || (batch.add_count_ > 0 && batch.adds_ == nullptr))
+    {
+        return false;
+    }
 
-    for (size_t channel_id = 0; channel_id < mapping_producer.size(); ++channel_id)
+    std::set<uint64_t> requested_modules(batch.remove_ids_, batch.remove_ids_ + batch.remove_count_);
+    std::set<uint64_t> removed_modules;
+    for (uint64_t id : requested_modules)
     {
-        for (auto other_channel_identifier : mapping_producer[channel_id])
+        if (id >= running_modules_.size() || running_modules_[id].get() == nullptr)
         {
-            if (other_channel_identifier.producer_module_id_ >= running_modules_.size())
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ too large in removeMappingProducers, terminating!");
-                std::terminate();
-            }
-            if (running_modules_[other_channel_identifier.producer_module_id_].get() == nullptr)
+            return false;
+        }
+
+        for (uint64_t dependent_id : collectDependentModulesImpl(id))
+        {
+            if (!batch.recursive_remove_ && !requested_modules.contains(dependent_id))
             {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ references destroyed module in removeMappingProducers, terminating!");
-                std::terminate();
+                return false;
             }
+            removed_modules.insert(dependent_id);
+        }
+    }
 
-            structures::ModuleData* other_module_data = running_modules_[other_channel_identifier.producer_module_id_].get();
-            const aergo::module::ModuleInfo* other_module_info = (*other_module_data->module_loader_data_)->readModuleInfo();
-            aergo::module::ChannelIdentifier our_channel {
-                .producer_module_id_ = module_id,
-                .producer_channel_id_ = (uint32_t)channel_id
-            };
+    // a batch that removes modules can only be undone from a copy once it is committed
+    std::optional<RegistrationBackup> backup;
+    if (!removed_modules.empty() && batch.add_count_ > 0)
+    {
+        backup = saveRegistration();
+    }
 
-            std::vector<std::vector<aergo::module::ChannelIdentifier>>& mapping_consumer = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_data->mapping_subscribe_ : other_module_data->mapping_request_;
-            uint32_t consumer_count = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumer_count_ : other_module_info->request_consumer_count_;
-            const aergo::module::communication_channel::Consumer* consumers = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumers_ : other_module_info->request_consumers_;
+    // added modules are registered but not started until the whole batch is valid, the routing table does not see them yet
+    uint64_t first_added_id = getNextModuleId();
+    for (uint32_t i = 0; i < batch.add_count_; ++i)
+    {
+        const aergo::module::ModuleBatch::Add& add = batch.adds_[i];
+        if (add.loaded_module_id_ >= loaded_modules_.size()
+            || !checkChannelMapValidity(add.channel_map_info_, loaded_modules_[add.loaded_module_id_]->readModuleInfo())
+            || mapsAnyModule(add.channel_map_info_, removed_modules)
+            || !createAndRegisterModule(add.loaded_module_id_, add.channel_map_info_))
+        {
+            discardCreatedModules(first_added_id);
+            return false;
+        }
+    }
 
-            if (other_channel_identifier.producer_channel_id_ >= mapping_consumer.size() || other_channel_identifier.producer_channel_id_ >= consumer_count)
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_channel_id_ too large in removeMappingProducers, terminating!");
-                std::terminate();
-            }
+    std::vector<uint64_t> added_modules;
+    for (uint64_t module_id = first_added_id; module_id < running_modules_.size(); ++module_id)
+    {
+        added_modules.push_back(module_id);
+    }
 
-            if (consumers[other_channel_identifier.producer_channel_id_].count_ != aergo::module::communication_channel::Consumer::Count::AUTO_ALL)
-            {
-                log(aergo::module::logging::LogType::ERROR, "count_ not AUTO_ALL in removeMappingProducers, terminating!");
-                std::terminate();
-            }
+    std::vector<std::shared_ptr<structures::ModuleData>> detached_modules = detachModules(std::vector<uint64_t>(removed_modules.begin(), removed_modules.end()));
 
-            std::vector<aergo::module::ChannelIdentifier>& single_channel_map = mapping_consumer[other_channel_identifier.producer_channel_id_];
-            auto it = std::find(single_channel_map.begin(), single_channel_map.end(), our_channel);
-            
-            if (it == single_channel_map.end())
-            {
-                log(aergo::module::logging::LogType::ERROR, "our_channel not found in other_module in removeMappingProducers, terminating!");
-                std::terminate();
-            }
+    // single commit for the whole batch, added modules are routed from their first cycle and removed ones are not routed to when they stop
+    commitMappingChange();
 
-            single_channel_map.erase(it);
+    if (!startModuleThreads(added_modules, defaults::module_thread_timeout_ms_))
+    {
+        // undo with a second commit, removed modules were not stopped yet
+        if (backup.has_value())
+        {
+            restoreRegistration(std::move(*backup));
+        }
+        else
+        {
+            detachModules(added_modules);
         }
+        commitMappingChange();
+        return false;
     }
+
+    return stopModuleThreads(detached_modules);
 }
 
 
 
-void Core::removeMappingSubscribers(uint64_t module_id, ConsumerType consumer_type)
+std::vector<uint64_t> Core::collectDependentModules(uint64_t id)
 {
-    structures::ModuleData* module_data = running_modules_[module_id].get();
-
-    std::vector<std::vector<aergo::module::ChannelIdentifier>>& mapping_consumer = (consumer_type == ConsumerType::SUBSCRIBE) ? module_data->mapping_subscribe_ : module_data->mapping_request_;
+    std::lock_guard<std::mutex> lock(core_mutex_);
 
-    for (size_t channel_id = 0; channel_id < mapping_consumer.size(); ++channel_id)
+    if (id >= running_modules_.size() || running_modules_[id].get() == nullptr)
     {
-        for (auto other_channel_identifier : mapping_consumer[channel_id])
-        {
-            if (other_channel_identifier.producer_module_id_ >= running_modules_.size())
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ too large in removeMappingProducers, terminating!");
-                std::terminate();
-            }
-            if (running_modules_[other_channel_identifier.producer_module_id_].get() == nullptr)
-            {
-                log(aergo::module::logging::LogType::ERROR, "producer_module_id_ references destroyed module in removeMappingProducers, terminating!");
-                std::terminate();
-            }
+        return std::vector<uint64_t>();
+    }
 
-            structures::ModuleData* other_module_data = running_modules_[other_channel_identifier.producer_module_id_].get();
-            const aergo::module::ModuleInfo* other_module_info = (*other_module_data->module_loader_data_)->readModuleInfo();
-            aergo::module::ChannelIdentifier our_channel {
-                .producer_module_id_ = module_id,
-                .producer_channel_id_ = (uint32_t)channel_id
-            };
+    return collectDependentModulesImpl(id);
+}
+
+
+
+std::vector<uint64_t> Core::collectDependentModulesImpl(uint64_t id)
+{
+    return dependency_graph_.collectDependents(id);
+}
+
+
+
+void Core::removeMappings(const std::vector<uint64_t>& module_ids)
+{
+    std::unordered_set<uint64_t> removed_modules(module_ids.begin(), module_ids.end());
+    std::unordered_set<std::vector<aergo::module::ChannelIdentifier>*> affected_channels;    // channels of other modules referencing removed ones
+
+    for (uint64_t module_id : module_ids)
+    {
+        structures::ModuleData* module_data = running_modules_[module_id].get();
 
-            std::vector<std::vector<aergo::module::ChannelIdentifier>>& other_mapping_producer = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_data->mapping_publish_ : other_module_data->mapping_response_;
+        for (ConsumerType consumer_type : { ConsumerType::SUBSCRIBE, ConsumerType::REQUEST })
+        {
+            auto& mapping_producer = (consumer_type == ConsumerType::SUBSCRIBE) ? module_data->mapping_publish_ : module_data->mapping_response_;
+            auto& mapping_consumer = (consumer_type == ConsumerType::SUBSCRIBE) ? module_data->mapping_subscribe_ : module_data->mapping_request_;
 
-            if (other_channel_identifier.producer_channel_id_ >= other_mapping_producer.size())
+            for (auto& connected_channels : mapping_producer)
             {
-                log(aergo::module::logging::LogType::ERROR, "producer_channel_id_ too large in removeMappingProducers, terminating!");
-                std::terminate();
+                for (auto other_channel_identifier : connected_channels)
+                {
+                    if (other_channel_identifier.producer_module_id_ >= running_modules_.size())
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_module_id_ too large in removeMappings, terminating!");
+                        std::terminate();
+                    }
+                    if (running_modules_[other_channel_identifier.producer_module_id_].get() == nullptr)
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_module_id_ references destroyed module in removeMappings, terminating!");
+                        std::terminate();
+                    }
+                    if (removed_modules.contains(other_channel_identifier.producer_module_id_))
+                    {
+                        continue;
+                    }
+
+                    structures::ModuleData* other_module_data = running_modules_[other_channel_identifier.producer_module_id_].get();
+                    const aergo::module::ModuleInfo* other_module_info = (*other_module_data->module_loader_data_)->readModuleInfo();
+
+                    auto& other_mapping_consumer = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_data->mapping_subscribe_ : other_module_data->mapping_request_;
+                    uint32_t consumer_count = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumer_count_ : other_module_info->request_consumer_count_;
+                    const aergo::module::communication_channel::Consumer* consumers = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_info->subscribe_consumers_ : other_module_info->request_consumers_;
+
+                    if (other_channel_identifier.producer_channel_id_ >= other_mapping_consumer.size() || other_channel_identifier.producer_channel_id_ >= consumer_count)
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_channel_id_ too large in removeMappings, terminating!");
+                        std::terminate();
+                    }
+
+                    // surviving consumers of a removed producer are never dependent on it
+                    if (consumers[other_channel_identifier.producer_channel_id_].count_ != aergo::module::communication_channel::Consumer::Count::AUTO_ALL)
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "count_ not AUTO_ALL in removeMappings, terminating!");
+                        std::terminate();
+                    }
+
+                    affected_channels.insert(&other_mapping_consumer[other_channel_identifier.producer_channel_id_]);
+                }
             }
 
-            std::vector<aergo::module::ChannelIdentifier>& single_channel_map = other_mapping_producer[other_channel_identifier.producer_channel_id_];
-            auto it = std::find(single_channel_map.begin(), single_channel_map.end(), our_channel);
-            
-            if (it == single_channel_map.end())
+            for (auto& connected_channels : mapping_consumer)
             {
-                log(aergo::module::logging::LogType::ERROR, "our_channel not found in other_module in removeMappingProducers, terminating!");
-                std::terminate();
+                for (auto other_channel_identifier : connected_channels)
+                {
+                    if (other_channel_identifier.producer_module_id_ >= running_modules_.size())
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_module_id_ too large in removeMappings, terminating!");
+                        std::terminate();
+                    }
+                    if (running_modules_[other_channel_identifier.producer_module_id_].get() == nullptr)
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_module_id_ references destroyed module in removeMappings, terminating!");
+                        std::terminate();
+                    }
+                    if (removed_modules.contains(other_channel_identifier.producer_module_id_))
+                    {
+                        continue;
+                    }
+
+                    structures::ModuleData* other_module_data = running_modules_[other_channel_identifier.producer_module_id_].get();
+                    auto& other_mapping_producer = (consumer_type == ConsumerType::SUBSCRIBE) ? other_module_data->mapping_publish_ : other_module_data->mapping_response_;
+
+                    if (other_channel_identifier.producer_channel_id_ >= other_mapping_producer.size())
+                    {
+                        log(aergo::module::logging::LogType::ERROR, "producer_channel_id_ too large in removeMappings, terminating!");
+                        std::terminate();
+                    }
+
+                    affected_channels.insert(&other_mapping_producer[other_channel_identifier.producer_channel_id_]);
+                }
             }
-
-            single_channel_map.erase(it);
         }
     }
+
+    // single pass per channel instead of a find + erase per removed connection, order of the remaining connections is kept
+    for (auto single_channel_map : affected_channels)
+    {
+        std::erase_if(*single_channel_map, [&removed_modules](const aergo::module::ChannelIdentifier channel_identifier) {
+            return removed_modules.contains(channel_identifier.producer_module_id_);
+        });
+    }
 }
 
 
@@ -922,9 +1504,9 @@ void Core::removeFromExistingMap(uint64_t module_id, uint32_t channel_count, std
         }
 
         auto& single_channel = it->second;
-        single_channel.erase(std::remove_if(single_channel.begin(), single_channel.end(), [module_id](const aergo::module::ChannelIdentifier channel_identifier) {
+        std::erase_if(single_channel, [module_id](const aergo::module::ChannelIdentifier channel_identifier) {
             return channel_identifier.producer_module_id_ == module_id;
-        }));
+        });
     }
 }
 
@@ -944,13 +1526,7 @@ bool Core::addModule(uint64_t loaded_module_id, aergo::module::InputChannelMapIn
         return false;
     }
 
-    bool res = createAndStartModule(loaded_module_id, channel_map_info, defaults::module_thread_timeout_ms_);
-    if (res)
-    {
-        ++module_mapping_state_id_;
-    }
-
-    return res;
+    return createAndStartModule(loaded_module_id, channel_map_info, defaults::module_thread_timeout_ms_);
 }
 
 
@@ -1087,128 +1663,253 @@ bool Core::checkChannelMapValidityArrayCheck(
 
 void Core::sendMessage(aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    EpochReaders::Section section(routing_readers_);
+    const structures::RoutingTable* routing_table = current_routing_table_.load(std::memory_order_seq_cst);
 
-    if (source_channel.producer_module_id_ >= running_modules_.size() || running_modules_[source_channel.producer_module_id_].get() == nullptr)
+    const structures::RoutingTable::ModuleRoutes* module_routes = routing_table->module(source_channel.producer_module_id_);
+    if (module_routes == nullptr)
     {
         log(aergo::module::logging::LogType::WARNING, "Module identified by producer_module_id_ does not exist, discarding message, in sendMessage");
         return;
     }
 
-    auto module_data = running_modules_[source_channel.producer_module_id_].get();
-
-    if (source_channel.producer_channel_id_ >= module_data->mapping_publish_.size())
+    if (source_channel.producer_channel_id_ >= module_routes->publish_.size())
     {
         log(aergo::module::logging::LogType::WARNING, "Channel identified by producer_channel_id_ does not exist, discarding message, in sendMessage");
         return;
     }
 
-    for (auto other_channel_id : module_data->mapping_publish_[source_channel.producer_channel_id_])
+    const std::vector<structures::RoutingTable::Route>& routes = module_routes->publish_[source_channel.producer_channel_id_].routes_;
+    if (routes.empty())
     {
-        if (other_channel_id.producer_module_id_ >= running_modules_.size() || running_modules_[other_channel_id.producer_module_id_].get() == nullptr)
-        {
-            log(aergo::module::logging::LogType::WARNING, "Other module identified by producer_module_id_ does not exist, in sendMessage");
-            continue;
-        }
+        return;
+    }
 
-        auto other_module_data = running_modules_[other_channel_id.producer_module_id_].get();
+    trackSentBlobs(source_channel, message);
+    dispatcher_.dispatchMessage(routing_table, &routes, source_channel, message);
+}
 
-        if (other_channel_id.producer_channel_id_ >= other_module_data->mapping_subscribe_.size())
-        {
-            log(aergo::module::logging::LogType::WARNING, "Other channel identified by producer_channel_id_ does not exist, in sendMessage");
-            continue;
-        }
 
-        other_module_data->module_->processMessage(other_channel_id.producer_channel_id_, source_channel, message);
+
+aergo::module::IPublishHandle* Core::getPublishHandle(aergo::module::ChannelIdentifier source_channel) noexcept
+{
+    EpochReaders::Section section(routing_readers_);
+    const structures::RoutingTable* routing_table = current_routing_table_.load(std::memory_order_seq_cst);
+
+    const structures::RoutingTable::ModuleRoutes* module_routes = routing_table->module(source_channel.producer_module_id_);
+    if (module_routes == nullptr || source_channel.producer_channel_id_ >= module_routes->module_data_->publish_handles_.size())
+    {
+        return nullptr;
+    }
+
+    return &module_routes->module_data_->publish_handles_[source_channel.producer_channel_id_];
+}
+
+
+
+void Core::sendMessage(aergo::module::IPublishHandle* publish_handle, aergo::module::message::MessageHeader message) noexcept
+{
+    if (publish_handle == nullptr)
+    {
+        log(aergo::module::logging::LogType::WARNING, "Publish handle is nullptr, discarding message, in sendMessage");
+        return;
+    }
+    structures::PublishHandle* handle = static_cast<structures::PublishHandle*>(publish_handle);
+
+    EpochReaders::Section section(routing_readers_);
+    const structures::RoutingTable::PublishRoutes* publish_routes = handle->routes_.load(std::memory_order_seq_cst);
+    if (publish_routes == nullptr)
+    {
+        log(aergo::module::logging::LogType::WARNING, "Module of the publish handle is not running, discarding message, in sendMessage");
+        return;
+    }
+
+    if (publish_routes->routes_.empty())
+    {
+        return;
     }
+
+    trackSentBlobs(handle->channel_, message);
+    dispatcher_.dispatchMessage(publish_routes->table_, &publish_routes->routes_, handle->channel_, message);
 }
 
 
 
 void Core::sendResponse(aergo::module::ChannelIdentifier source_channel, aergo::module::ChannelIdentifier target_channel, aergo::module::message::MessageHeader message) noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    EpochReaders::Section section(routing_readers_);
+    const structures::RoutingTable* routing_table = current_routing_table_.load(std::memory_order_seq_cst);
 
-    if (source_channel.producer_module_id_ >= running_modules_.size() || running_modules_[source_channel.producer_module_id_].get() == nullptr
-     || target_channel.producer_module_id_ >= running_modules_.size() || running_modules_[target_channel.producer_module_id_].get() == nullptr)
+    const structures::RoutingTable::ModuleRoutes* source_module_routes = routing_table->module(source_channel.producer_module_id_);
+    const structures::RoutingTable::ModuleRoutes* target_module_routes = routing_table->module(target_channel.producer_module_id_);
+
+    if (source_module_routes == nullptr || target_module_routes == nullptr)
     {
         log(aergo::module::logging::LogType::WARNING, "Source or target module identified by producer_module_id_ does not exist, discarding message, in sendResponse");
         return;
     }
 
-    auto source_module_data = running_modules_[source_channel.producer_module_id_].get();
-    auto target_module_data = running_modules_[target_channel.producer_module_id_].get();
-
-    if (source_channel.producer_channel_id_ >= source_module_data->mapping_response_.size() || target_channel.producer_channel_id_ >= target_module_data->mapping_request_.size())
+    if (source_channel.producer_channel_id_ >= source_module_routes->response_channel_count_ || target_channel.producer_channel_id_ >= target_module_routes->request_channel_count_)
     {
         log(aergo::module::logging::LogType::WARNING, "Source or target channel identified by producer_channel_id_ does not exist, discarding message, in sendResponse");
         return;
     }
     
-    target_module_data->module_->processResponse(target_channel.producer_channel_id_, source_channel, message);
+    structures::RoutingTable::Route target { target_module_routes->module_data_->module_.get(), target_channel.producer_channel_id_ };
+    trackSentBlobs(source_channel, message);
+    if (!dispatcher_.dispatchSingle(aergo::module::IModule::ProcessingType::RESPONSE, routing_table, target, source_channel, message))
+    {
+        log(aergo::module::logging::LogType::WARNING, "Failed to dispatch response, in sendResponse");
+    }
 }
 
 
 
 void Core::sendRequest(aergo::module::ChannelIdentifier source_channel, aergo::module::ChannelIdentifier target_channel, aergo::module::message::MessageHeader message) noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    EpochReaders::Section section(routing_readers_);
+    const structures::RoutingTable* routing_table = current_routing_table_.load(std::memory_order_seq_cst);
+
+    const structures::RoutingTable::ModuleRoutes* source_module_routes = routing_table->module(source_channel.producer_module_id_);
+    const structures::RoutingTable::ModuleRoutes* target_module_routes = routing_table->module(target_channel.producer_module_id_);
 
-    if (source_channel.producer_module_id_ >= running_modules_.size() || running_modules_[source_channel.producer_module_id_].get() == nullptr
-     || target_channel.producer_module_id_ >= running_modules_.size() || running_modules_[target_channel.producer_module_id_].get() == nullptr)
+    if (source_module_routes == nullptr || target_module_routes == nullptr)
     {
         log(aergo::module::logging::LogType::WARNING, "Source or target module identified by producer_module_id_ does not exist, discarding message, in sendRequest");
         return;
     }
 
-    auto source_module_data = running_modules_[source_channel.producer_module_id_].get();
-    auto target_module_data = running_modules_[target_channel.producer_module_id_].get();
-
-    if (source_channel.producer_channel_id_ >= source_module_data->mapping_request_.size() || target_channel.producer_channel_id_ >= target_module_data->mapping_response_.size())
+    if (source_channel.producer_channel_id_ >= source_module_routes->request_channel_count_ || target_channel.producer_channel_id_ >= target_module_routes->response_channel_count_)
     {
         log(aergo::module::logging::LogType::WARNING, "Source or target channel identified by producer_channel_id_ does not exist, discarding message, in sendRequest");
         return;
     }
     
-    target_module_data->module_->processRequest(target_channel.producer_channel_id_, source_channel, message);
+    structures::RoutingTable::Route target { target_module_routes->module_data_->module_.get(), target_channel.producer_channel_id_ };
+    trackSentBlobs(source_channel, message);
+    if (!dispatcher_.dispatchSingle(aergo::module::IModule::ProcessingType::REQUEST, routing_table, target, source_channel, message))
+    {
+        answerUndeliveredRequest(*source_module_routes, source_channel, target_channel, message.id_);
+    }
 }
 
 
 
-aergo::module::IAllocator* Core::createDynamicAllocator() noexcept
+void Core::answerUndeliveredRequest(const structures::RoutingTable::ModuleRoutes& requester_routes, aergo::module::ChannelIdentifier source_channel,
+    aergo::module::ChannelIdentifier target_channel, uint64_t request_id)
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    aergo::module::message::EnvelopeRef envelope(aergo::module::message::MessageEnvelope::create({
+        .data_ = nullptr,
+        .data_len_ = 0,
+        .blobs_ = nullptr,
+        .blob_count_ = 0,
+        .id_ = request_id,
+        .timestamp_ns_ = nowNs(),
+        .success_ = false,
+        .deadline_ns_ = 0
+    }));
+    if (!envelope)
+    {
+        log(aergo::module::logging::LogType::ERROR, "Failed to dispatch request or allocate its failure response, in sendRequest");
+        return;
+    }
 
-    auto allocator = std::make_unique<memory_allocation::DynamicAllocator>(logger_);
-    auto allocator_wrapper = std::make_unique<memory_allocation::AllocatorWrapper>(std::move(allocator));
-    aergo::module::IAllocator* raw_ptr = allocator_wrapper.get();
-    allocators_.push_back(std::move(allocator_wrapper));
-    return raw_ptr;
+    log(aergo::module::logging::LogType::WARNING, "Failed to dispatch request, answering with success_ = false, in sendRequest");
+    requester_routes.module_data_->module_->processEnvelope(aergo::module::IModule::ProcessingType::RESPONSE, source_channel.producer_channel_id_, target_channel, envelope.get());
 }
 
 
 
-aergo::module::IAllocator* Core::createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots) noexcept
+aergo::module::IAllocator* Core::createDynamicAllocator(uint64_t module_id, aergo::module::AllocationOptions options) noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
 
-    auto allocator = std::make_unique<memory_allocation::StaticAllocator>(slot_size_bytes, number_of_slots, logger_);
-    auto allocator_wrapper = std::make_unique<memory_allocation::AllocatorWrapper>(std::move(allocator));
-    aergo::module::IAllocator* raw_ptr = allocator_wrapper.get();
-    allocators_.push_back(std::move(allocator_wrapper));
-    return raw_ptr;
+    std::shared_ptr<memory_allocation::MemoryAccount> module_account = getModuleMemoryAccount(module_id);
+    auto account = std::make_unique<memory_allocation::MemoryAccount>(module_account.get());
+    auto allocator = std::make_unique<memory_allocation::DynamicAllocator>(logger_, nullptr, options, account.get());
+    return registerAllocator(module_id, std::move(module_account), std::move(account), std::move(allocator));
+}
+
+
+
+aergo::module::IAllocator* Core::createBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::module::AllocationOptions options) noexcept
+{
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+
+    std::shared_ptr<memory_allocation::MemoryAccount> module_account = getModuleMemoryAccount(module_id);
+    auto account = std::make_unique<memory_allocation::MemoryAccount>(module_account.get());
+    std::unique_ptr<memory_allocation::StaticAllocator> allocator;
+    try
+    {
+        allocator = std::make_unique<memory_allocation::StaticAllocator>(slot_size_bytes, number_of_slots, logger_, nullptr, options, account.get());
+    }
+    catch (const memory_allocation::StaticAllocator::StaticAllocatorInitializationException&)
+    {
+        return nullptr;
+    }
+
+    return registerAllocator(module_id, std::move(module_account), std::move(account), std::move(allocator));
+}
+
+
+
+aergo::module::IAllocator* Core::createElasticBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, aergo::module::ElasticBufferOptions options, aergo::module::AllocationOptions allocation_options) noexcept
+{
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+
+    std::shared_ptr<memory_allocation::MemoryAccount> module_account = getModuleMemoryAccount(module_id);
+    auto account = std::make_unique<memory_allocation::MemoryAccount>(module_account.get());
+    std::unique_ptr<memory_allocation::ElasticAllocator> allocator;
+    try
+    {
+        allocator = std::make_unique<memory_allocation::ElasticAllocator>(slot_size_bytes, options, logger_, nullptr, allocation_options, account.get());
+    }
+    catch (const memory_allocation::ElasticAllocator::ElasticAllocatorInitializationException&)
+    {
+        return nullptr;
+    }
+
+    return registerAllocator(module_id, std::move(module_account), std::move(account), std::move(allocator));
+}
+
+
+
+aergo::module::IAllocator* Core::createMappedFileAllocator(uint64_t module_id, const char* path, aergo::module::MappedFileOptions options) noexcept
+{
+    if (path == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+
+    std::shared_ptr<memory_allocation::MemoryAccount> module_account = getModuleMemoryAccount(module_id);
+    auto account = std::make_unique<memory_allocation::MemoryAccount>(module_account.get());
+    std::unique_ptr<memory_allocation::MappedFileAllocator> allocator;
+    try
+    {
+        allocator = std::make_unique<memory_allocation::MappedFileAllocator>(path, options, logger_, account.get());
+    }
+    catch (const memory_allocation::MappedFileAllocator::MappedFileAllocatorInitializationException&)
+    {
+        return nullptr;
+    }
+
+    return registerAllocator(module_id, std::move(module_account), std::move(account), std::move(allocator));
 }
 
 
 
 void Core::deleteAllocator(aergo::module::IAllocator* allocator) noexcept
 {
-    std::lock_guard<std::mutex> lock(core_mutex_);
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
 
-    auto it = std::find_if(allocators_.begin(), allocators_.end(), [allocator](auto& ptr) { return allocator == ptr.get(); });
+    auto it = std::find_if(allocators_.begin(), allocators_.end(), [allocator](auto& data) { return allocator == data.allocator_.get(); });
 
     if (it != allocators_.end())
     {
+        // erase move-assigns the following elements (account first), so destroy the allocator while its account still exists
+        it->allocator_.reset();
         allocators_.erase(it);
     }
     else
@@ -1219,13 +1920,192 @@ void Core::deleteAllocator(aergo::module::IAllocator* allocator) noexcept
 
 
 
+aergo::module::MemoryStats Core::getModuleMemoryStats(uint64_t module_id) noexcept
+{
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+
+    auto it = module_memory_accounts_.find(module_id);
+    return (it != module_memory_accounts_.end()) ? it->second->stats() : aergo::module::MemoryStats {};
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::getModuleAllocatorsMemoryStats(uint64_t module_id) noexcept
+{
+    std::vector<aergo::module::MemoryStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(allocators_mutex_);
+        auto account_it = module_memory_accounts_.find(module_id);
+        for (auto& allocator_data : allocators_)
+        {
+            // allocators left by a removed module with the same ID charge its old account
+            if (account_it != module_memory_accounts_.end() && allocator_data.module_account_ == account_it->second)
+            {
+                stats.push_back(allocator_data.account_->stats());
+            }
+        }
+    }
+
+    aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(uint64_t) + sizeof(aergo::module::MemoryStats) * stats.size());
+    if (!blob.valid())
+    {
+        return aergo::module::message::SharedDataBlob(); // return invalid blob
+    }
+
+    uint64_t* data_as_uint64 = reinterpret_cast<uint64_t*>(blob.data());
+    data_as_uint64[0] = (uint64_t)stats.size();
+    aergo::module::MemoryStats* data_as_stats = reinterpret_cast<aergo::module::MemoryStats*>(data_as_uint64 + 1);
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        data_as_stats[i] = stats[i];
+    }
+
+    return blob;
+}
+
+
+
+void Core::setModuleMemoryQuota(uint64_t module_id, uint64_t quota_bytes) noexcept
+{
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+    getModuleMemoryAccount(module_id)->setQuota(quota_bytes);
+}
+
+
+
+void Core::setAllocationSampling(uint32_t sample_period) noexcept
+{
+    allocation_tracker_.setSamplePeriod(sample_period);
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::getOutstandingAllocations(uint64_t min_age_ns) noexcept
+{
+    std::vector<aergo::module::AllocationSample> samples = allocation_tracker_.outstanding(min_age_ns);
+
+    aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(uint64_t) + sizeof(aergo::module::AllocationSample) * samples.size());
+    if (!blob.valid())
+    {
+        return aergo::module::message::SharedDataBlob(); // return invalid blob
+    }
+
+    uint64_t* data_as_uint64 = reinterpret_cast<uint64_t*>(blob.data());
+    data_as_uint64[0] = (uint64_t)samples.size();
+    aergo::module::AllocationSample* data_as_samples = reinterpret_cast<aergo::module::AllocationSample*>(data_as_uint64 + 1);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        data_as_samples[i] = samples[i];
+    }
+
+    return blob;
+}
+
+
+
+std::shared_ptr<memory_allocation::MemoryAccount> Core::getModuleMemoryAccount(uint64_t module_id)
+{
+    auto& account = module_memory_accounts_[module_id];
+    if (!account)
+    {
+        account = std::make_shared<memory_allocation::MemoryAccount>();
+    }
+    return account;
+}
+
+
+
+aergo::module::IAllocator* Core::registerAllocator(uint64_t module_id, std::shared_ptr<memory_allocation::MemoryAccount> module_account,
+    std::unique_ptr<memory_allocation::MemoryAccount> account, std::unique_ptr<memory_allocation::ICoreAllocator> allocator)
+{
+    auto allocator_wrapper = std::make_unique<memory_allocation::AllocatorWrapper>(std::move(allocator), &allocation_tracker_, module_id, next_allocator_id_++);
+    aergo::module::IAllocator* raw_ptr = allocator_wrapper.get();
+    allocators_.push_back(structures::AllocatorData {
+        .module_id_ = module_id,
+        .module_account_ = std::move(module_account),
+        .account_ = std::move(account),
+        .allocator_ = std::move(allocator_wrapper)
+    });
+    return raw_ptr;
+}
+
+
+
+void Core::releaseModuleMemoryAccounts(const std::vector<uint64_t>& module_ids)
+{
+    std::lock_guard<std::mutex> lock(allocators_mutex_);
+    for (uint64_t module_id : module_ids)
+    {
+        module_memory_accounts_.erase(module_id);
+    }
+}
+
+
+
+void Core::trackSentBlobs(aergo::module::ChannelIdentifier channel, aergo::module::message::MessageHeader& message)
+{
+    if (!allocation_tracker_.hasSamples())
+    {
+        return;
+    }
+
+    for (uint64_t i = 0; i < message.blob_count_; ++i)
+    {
+        if (message.blobs_[i].valid())
+        {
+            allocation_tracker_.published(message.blobs_[i].data(), channel);
+        }
+    }
+}
+
+
+
+aergo::module::IExecutor* Core::getExecutor(bool prioritized) noexcept
+{
+    return prioritized ? &prioritized_executor_ : &regular_executor_;
+}
+
+
+
+template<typename Key, typename Value, typename Build>
+Value Core::cachedQuery(std::unordered_map<Key, Value> QueryCache::* cache, const Key& key, Build build)
+{
+    {
+        std::lock_guard<std::mutex> cache_lock(query_cache_mutex_);
+        auto it = (query_cache_.*cache).find(key);
+        if (it != (query_cache_.*cache).end())
+        {
+            return it->second;
+        }
+    }
+
+    // built and stored under core_mutex_, so a concurrent commitMappingChange cannot clear the cache in between
+    std::lock_guard<std::mutex> lock(core_mutex_);
+    Value value = build();
+    if (isComplete(value))
+    {
+        std::lock_guard<std::mutex> cache_lock(query_cache_mutex_);
+        (query_cache_.*cache).emplace(key, value);
+    }
+    return value;
+}
+
+
+
 aergo::module::RunningModuleInfo Core::getRunningModulesInfo(uint64_t running_module_id) noexcept
 {
-    auto module_info = getCreatedModulesInfo(running_module_id);
-    if (module_info == nullptr)
+    return cachedQuery(&QueryCache::running_modules_info_, running_module_id, [this, running_module_id]() { return buildRunningModuleInfo(running_module_id); });
+}
+
+
+
+aergo::module::RunningModuleInfo Core::buildRunningModuleInfo(uint64_t running_module_id)
+{
+    if (running_module_id >= running_modules_.size() || running_modules_[running_module_id].get() == nullptr)
     {
         return { .exists_ = false };
     }
+    auto module_info = running_modules_[running_module_id].get();
 
     aergo::module::RunningModuleInfo info {
         .exists_ = true,
@@ -1310,7 +2190,19 @@ uint64_t Core::getRunningModulesCount() noexcept
 
 aergo::module::message::SharedDataBlob Core::collectDependencies(uint64_t id) noexcept
 {
-    auto dependent_modules = collectDependentModules(id);
+    return cachedQuery(&QueryCache::dependencies_, id, [this, id]() { return buildDependenciesBlob(id); });
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::buildDependenciesBlob(uint64_t id)
+{
+    std::vector<uint64_t> dependent_modules;
+    if (id < running_modules_.size() && running_modules_[id].get() != nullptr)
+    {
+        dependent_modules = collectDependentModulesImpl(id);
+    }
+
     aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(uint64_t) + sizeof(uint64_t) * dependent_modules.size());
     if (!blob.valid())
     {
@@ -1332,9 +2224,26 @@ aergo::module::message::SharedDataBlob Core::collectDependencies(uint64_t id) no
 
 aergo::module::message::SharedDataBlob Core::getExistingPublishChannelsByName(const char* channel_type_identifier) noexcept
 {
-    auto& channels = getExistingPublishChannels(channel_type_identifier);
+    return cachedQuery(&QueryCache::publish_channels_, std::string(channel_type_identifier), [this, channel_type_identifier]() {
+        return buildChannelsBlob(getExistingPublishChannelsImpl(channel_type_identifier));
+    });
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::getExistingResponseChannelsByName(const char* channel_type_identifier) noexcept
+{
+    return cachedQuery(&QueryCache::response_channels_, std::string(channel_type_identifier), [this, channel_type_identifier]() {
+        return buildChannelsBlob(getExistingResponseChannelsImpl(channel_type_identifier));
+    });
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::buildChannelsBlob(const std::vector<aergo::module::ChannelIdentifier>& channels)
+{
     aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(uint64_t) + sizeof(aergo::module::ChannelIdentifier) * channels.size());
-    if (!blob.valid())  
+    if (!blob.valid())
     {
         return aergo::module::message::SharedDataBlob(); // return invalid blob
     }
@@ -1353,23 +2262,31 @@ aergo::module::message::SharedDataBlob Core::getExistingPublishChannelsByName(co
 
 
 
-aergo::module::message::SharedDataBlob Core::getExistingResponseChannelsByName(const char* channel_type_identifier) noexcept
+aergo::module::message::SharedDataBlob Core::getTopologySnapshot() noexcept
 {
-    auto& channels = getExistingResponseChannels(channel_type_identifier);
-    aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(uint64_t) + sizeof(aergo::module::ChannelIdentifier) * channels.size());
-    if (!blob.valid())  
+    // not keyed by getModulesMappingStateId(), read without core_mutex_ it may be older than the state the snapshot is built from
+    return cachedQuery(&QueryCache::topology_snapshot_, uint64_t(0), [this]() { return buildTopologySnapshot(); });
+}
+
+
+
+aergo::module::message::SharedDataBlob Core::buildTopologySnapshot()
+{
+    std::vector<aergo::module::TopologyEvent> events = topology_tracker_.snapshot();
+
+    aergo::module::message::SharedDataBlob blob = core_dynamic_allocator_->allocate(sizeof(aergo::module::TopologyChange) + events.size() * sizeof(aergo::module::TopologyEvent));
+    if (!blob.valid())
     {
         return aergo::module::message::SharedDataBlob(); // return invalid blob
     }
 
-    uint8_t* data_ptr = blob.data();
-    uint64_t* data_as_uint64 = reinterpret_cast<uint64_t*>(data_ptr);
-    data_as_uint64[0] = (uint64_t)channels.size();
-    aergo::module::ChannelIdentifier* data_as_channel_identifier = reinterpret_cast<aergo::module::ChannelIdentifier*>(data_as_uint64 + 1);
-    for (size_t i = 0; i < channels.size(); ++i)
-    {
-        data_as_channel_identifier[i] = channels[i];
-    }
+    aergo::module::TopologyChange header {
+        .previous_state_id_ = 0,
+        .state_id_ = module_mapping_state_id_,
+        .event_count_ = events.size()
+    };
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), events.data(), events.size() * sizeof(aergo::module::TopologyEvent));
 
     return blob;
 }
@@ -49,6 +49,18 @@ ModuleData::ModuleData(ModuleLogger&& logger, ModuleLoaderData* module_loader_da
 
 
 
+const RoutingTable::ModuleRoutes* RoutingTable::module(uint64_t module_id) const
+{
+    if (module_id >= modules_.size() || modules_[module_id].module_data_ == nullptr)
+    {
+        return nullptr;
+    }
+
+    return &modules_[module_id];
+}
+
+
+
 ModuleLogger::ModuleLogger(aergo::core::logging::ILogger* core_logger, std::string module_name, uint64_t module_id)
 : core_logger_(core_logger), module_name_(std::move(module_name)), module_id_(module_id) {}
 
@@ -0,0 +1,85 @@
+#include "core/dependency_graph.h"
+
+#include <algorithm>
+
+using namespace aergo::core;
+
+
+
+void DependencyGraph::addDependency(uint64_t producer_module_id, uint64_t consumer_module_id)
+{
+    node(producer_module_id).dependents_.insert(consumer_module_id);
+    node(consumer_module_id).dependencies_.insert(producer_module_id);
+}
+
+
+
+void DependencyGraph::removeModule(uint64_t module_id)
+{
+    if (module_id >= nodes_.size())
+    {
+        return;
+    }
+
+    Node& removed = nodes_[module_id];
+    for (uint64_t producer_module_id : removed.dependencies_)
+    {
+        nodes_[producer_module_id].dependents_.erase(module_id);
+    }
+    for (uint64_t consumer_module_id : removed.dependents_)
+    {
+        nodes_[consumer_module_id].dependencies_.erase(module_id);
+    }
+
+    removed.dependencies_.clear();
+    removed.dependents_.clear();
+}
+
+
+
+std::vector<uint64_t> DependencyGraph::collectDependents(uint64_t module_id)
+{
+    std::vector<uint64_t> result { module_id };
+    if (module_id >= nodes_.size())
+    {
+        return result;
+    }
+
+    ++visit_epoch_;
+    nodes_[module_id].visit_epoch_ = visit_epoch_;
+
+    // result doubles as the walk stack, every visited module is appended once
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        for (uint64_t consumer_module_id : nodes_[result[i]].dependents_)
+        {
+            Node& consumer = nodes_[consumer_module_id];
+            if (consumer.visit_epoch_ != visit_epoch_)
+            {
+                consumer.visit_epoch_ = visit_epoch_;
+                result.push_back(consumer_module_id);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+
+size_t DependencyGraph::dependentCount(uint64_t module_id) const
+{
+    return (module_id < nodes_.size()) ? nodes_[module_id].dependents_.size() : 0;
+}
+
+
+
+DependencyGraph::Node& DependencyGraph::node(uint64_t module_id)
+{
+    if (module_id >= nodes_.size())
+    {
+        nodes_.resize(module_id + 1);
+    }
+    return nodes_[module_id];
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "core/epoch_readers.h"
+
+#include <thread>
+
+using namespace aergo::core;
+
+
+
+namespace
+{
+    std::atomic<uint32_t> next_reader_slot = 0;
+
+    /// @brief Slot index of the calling thread, assigned round robin on first use.
+    uint32_t readerSlot(uint32_t slot_count)
+    {
+        thread_local uint32_t slot = next_reader_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot % slot_count;
+    }
+}
+
+
+
+EpochReaders::Section::Section(EpochReaders& readers) noexcept
+: slot_(readers.slots_[readerSlot(SLOT_COUNT)]), parity_(readers.epoch_.load(std::memory_order_relaxed) & 1)
+{
+    // ordered before the loads of published pointers, so synchronize() either sees this section or the section sees the new pointers
+    slot_.active_[parity_].fetch_add(1, std::memory_order_seq_cst);
+}
+
+
+
+EpochReaders::Section::~Section()
+{
+    slot_.active_[parity_].fetch_sub(1, std::memory_order_release);
+}
+
+
+
+void EpochReaders::synchronize() noexcept
+{
+    // a section entering meanwhile may count itself under an epoch read before an earlier flip, so both parities are waited for
+    waitForParity();
+    waitForParity();
+}
+
+
+
+void EpochReaders::waitForParity() noexcept
+{
+    uint32_t parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+
+    for (auto& slot : slots_)
+    {
+        while (slot.active_[parity].load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
\ No newline at end of file
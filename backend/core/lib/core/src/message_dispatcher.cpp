@@ -0,0 +1,263 @@
+#include "core/message_dispatcher.h"
+
+using namespace aergo::core;
+
+
+
+namespace
+{
+    thread_local const MessageDispatcher* current_dispatcher = nullptr;  // set on dispatcher threads
+}
+
+
+
+MessageDispatcher::MessageDispatcher(uint32_t thread_count, uint32_t queue_capacity, logging::ILogger* logger)
+: queue_capacity_((queue_capacity > 0) ? queue_capacity : 1), logger_(logger)
+{
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    shards_.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+
+    for (auto& shard : shards_)
+    {
+        shard->thread_ = std::thread(&MessageDispatcher::dispatcherThreadFunc, this, shard.get());
+    }
+}
+
+
+
+MessageDispatcher::~MessageDispatcher()
+{
+    stop();
+}
+
+
+
+bool MessageDispatcher::dispatchMessage(const structures::RoutingTable* routing_table, const std::vector<structures::RoutingTable::Route>* routes,
+    aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept
+{
+    Task task {
+        .type_ = aergo::module::IModule::ProcessingType::MESSAGE,
+        .routes_ = routes,
+        .target_ = {},
+        .source_channel_ = source_channel,
+        .envelope_ = {}
+    };
+
+    return enqueue(std::move(task), routing_table, message);
+}
+
+
+
+bool MessageDispatcher::dispatchSingle(aergo::module::IModule::ProcessingType type, const structures::RoutingTable* routing_table, structures::RoutingTable::Route target,
+    aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept
+{
+    Task task {
+        .type_ = type,
+        .routes_ = nullptr,
+        .target_ = target,
+        .source_channel_ = source_channel,
+        .envelope_ = {}
+    };
+
+    return enqueue(std::move(task), routing_table, message);
+}
+
+
+
+bool MessageDispatcher::enqueue(Task&& task, const structures::RoutingTable* routing_table, const aergo::module::message::MessageHeader& message) noexcept
+{
+    task.envelope_ = aergo::module::message::EnvelopeRef(aergo::module::message::MessageEnvelope::create(message));
+    if (!task.envelope_)
+    {
+        log(aergo::module::logging::LogType::ERROR, "Failed to allocate message envelope, discarding message.");
+        return false;
+    }
+
+    Shard& shard = *shards_[task.source_channel_.producer_module_id_ % shards_.size()];
+
+    std::shared_ptr<const structures::RoutingTable> idle_table;   // replaced below, released after the shard mutex
+    std::unique_lock<std::mutex> lock(shard.mutex_);
+
+    if (stop_threads_)
+    {
+        return false;
+    }
+
+    if (shard.tasks_.size() >= queue_capacity_)
+    {
+        if (task.type_ == aergo::module::IModule::ProcessingType::MESSAGE)
+        {
+            lock.unlock();
+            ++dropped_count_;
+            log(aergo::module::logging::LogType::WARNING, "Dispatcher queue full, discarding message.");
+            return false;
+        }
+
+        // a dropped request would never be answered, a dropped response would leave its requester waiting
+        if (current_dispatcher != this)
+        {
+            shard.space_cv_.wait(lock, [&] { return stop_threads_ || shard.tasks_.size() < queue_capacity_; });
+            if (stop_threads_)
+            {
+                return false;
+            }
+        }
+    }
+
+    shard.tasks_.push_back(std::move(task));
+
+    if (shard.tables_.empty() || shard.tables_.back().routing_table_.get() != routing_table)
+    {
+        if (!shard.tables_.empty() && shard.tables_.back().task_count_ == 0)
+        {
+            idle_table = std::move(shard.tables_.back().routing_table_);
+            shard.tables_.pop_back();
+        }
+        shard.tables_.push_back({ .routing_table_ = routing_table->shared_from_this(), .task_count_ = 0 });
+    }
+    ++shard.tables_.back().task_count_;
+
+    lock.unlock();
+    shard.cv_.notify_one();
+
+    return true;
+}
+
+
+
+void MessageDispatcher::stop() noexcept
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex_);
+        stop_threads_ = true;
+    }
+
+    for (auto& shard : shards_)
+    {
+        shard->cv_.notify_all();
+        shard->space_cv_.notify_all();
+    }
+
+    for (auto& shard : shards_)
+    {
+        if (shard->thread_.joinable())
+        {
+            shard->thread_.join();
+        }
+
+        shard->tasks_.clear();
+        shard->tables_.clear();
+    }
+}
+
+
+
+uint64_t MessageDispatcher::droppedCount() const noexcept
+{
+    return dropped_count_;
+}
+
+
+
+void MessageDispatcher::releaseIdleTables() noexcept
+{
+    for (auto& shard : shards_)
+    {
+        std::shared_ptr<const structures::RoutingTable> idle_table;   // released after the shard mutex
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex_);
+            if (shard->tables_.size() == 1 && shard->tables_.front().task_count_ == 0)
+            {
+                idle_table = std::move(shard->tables_.front().routing_table_);
+                shard->tables_.clear();
+            }
+        }
+    }
+}
+
+
+
+std::shared_ptr<const structures::RoutingTable> MessageDispatcher::releaseDeliveredTask(Shard& shard)
+{
+    std::shared_ptr<const structures::RoutingTable> released_table;
+
+    // the last table stays while idle, so the next task of an unchanged mapping does not take a new reference
+    if (--shard.tables_.front().task_count_ == 0 && shard.tables_.size() > 1)
+    {
+        released_table = std::move(shard.tables_.front().routing_table_);
+        shard.tables_.pop_front();
+    }
+
+    return released_table;
+}
+
+
+
+void MessageDispatcher::dispatcherThreadFunc(Shard* shard)
+{
+    current_dispatcher = this;
+
+    std::unique_lock<std::mutex> lock(shard->mutex_);
+    while (!stop_threads_)
+    {
+        shard->cv_.wait(lock, [&] { return stop_threads_ || !shard->tasks_.empty(); });
+        if (stop_threads_)
+        {
+            break;
+        }
+
+        {
+            Task task = std::move(shard->tasks_.front());
+            shard->tasks_.pop_front();
+
+            lock.unlock();
+            shard->space_cv_.notify_one();
+            deliver(task);
+        }
+        lock.lock();
+
+        // task may have held the last reference to a routing table, release it (and possibly destroy modules) without the shard mutex
+        std::shared_ptr<const structures::RoutingTable> released_table = releaseDeliveredTask(*shard);
+        if (released_table)
+        {
+            lock.unlock();
+            released_table.reset();
+            lock.lock();
+        }
+    }
+}
+
+
+
+void MessageDispatcher::deliver(Task& task)
+{
+    switch (task.type_)
+    {
+        case aergo::module::IModule::ProcessingType::MESSAGE:
+            for (const auto& route : *task.routes_)
+            {
+                route.module_->processEnvelope(task.type_, route.channel_id_, task.source_channel_, task.envelope_.get());
+            }
+            break;
+        case aergo::module::IModule::ProcessingType::REQUEST:
+        case aergo::module::IModule::ProcessingType::RESPONSE:
+            task.target_.module_->processEnvelope(task.type_, task.target_.channel_id_, task.source_channel_, task.envelope_.get());
+            break;
+    }
+}
+
+
+
+void MessageDispatcher::log(aergo::module::logging::LogType log_type, const char* message)
+{
+    logger_->log(logging::SourceType::CORE, "MessageDispatcher", 0, log_type, message);
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "core/topology_tracker.h"
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+using namespace aergo::core;
+
+
+
+std::vector<aergo::module::TopologyEvent> TopologyTracker::update(const std::vector<std::shared_ptr<structures::ModuleData>>& running_modules, const structures::ModuleLoaderData* loaded_modules)
+{
+    std::vector<aergo::module::TopologyEvent> removed_connections;
+    std::vector<aergo::module::TopologyEvent> removed_modules;
+    std::vector<aergo::module::TopologyEvent> added_modules;
+    std::vector<aergo::module::TopologyEvent> added_connections;
+
+    if (modules_.size() < running_modules.size())
+    {
+        modules_.resize(running_modules.size());
+    }
+
+    for (uint64_t module_id = 0; module_id < modules_.size(); ++module_id)
+    {
+        const structures::ModuleData* module_data = (module_id < running_modules.size()) ? running_modules[module_id].get() : nullptr;
+        ModuleState& state = modules_[module_id];
+
+        if (module_data == nullptr)
+        {
+            if (state.exists_)
+            {
+                for (const Connection& connection : state.inputs_)
+                {
+                    removed_connections.push_back(connectionEvent(aergo::module::TopologyEvent::Type::CONNECTION_REMOVED, module_id, connection));
+                }
+                removed_modules.push_back(moduleEvent(aergo::module::TopologyEvent::Type::MODULE_REMOVED, module_id, 0));
+                state = ModuleState();
+            }
+            continue;
+        }
+
+        std::vector<Connection> inputs = collectInputs(module_data);
+
+        if (!state.exists_)
+        {
+            state.loaded_module_id_ = static_cast<uint64_t>(module_data->module_loader_data_ - loaded_modules);
+            added_modules.push_back(moduleEvent(aergo::module::TopologyEvent::Type::MODULE_ADDED, module_id, state.loaded_module_id_));
+            for (const Connection& connection : inputs)
+            {
+                added_connections.push_back(connectionEvent(aergo::module::TopologyEvent::Type::CONNECTION_ADDED, module_id, connection));
+            }
+        }
+        else if (inputs != state.inputs_)
+        {
+            std::vector<Connection> difference;
+            std::set_difference(state.inputs_.begin(), state.inputs_.end(), inputs.begin(), inputs.end(), std::back_inserter(difference));
+            for (const Connection& connection : difference)
+            {
+                removed_connections.push_back(connectionEvent(aergo::module::TopologyEvent::Type::CONNECTION_REMOVED, module_id, connection));
+            }
+
+            difference.clear();
+            std::set_difference(inputs.begin(), inputs.end(), state.inputs_.begin(), state.inputs_.end(), std::back_inserter(difference));
+            for (const Connection& connection : difference)
+            {
+                added_connections.push_back(connectionEvent(aergo::module::TopologyEvent::Type::CONNECTION_ADDED, module_id, connection));
+            }
+        }
+
+        state.exists_ = true;
+        state.inputs_ = std::move(inputs);
+    }
+
+    std::vector<aergo::module::TopologyEvent> events = std::move(removed_connections);
+    events.insert(events.end(), removed_modules.begin(), removed_modules.end());
+    events.insert(events.end(), added_modules.begin(), added_modules.end());
+    events.insert(events.end(), added_connections.begin(), added_connections.end());
+    return events;
+}
+
+
+
+std::vector<aergo::module::TopologyEvent> TopologyTracker::snapshot() const
+{
+    std::vector<aergo::module::TopologyEvent> events;
+
+    for (uint64_t module_id = 0; module_id < modules_.size(); ++module_id)
+    {
+        if (modules_[module_id].exists_)
+        {
+            events.push_back(moduleEvent(aergo::module::TopologyEvent::Type::MODULE_ADDED, module_id, modules_[module_id].loaded_module_id_));
+        }
+    }
+
+    for (uint64_t module_id = 0; module_id < modules_.size(); ++module_id)
+    {
+        for (const Connection& connection : modules_[module_id].inputs_)
+        {
+            events.push_back(connectionEvent(aergo::module::TopologyEvent::Type::CONNECTION_ADDED, module_id, connection));
+        }
+    }
+
+    return events;
+}
+
+
+
+bool TopologyTracker::Connection::operator<(const Connection& other) const
+{
+    return std::tie(request_, consumer_channel_id_, producer_.producer_module_id_, producer_.producer_channel_id_)
+        < std::tie(other.request_, other.consumer_channel_id_, other.producer_.producer_module_id_, other.producer_.producer_channel_id_);
+}
+
+
+
+std::vector<TopologyTracker::Connection> TopologyTracker::collectInputs(const structures::ModuleData* module_data)
+{
+    std::vector<Connection> inputs;
+
+    for (uint32_t channel_id = 0; channel_id < module_data->mapping_subscribe_.size(); ++channel_id)
+    {
+        for (auto producer : module_data->mapping_subscribe_[channel_id])
+        {
+            inputs.push_back({ .request_ = false, .consumer_channel_id_ = channel_id, .producer_ = producer });
+        }
+    }
+    for (uint32_t channel_id = 0; channel_id < module_data->mapping_request_.size(); ++channel_id)
+    {
+        for (auto producer : module_data->mapping_request_[channel_id])
+        {
+            inputs.push_back({ .request_ = true, .consumer_channel_id_ = channel_id, .producer_ = producer });
+        }
+    }
+
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+}
+
+
+
+aergo::module::TopologyEvent TopologyTracker::connectionEvent(aergo::module::TopologyEvent::Type type, uint64_t module_id, const Connection& connection)
+{
+    return {
+        .type_ = type,
+        .request_ = connection.request_,
+        .consumer_channel_id_ = connection.consumer_channel_id_,
+        .module_id_ = module_id,
+        .loaded_module_id_ = 0,
+        .producer_ = connection.producer_
+    };
+}
+
+
+
+aergo::module::TopologyEvent TopologyTracker::moduleEvent(aergo::module::TopologyEvent::Type type, uint64_t module_id, uint64_t loaded_module_id)
+{
+    return {
+        .type_ = type,
+        .request_ = false,
+        .consumer_channel_id_ = 0,
+        .module_id_ = module_id,
+        .loaded_module_id_ = loaded_module_id,
+        .producer_ = { .producer_module_id_ = 0, .producer_channel_id_ = 0 }
+    };
+}
\ No newline at end of file
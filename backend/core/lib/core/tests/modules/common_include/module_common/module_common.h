@@ -20,7 +20,11 @@ namespace aergo::tests::core_1
                 .data_ = (uint8_t*) &value,
                 .data_len_ = sizeof(value),
                 .blobs_ = nullptr,
-                .blob_count_ = 0
+                .blob_count_ = 0,
+                .id_ = 0,
+                .timestamp_ns_ = 0,
+                .success_ = true,
+                .deadline_ns_ = 0
             });
         }
 
@@ -30,7 +34,11 @@ namespace aergo::tests::core_1
                 .data_ = (uint8_t*) &value,
                 .data_len_ = sizeof(value),
                 .blobs_ = nullptr,
-                .blob_count_ = 0
+                .blob_count_ = 0,
+                .id_ = 0,
+                .timestamp_ns_ = 0,
+                .success_ = true,
+                .deadline_ns_ = 0
             });
         }
 
@@ -75,7 +83,10 @@ namespace aergo::tests::core_1
                 .data_len_ = sizeof(last_msg_data_),
                 .blobs_ = nullptr,
                 .blob_count_ = 0,
-                .success_ = true
+                .id_ = 0,
+                .timestamp_ns_ = 0,
+                .success_ = true,
+                .deadline_ns_ = 0
             });
         }
         void processResponse(uint32_t request_consumer_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept override
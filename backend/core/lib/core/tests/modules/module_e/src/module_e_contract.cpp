@@ -3,7 +3,7 @@
 #include "module_common/dll_module_wrapper.h"
 
 
-#define MODULE_API_VERSION 2
+#define MODULE_API_VERSION 19
 
 static_assert(MODULE_API_VERSION == PLUGIN_API_VERSION,
     "Incompatible plugin API version in module.");
@@ -63,7 +63,7 @@ aergo::module::dll::IDllModule* createModule(const char* data_path, ICore* core,
     auto module = std::make_unique<aergo::tests::core_1::ModuleE>(data_path, core, channel_map_info, logger, module_id);
     if (module->valid())
     {
-        return new aergo::module::dll::DllModuleWrapper(std::move(module), &module_info, logger);
+        return new aergo::module::dll::DllModuleWrapper(std::move(module), &module_info, logger, core, module_id);
     }
     else
     {
@@ -0,0 +1,429 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/core.h"
+
+#include "module_common/module_common.h"
+#include "module_common/dll_module_wrapper.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace aergo::core;
+using namespace aergo::tests::core_1;
+
+
+
+namespace
+{
+    class SilentLogger : public logging::ILogger
+    {
+    public:
+        void log(logging::SourceType source_type, const char* source_name, uint64_t source_module_id, aergo::module::logging::LogType log_type, const char* message) override {}
+    };
+
+
+
+    /// @brief Add module A (hub) and "count" modules B subscribed to its message_1 channel (SINGLE, so all depend on A).
+    /// Module E (auto-created as 0) subscribes AUTO_ALL to message_6 of all of them. Returns the hub module id.
+    uint64_t createHubGraph(Core& core, uint32_t count)
+    {
+        aergo::module::InputChannelMapInfo channel_map_info_a
+        {
+            .subscribe_consumer_info_ = nullptr,
+            .subscribe_consumer_info_count_ = 0,
+            .request_consumer_info_ = nullptr,
+            .request_consumer_info_count_ = 0
+        };
+        uint64_t hub_id = core.getCreatedModulesCount();
+        REQUIRE(core.addModule(0, channel_map_info_a) == true);
+
+        aergo::module::ChannelIdentifier channel_id_b {
+            .producer_module_id_ = hub_id,
+            .producer_channel_id_ = 1
+        };
+        aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b
+        {
+            .channel_identifier_ = &channel_id_b,
+            .channel_identifier_count_ = 1
+        };
+        aergo::module::InputChannelMapInfo channel_map_info_b
+        {
+            .subscribe_consumer_info_ = &single_channel_info_b,
+            .subscribe_consumer_info_count_ = 1,
+            .request_consumer_info_ = nullptr,
+            .request_consumer_info_count_ = 0
+        };
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            REQUIRE(core.addModule(1, channel_map_info_b) == true);
+        }
+
+        return hub_id;
+    }
+
+
+
+    /// @brief Batch adding module A (hub) and "count" modules B mapped to it.
+    struct HubBatch
+    {
+        HubBatch(uint64_t hub_id, uint32_t count)
+        : channel_id_b_ { .producer_module_id_ = hub_id, .producer_channel_id_ = 1 },
+          single_channel_info_b_ { .channel_identifier_ = &channel_id_b_, .channel_identifier_count_ = 1 }
+        {
+            adds_.push_back({ .loaded_module_id_ = 0, .channel_map_info_ = { nullptr, 0, nullptr, 0 } });
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                adds_.push_back({ .loaded_module_id_ = 1, .channel_map_info_ = { &single_channel_info_b_, 1, nullptr, 0 } });
+            }
+        }
+
+        aergo::module::ModuleBatch batch(std::vector<uint64_t>& remove_ids, bool recursive_remove)
+        {
+            return {
+                .remove_ids_ = remove_ids.data(),
+                .remove_count_ = (uint32_t)remove_ids.size(),
+                .recursive_remove_ = recursive_remove,
+                .adds_ = adds_.data(),
+                .add_count_ = (uint32_t)adds_.size()
+            };
+        }
+
+        aergo::module::ChannelIdentifier channel_id_b_;
+        aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b_;
+        std::vector<aergo::module::ModuleBatch::Add> adds_;
+    };
+
+
+
+    ModuleCommon* runningModule(Core& core, uint64_t module_id)
+    {
+        return (ModuleCommon*) ((aergo::module::dll::DllModuleWrapper*)(core.getCreatedModulesInfo(module_id)->module_.get()))->getModule();
+    }
+
+
+
+    void publishValue(Core& core, aergo::module::IPublishHandle* publish_handle, int value)
+    {
+        core.sendMessage(publish_handle, {
+            .data_ = (uint8_t*) &value,
+            .data_len_ = sizeof(value),
+            .blobs_ = nullptr,
+            .blob_count_ = 0,
+            .id_ = 0,
+            .timestamp_ns_ = 0,
+            .success_ = true,
+            .deadline_ns_ = 0
+        });
+    }
+
+
+
+    /// @brief Wait up to a second for "module" to receive message "value".
+    bool waitForMessage(ModuleCommon* module, int value)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (module->last_msg_type_ == ModuleCommon::msg_type::MESSAGE && module->last_msg_data_ == value)
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+}
+
+
+
+TEST_CASE( "Core dependency removal", "[core_module_removal]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    constexpr uint32_t MODULE_COUNT = 50;
+    uint64_t first_hub_id = createHubGraph(core, MODULE_COUNT);
+    uint64_t second_hub_id = createHubGraph(core, MODULE_COUNT);
+
+    auto dependent_modules = core.collectDependentModules(first_hub_id);
+    REQUIRE(dependent_modules.size() == MODULE_COUNT + 1);
+    REQUIRE(dependent_modules.front() == first_hub_id);
+    REQUIRE(dependent_modules.back() == first_hub_id + MODULE_COUNT);
+    REQUIRE(core.collectDependentModules(first_hub_id + 1).size() == 1);
+    REQUIRE(core.collectDependentModules(0).size() == 1);
+
+    // E subscribes AUTO_ALL to message_6 of A and all B modules
+    REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == 2 * (MODULE_COUNT + 1));
+
+    REQUIRE(core.removeModule(first_hub_id, false) == Core::RemoveResult::HAS_DEPENDENCIES);
+    REQUIRE(core.removeModule(first_hub_id + 1, false) == Core::RemoveResult::SUCCESS);
+    REQUIRE(core.collectDependentModules(first_hub_id).size() == MODULE_COUNT);
+    REQUIRE(core.removeModule(first_hub_id, true) == Core::RemoveResult::SUCCESS);
+
+    for (uint64_t module_id = first_hub_id; module_id <= first_hub_id + MODULE_COUNT; ++module_id)
+    {
+        REQUIRE(core.getCreatedModulesInfo(module_id) == nullptr);
+    }
+
+    // remaining connections keep their order
+    auto& e_subscribe = core.getCreatedModulesInfo(0)->mapping_subscribe_[0];
+    REQUIRE(e_subscribe.size() == MODULE_COUNT + 1);
+    for (uint32_t i = 0; i <= MODULE_COUNT; ++i)
+    {
+        REQUIRE(e_subscribe[i].producer_module_id_ == second_hub_id + i);
+    }
+    REQUIRE(core.getExistingPublishChannels("message_6/v1:int").size() == MODULE_COUNT + 1);
+    REQUIRE(core.getCreatedModulesInfo(second_hub_id)->mapping_publish_[1].size() == MODULE_COUNT);
+    REQUIRE(core.collectDependentModules(second_hub_id).size() == MODULE_COUNT + 1);
+
+    REQUIRE(core.removeModule(second_hub_id, true) == Core::RemoveResult::SUCCESS);
+    REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == 0);
+    REQUIRE(core.getExistingPublishChannels("message_6/v1:int").size() == 0);
+}
+
+
+
+TEST_CASE( "Core dependency removal benchmark", "[.][benchmark][core_module_removal]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    constexpr uint32_t MODULE_COUNT = 1000;
+    uint64_t hub_id = createHubGraph(core, MODULE_COUNT);
+
+    constexpr int ITERATIONS = 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        REQUIRE(core.collectDependentModules(hub_id).size() == MODULE_COUNT + 1);
+    }
+    double collect_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+
+    start = std::chrono::steady_clock::now();
+    REQUIRE(core.removeModule(hub_id, true) == Core::RemoveResult::SUCCESS);
+    double remove_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << MODULE_COUNT << " dependent modules: collect " << collect_us << " us, recursive remove " << remove_ms << " ms" << std::endl;
+    REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == 0);
+}
+
+
+
+TEST_CASE( "Core module batch", "[core_module_batch]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    constexpr uint32_t MODULE_COUNT = 10;
+    std::vector<uint64_t> no_removals;
+
+    uint64_t first_hub_id = core.getCreatedModulesCount();
+    HubBatch first_batch(first_hub_id, MODULE_COUNT);
+    uint64_t state_id = core.getModulesMappingStateId();
+    REQUIRE(core.applyModuleBatch(first_batch.batch(no_removals, false)) == true);
+    REQUIRE(core.getModulesMappingStateId() == state_id + 1);
+    REQUIRE(core.getCreatedModulesCount() == first_hub_id + MODULE_COUNT + 1);
+    REQUIRE(core.collectDependentModules(first_hub_id).size() == MODULE_COUNT + 1);
+    REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == MODULE_COUNT + 1);
+
+    SECTION("rejected batch changes nothing")
+    {
+        uint64_t second_hub_id = core.getCreatedModulesCount();
+        HubBatch invalid_batch(second_hub_id, MODULE_COUNT);
+        invalid_batch.adds_.back().loaded_module_id_ = 100;
+        std::vector<uint64_t> removals { first_hub_id };
+
+        // discarded modules do not leave their account to the next module with the same ID
+        core.setModuleMemoryQuota(second_hub_id, 1000);
+
+        state_id = core.getModulesMappingStateId();
+        REQUIRE(core.applyModuleBatch(invalid_batch.batch(removals, true)) == false);
+        REQUIRE(core.getModuleMemoryStats(second_hub_id).quota_bytes_ == 0);
+
+        // B modules map a module that does not exist
+        HubBatch missing_producer_batch(second_hub_id + MODULE_COUNT + 5, MODULE_COUNT);
+        REQUIRE(core.applyModuleBatch(missing_producer_batch.batch(removals, true)) == false);
+
+        // first hub has dependencies not in the batch
+        HubBatch valid_batch(second_hub_id, MODULE_COUNT);
+        REQUIRE(core.applyModuleBatch(valid_batch.batch(removals, false)) == false);
+
+        // added modules cannot map removed ones
+        HubBatch removed_producer_batch(first_hub_id, MODULE_COUNT);
+        REQUIRE(core.applyModuleBatch(removed_producer_batch.batch(removals, true)) == false);
+
+        REQUIRE(core.getModulesMappingStateId() == state_id);
+        REQUIRE(core.getCreatedModulesCount() == second_hub_id);
+        REQUIRE(core.collectDependentModules(first_hub_id).size() == MODULE_COUNT + 1);
+        REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == MODULE_COUNT + 1);
+        REQUIRE(core.getCreatedModulesInfo(first_hub_id)->mapping_publish_[1].size() == MODULE_COUNT);
+        REQUIRE(core.getExistingPublishChannels("message_6/v1:int").size() == MODULE_COUNT + 1);
+    }
+
+    SECTION("replace modules")
+    {
+        uint64_t second_hub_id = core.getCreatedModulesCount();
+        HubBatch second_batch(second_hub_id, MODULE_COUNT);
+
+        // all dependents listed, no recursion needed
+        std::vector<uint64_t> removals;
+        for (uint64_t module_id = first_hub_id; module_id <= first_hub_id + MODULE_COUNT; ++module_id)
+        {
+            removals.push_back(module_id);
+        }
+
+        // allocator not deleted by the removed hub keeps charging its old account
+        core.setModuleMemoryQuota(first_hub_id, 1000);
+        aergo::module::IAllocator* hub_allocator = core.createDynamicAllocator(first_hub_id, {});
+        REQUIRE(hub_allocator != nullptr);
+        auto hub_blob = hub_allocator->allocate(500);
+        REQUIRE(hub_blob.valid());
+
+        state_id = core.getModulesMappingStateId();
+        REQUIRE(core.applyModuleBatch(second_batch.batch(removals, false)) == true);
+        REQUIRE(core.getModulesMappingStateId() == state_id + 1);
+
+        REQUIRE(core.getModuleMemoryStats(first_hub_id).quota_bytes_ == 0);
+        REQUIRE(core.getModuleMemoryStats(first_hub_id).live_bytes_ == 0);
+        REQUIRE(*reinterpret_cast<uint64_t*>(core.getModuleAllocatorsMemoryStats(first_hub_id).data()) == 0);
+        REQUIRE(!hub_allocator->allocate(600).valid());
+        hub_blob = aergo::module::message::SharedDataBlob();
+        core.deleteAllocator(hub_allocator);
+
+        for (uint64_t module_id : removals)
+        {
+            REQUIRE(core.getCreatedModulesInfo(module_id) == nullptr);
+        }
+        REQUIRE(core.collectDependentModules(second_hub_id).size() == MODULE_COUNT + 1);
+
+        auto& e_subscribe = core.getCreatedModulesInfo(0)->mapping_subscribe_[0];
+        REQUIRE(e_subscribe.size() == MODULE_COUNT + 1);
+        for (uint32_t i = 0; i <= MODULE_COUNT; ++i)
+        {
+            REQUIRE(e_subscribe[i].producer_module_id_ == second_hub_id + i);
+        }
+
+        std::vector<uint64_t> hub_removal { second_hub_id };
+        HubBatch empty_batch(0, 0);
+        empty_batch.adds_.clear();
+        REQUIRE(core.applyModuleBatch(empty_batch.batch(hub_removal, true)) == true);
+        REQUIRE(core.getCreatedModulesInfo(0)->mapping_subscribe_[0].size() == 0);
+        REQUIRE(core.getExistingPublishChannels("message_6/v1:int").size() == 0);
+    }
+}
+
+
+
+TEST_CASE( "Core module batch benchmark", "[.][benchmark][core_module_batch]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    constexpr uint32_t MODULE_COUNT = 39;   // 40 module pipeline with the hub
+    std::vector<uint64_t> no_removals;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t hub_id = createHubGraph(core, MODULE_COUNT);
+    double single_add_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    REQUIRE(core.removeModule(hub_id, true) == Core::RemoveResult::SUCCESS);
+    double single_remove_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    hub_id = core.getCreatedModulesCount();
+    HubBatch add_batch(hub_id, MODULE_COUNT);
+    start = std::chrono::steady_clock::now();
+    REQUIRE(core.applyModuleBatch(add_batch.batch(no_removals, false)) == true);
+    double batch_add_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<uint64_t> hub_removal { hub_id };
+    HubBatch remove_batch(0, 0);
+    remove_batch.adds_.clear();
+    start = std::chrono::steady_clock::now();
+    REQUIRE(core.applyModuleBatch(remove_batch.batch(hub_removal, true)) == true);
+    double batch_remove_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << MODULE_COUNT + 1 << " modules: addModule " << single_add_ms << " ms, recursive removeModule " << single_remove_ms
+        << " ms, batch add " << batch_add_ms << " ms, batch remove " << batch_remove_ms << " ms" << std::endl;
+}
+
+
+
+TEST_CASE( "Core publish handle", "[core_publish_handle]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    uint64_t hub_id = createHubGraph(core, 1);
+    uint64_t first_b_id = hub_id + 1;
+
+    REQUIRE(core.getPublishHandle({ .producer_module_id_ = hub_id, .producer_channel_id_ = 2 }) == nullptr);
+    REQUIRE(core.getPublishHandle({ .producer_module_id_ = core.getCreatedModulesCount(), .producer_channel_id_ = 0 }) == nullptr);
+
+    // message_1 of the hub
+    aergo::module::IPublishHandle* publish_handle = core.getPublishHandle({ .producer_module_id_ = hub_id, .producer_channel_id_ = 1 });
+    REQUIRE(publish_handle != nullptr);
+    REQUIRE(core.getPublishHandle({ .producer_module_id_ = hub_id, .producer_channel_id_ = 1 }) == publish_handle);
+
+    publishValue(core, publish_handle, 1);
+    REQUIRE(waitForMessage(runningModule(core, first_b_id), 1));
+
+    // the handle follows mapping changes
+    aergo::module::ChannelIdentifier channel_id_b { .producer_module_id_ = hub_id, .producer_channel_id_ = 1 };
+    aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b { .channel_identifier_ = &channel_id_b, .channel_identifier_count_ = 1 };
+    uint64_t second_b_id = core.getCreatedModulesCount();
+    REQUIRE(core.addModule(1, { &single_channel_info_b, 1, nullptr, 0 }) == true);
+
+    publishValue(core, publish_handle, 2);
+    REQUIRE(waitForMessage(runningModule(core, first_b_id), 2));
+    REQUIRE(waitForMessage(runningModule(core, second_b_id), 2));
+
+    REQUIRE(core.removeModule(first_b_id, false) == Core::RemoveResult::SUCCESS);
+    publishValue(core, publish_handle, 3);
+    REQUIRE(waitForMessage(runningModule(core, second_b_id), 3));
+
+    REQUIRE(core.removeModule(second_b_id, false) == Core::RemoveResult::SUCCESS);
+    publishValue(core, publish_handle, 4);
+    REQUIRE(core.removeModule(hub_id, false) == Core::RemoveResult::SUCCESS);
+}
+
+
+
+TEST_CASE( "Core publish handle during mapping changes", "[core_publish_handle]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    uint64_t hub_id = createHubGraph(core, 0);
+    aergo::module::IPublishHandle* publish_handle = core.getPublishHandle({ .producer_module_id_ = hub_id, .producer_channel_id_ = 1 });
+    REQUIRE(publish_handle != nullptr);
+
+    // subscribers come and go under a sender that never stops
+    std::atomic<bool> stop = false;
+    std::thread sender([&] {
+        for (int value = 0; !stop; ++value)
+        {
+            publishValue(core, publish_handle, value);
+        }
+    });
+
+    aergo::module::ChannelIdentifier channel_id_b { .producer_module_id_ = hub_id, .producer_channel_id_ = 1 };
+    aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b { .channel_identifier_ = &channel_id_b, .channel_identifier_count_ = 1 };
+    for (int i = 0; i < 20; ++i)
+    {
+        uint64_t b_id = core.getCreatedModulesCount();
+        REQUIRE(core.addModule(1, { &single_channel_info_b, 1, nullptr, 0 }) == true);
+        REQUIRE(core.removeModule(b_id, false) == Core::RemoveResult::SUCCESS);
+    }
+
+    stop = true;
+    sender.join();
+    REQUIRE(core.removeModule(hub_id, false) == Core::RemoveResult::SUCCESS);
+}
\ No newline at end of file
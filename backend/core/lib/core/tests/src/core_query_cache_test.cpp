@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/core.h"
+
+using namespace aergo::core;
+using Type = aergo::module::TopologyEvent::Type;
+
+
+
+namespace
+{
+    class SilentLogger : public logging::ILogger
+    {
+    public:
+        void log(logging::SourceType source_type, const char* source_name, uint64_t source_module_id, aergo::module::logging::LogType log_type, const char* message) override {}
+    };
+}
+
+
+
+TEST_CASE( "Cached control queries", "[core_query_cache]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    aergo::module::InputChannelMapInfo channel_map_info_a { nullptr, 0, nullptr, 0 };
+    REQUIRE(core.addModule(0, channel_map_info_a) == true);
+
+    aergo::module::ChannelIdentifier channel_id_b { .producer_module_id_ = 1, .producer_channel_id_ = 1 };
+    aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b { .channel_identifier_ = &channel_id_b, .channel_identifier_count_ = 1 };
+    aergo::module::InputChannelMapInfo channel_map_info_b { &single_channel_info_b, 1, nullptr, 0 };
+    REQUIRE(core.addModule(1, channel_map_info_b) == true);
+
+    SECTION("results are shared until the mapping changes")
+    {
+        aergo::module::RunningModuleInfo info = core.getRunningModulesInfo(2);
+        aergo::module::message::SharedDataBlob dependencies = core.collectDependencies(1);
+        aergo::module::message::SharedDataBlob snapshot = core.getTopologySnapshot();
+        REQUIRE(info.channel_map_.valid());
+        REQUIRE(dependencies.valid());
+        REQUIRE(snapshot.valid());
+
+        REQUIRE(core.getRunningModulesInfo(2).channel_map_.data() == info.channel_map_.data());
+        REQUIRE(core.collectDependencies(1).data() == dependencies.data());
+        REQUIRE(core.getTopologySnapshot().data() == snapshot.data());
+
+        REQUIRE(core.removeModule(2, false) == Core::RemoveResult::SUCCESS);
+
+        REQUIRE_FALSE(core.getRunningModulesInfo(2).exists_);
+        aergo::module::message::SharedDataBlob new_dependencies = core.collectDependencies(1);
+        REQUIRE(new_dependencies.data() != dependencies.data());
+        REQUIRE(reinterpret_cast<uint64_t*>(dependencies.data())[0] == 2);
+        REQUIRE(reinterpret_cast<uint64_t*>(new_dependencies.data())[0] == 1);
+        REQUIRE(core.getTopologySnapshot().data() != snapshot.data());
+    }
+
+    SECTION("shared results are read-only")
+    {
+        aergo::module::message::SharedDataBlob dependencies = core.collectDependencies(1);
+        aergo::module::message::SharedDataBlob snapshot = core.getTopologySnapshot();
+        REQUIRE(dependencies.valid());
+        REQUIRE(snapshot.valid());
+        REQUIRE_FALSE(dependencies.unique());
+        REQUIRE_FALSE(snapshot.unique());
+
+        // writable copies, the cached blobs keep their data
+        aergo::module::message::SharedDataBlob writable_dependencies = dependencies;
+        aergo::module::message::SharedDataBlob writable_snapshot = snapshot;
+        REQUIRE(writable_dependencies.makeWritable());
+        REQUIRE(writable_snapshot.makeWritable());
+        REQUIRE(writable_dependencies.data() != dependencies.data());
+        REQUIRE(writable_snapshot.data() != snapshot.data());
+        reinterpret_cast<uint64_t*>(writable_dependencies.data())[0] = 100;
+        reinterpret_cast<aergo::module::TopologyChange*>(writable_snapshot.data())->event_count_ = 100;
+
+        aergo::module::message::SharedDataBlob cached_dependencies = core.collectDependencies(1);
+        aergo::module::message::SharedDataBlob cached_snapshot = core.getTopologySnapshot();
+        REQUIRE(cached_dependencies.data() == dependencies.data());
+        REQUIRE(cached_snapshot.data() == snapshot.data());
+        REQUIRE(reinterpret_cast<uint64_t*>(cached_dependencies.data())[0] == 2);
+        REQUIRE(reinterpret_cast<aergo::module::TopologyChange*>(cached_snapshot.data())->event_count_ == 6);
+    }
+
+    SECTION("topology snapshot")
+    {
+        aergo::module::message::SharedDataBlob snapshot = core.getTopologySnapshot();
+        REQUIRE(snapshot.valid());
+
+        auto header = reinterpret_cast<aergo::module::TopologyChange*>(snapshot.data());
+        auto events = reinterpret_cast<aergo::module::TopologyEvent*>(snapshot.data() + sizeof(aergo::module::TopologyChange));
+        REQUIRE(header->previous_state_id_ == 0);
+        REQUIRE(header->state_id_ == core.getModulesMappingStateId());
+        REQUIRE(header->event_count_ == 6);
+        REQUIRE(snapshot.size() == sizeof(aergo::module::TopologyChange) + 6 * sizeof(aergo::module::TopologyEvent));
+
+        REQUIRE(events[0].type_ == Type::MODULE_ADDED);
+        REQUIRE(events[0].module_id_ == 0);
+        REQUIRE(events[0].loaded_module_id_ == 4);
+        REQUIRE(events[1].type_ == Type::MODULE_ADDED);
+        REQUIRE(events[1].module_id_ == 1);
+        REQUIRE(events[1].loaded_module_id_ == 0);
+        REQUIRE(events[2].type_ == Type::MODULE_ADDED);
+        REQUIRE(events[2].module_id_ == 2);
+        REQUIRE(events[2].loaded_module_id_ == 1);
+
+        REQUIRE(events[3].type_ == Type::CONNECTION_ADDED);
+        REQUIRE(events[3].module_id_ == 0);
+        REQUIRE(events[3].producer_ == aergo::module::ChannelIdentifier{1, 0});
+        REQUIRE(events[4].type_ == Type::CONNECTION_ADDED);
+        REQUIRE(events[4].module_id_ == 0);
+        REQUIRE(events[4].producer_ == aergo::module::ChannelIdentifier{2, 0});
+        REQUIRE(events[5].type_ == Type::CONNECTION_ADDED);
+        REQUIRE(events[5].module_id_ == 2);
+        REQUIRE(events[5].producer_ == aergo::module::ChannelIdentifier{1, 1});
+    }
+}
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "module_common/dll_module_wrapper.h"
 
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
 
 using namespace aergo::core;
 using namespace aergo::core::logging;
@@ -40,6 +42,25 @@ TEST_CASE( "Core Test 1", "[core_test_1]" )
         REQUIRE(core.getExistingResponseChannels("message_6/v1:int").size() == 0);
     }
 
+    SECTION("Startup report")
+    {
+        auto report = core.getStartupReport();
+        REQUIRE(report.modules_.size() == 5);
+        // loaded in file name order
+        const char* module_names[] = { "module_a", "module_b", "module_c", "module_d", "module_e" };
+        for (uint64_t loaded_module_id = 0; loaded_module_id < report.modules_.size(); ++loaded_module_id)
+        {
+            REQUIRE(report.modules_[loaded_module_id].module_name_.ends_with(module_names[loaded_module_id]));
+            REQUIRE(report.modules_[loaded_module_id].load_ns_ > 0);
+        }
+
+        // only module E is auto-created
+        REQUIRE(report.modules_[4].create_ns_ > 0);
+        REQUIRE(report.modules_[4].start_ns_ > 0);
+        REQUIRE(report.modules_[0].create_ns_ == 0);
+        REQUIRE(report.total_ns_ >= report.load_ns_ + report.create_ns_ + report.start_ns_);
+    }
+
     SECTION("Add non-existing module")
     {
         aergo::module::InputChannelMapInfo channel_map_info
@@ -2077,4 +2098,94 @@ TEST_CASE( "Core Test 1", "[core_test_1]" )
 
         
     }
+}
+
+
+
+TEST_CASE( "Core memory accounting", "[core_test_1]" )
+{
+    ConsoleLogger logger;
+    Core core(&logger);
+
+    REQUIRE(core.getModuleMemoryStats(7).live_bytes_ == 0);
+
+    aergo::module::IAllocator* dynamic_allocator = core.createDynamicAllocator(7, {});
+    aergo::module::IAllocator* buffer_allocator = core.createBufferAllocator(7, 1000, 4, {});
+    aergo::module::IAllocator* other_allocator = core.createDynamicAllocator(8, {});
+    REQUIRE(dynamic_allocator != nullptr);
+    REQUIRE(buffer_allocator != nullptr);
+    REQUIRE(other_allocator != nullptr);
+
+    {
+        auto blob = dynamic_allocator->allocate(500);
+        auto slot = buffer_allocator->allocate(0);
+        auto other_blob = other_allocator->allocate(100);
+        REQUIRE(blob.valid());
+        REQUIRE(slot.valid());
+
+        aergo::module::MemoryStats stats = core.getModuleMemoryStats(7);
+        REQUIRE(stats.live_bytes_ == 1500);
+        REQUIRE(stats.reserved_bytes_ == 4500);
+        REQUIRE(stats.allocation_count_ == 2);
+        REQUIRE(core.getModuleMemoryStats(8).live_bytes_ == 100);
+
+        auto allocator_stats = core.getModuleAllocatorsMemoryStats(7);
+        REQUIRE(allocator_stats.valid());
+        REQUIRE(*reinterpret_cast<uint64_t*>(allocator_stats.data()) == 2);
+        auto* per_allocator = reinterpret_cast<aergo::module::MemoryStats*>(allocator_stats.data() + sizeof(uint64_t));
+        REQUIRE(per_allocator[0].live_bytes_ == 500);
+        REQUIRE(per_allocator[1].live_bytes_ == 1000);
+        REQUIRE(per_allocator[1].reserved_bytes_ == 4000);
+
+        // quota makes allocations fail fast
+        core.setModuleMemoryQuota(7, 2000);
+        REQUIRE(!dynamic_allocator->allocate(600).valid());
+        REQUIRE(dynamic_allocator->allocate(400).valid());
+        REQUIRE(core.getModuleMemoryStats(7).failed_count_ == 1);
+        REQUIRE(core.getModuleMemoryStats(7).peak_live_bytes_ == 1900);
+        REQUIRE(other_allocator->allocate(10000).valid());
+    }
+
+    REQUIRE(core.getModuleMemoryStats(7).live_bytes_ == 0);
+
+    core.deleteAllocator(buffer_allocator);
+    REQUIRE(core.getModuleMemoryStats(7).reserved_bytes_ == 0);
+    REQUIRE(*reinterpret_cast<uint64_t*>(core.getModuleAllocatorsMemoryStats(7).data()) == 1);
+
+    core.deleteAllocator(dynamic_allocator);
+    core.deleteAllocator(other_allocator);
+}
+
+
+
+TEST_CASE( "Core mapped file allocator", "[core_test_1]" )
+{
+    ConsoleLogger logger;
+    Core core(&logger);
+    std::string path = (std::filesystem::temp_directory_path() / "aergo_core_mapped_file_test.bin").string();
+
+    REQUIRE(core.createMappedFileAllocator(7, (path + ".missing").c_str(), { .read_only_ = true }) == nullptr);
+
+    aergo::module::IAllocator* writer = core.createMappedFileAllocator(7, path.c_str(), { .capacity_bytes_ = 1024 * 1024 });
+    REQUIRE(writer != nullptr);
+    {
+        auto blob = writer->allocate(1000);
+        REQUIRE(blob.valid());
+        std::memset(blob.data(), 7, blob.size());
+        REQUIRE(core.getModuleMemoryStats(7).live_bytes_ == 1000);
+    }
+    core.deleteAllocator(writer);
+
+    aergo::module::IAllocator* reader = core.createMappedFileAllocator(7, path.c_str(), { .read_only_ = true });
+    REQUIRE(reader != nullptr);
+    {
+        auto blob = reader->allocate(0);
+        REQUIRE(blob.valid());
+        REQUIRE(blob.size() == 1000);
+        REQUIRE(blob.data()[999] == 7);
+        REQUIRE(!reader->allocate(0).valid());
+    }
+    core.deleteAllocator(reader);
+
+    std::filesystem::remove(path);
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/dependency_graph.h"
+
+#include <vector>
+
+using namespace aergo::core;
+
+
+
+TEST_CASE( "DependencyGraph", "[dependency_graph]" )
+{
+    DependencyGraph graph;
+
+    // 1 <- 2 <- 4, 1 <- 3 <- 4, 3 <- 5
+    graph.addDependency(1, 2);
+    graph.addDependency(1, 3);
+    graph.addDependency(2, 4);
+    graph.addDependency(3, 4);
+    graph.addDependency(3, 5);
+    graph.addDependency(3, 5);
+
+    REQUIRE(graph.dependentCount(1) == 2);
+    REQUIRE(graph.dependentCount(3) == 2);
+    REQUIRE(graph.dependentCount(5) == 0);
+    REQUIRE(graph.dependentCount(100) == 0);
+
+    REQUIRE(graph.collectDependents(1) == std::vector<uint64_t>{ 1, 2, 3, 4, 5 });
+    REQUIRE(graph.collectDependents(3) == std::vector<uint64_t>{ 3, 4, 5 });
+    REQUIRE(graph.collectDependents(4) == std::vector<uint64_t>{ 4 });
+    REQUIRE(graph.collectDependents(0) == std::vector<uint64_t>{ 0 });
+    REQUIRE(graph.collectDependents(100) == std::vector<uint64_t>{ 100 });
+
+    graph.removeModule(3);
+    REQUIRE(graph.dependentCount(1) == 1);
+    REQUIRE(graph.collectDependents(1) == std::vector<uint64_t>{ 1, 2, 4 });
+    REQUIRE(graph.collectDependents(3) == std::vector<uint64_t>{ 3 });
+    REQUIRE(graph.collectDependents(5) == std::vector<uint64_t>{ 5 });
+
+    graph.removeModule(4);
+    graph.removeModule(2);
+    REQUIRE(graph.dependentCount(1) == 0);
+    REQUIRE(graph.collectDependents(1) == std::vector<uint64_t>{ 1 });
+}
\ No newline at end of file
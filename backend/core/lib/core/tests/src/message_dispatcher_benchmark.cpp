@@ -0,0 +1,342 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "core/message_dispatcher.h"
+
+#include <functional>
+#include <string>
+
+using namespace aergo::core;
+
+
+
+namespace
+{
+    class SilentLogger : public logging::ILogger
+    {
+    public:
+        void log(logging::SourceType source_type, const char* source_name, uint64_t source_module_id, aergo::module::logging::LogType log_type, const char* message) override {}
+    };
+
+
+
+    /// @brief Subscriber with the same ingress cost profile as DllModuleWrapper (lock own mutex, keep the message).
+    class FakeSubscriber : public aergo::module::dll::IDllModule
+    {
+    public:
+        void processMessage(uint32_t subscribe_consumer_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept override { ingress(message); }
+        void processRequest(uint32_t response_producer_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept override { ingress(message); }
+        void processResponse(uint32_t request_consumer_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageHeader message) noexcept override { ingress(message); }
+        bool threadStart(uint32_t timeout_ms) noexcept override { return true; }
+        bool threadStop(uint32_t timeout_ms) noexcept override { return true; }
+
+        void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageEnvelope* envelope) noexcept override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            envelope->addRef();
+            last_envelope_ = aergo::module::message::EnvelopeRef(envelope);
+            ++received_;
+        }
+
+    private:
+        /// @brief Ingress of a receiver that copies the payload (before shared envelopes).
+        void ingress(const aergo::module::message::MessageHeader& message)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last_data_.assign(message.data_, message.data_ + message.data_len_);
+            ++received_;
+        }
+
+        std::mutex mutex_;
+        std::vector<uint8_t> last_data_;
+        aergo::module::message::EnvelopeRef last_envelope_;
+        uint64_t received_ = 0;
+    };
+
+
+
+    std::shared_ptr<const structures::RoutingTable> buildRoutingTable(std::vector<FakeSubscriber>& subscribers)
+    {
+        auto routing_table = std::make_shared<structures::RoutingTable>();
+        routing_table->modules_.resize(1);
+        routing_table->modules_[0].publish_.resize(1);
+        for (auto& subscriber : subscribers)
+        {
+            routing_table->modules_[0].publish_[0].routes_.push_back({ &subscriber, 0 });
+        }
+        return routing_table;
+    }
+}
+
+
+
+TEST_CASE( "MessageDispatcher producer latency", "[.][benchmark][message_dispatcher]" )
+{
+    SilentLogger logger;
+    std::vector<uint8_t> payload(256, 42);
+
+    aergo::module::message::MessageHeader message { .data_ = payload.data(), .data_len_ = payload.size(), .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+
+    aergo::module::ChannelIdentifier source_channel { .producer_module_id_ = 0, .producer_channel_id_ = 0 };
+
+    for (uint32_t subscriber_count : { 1, 8, 64 })
+    {
+        std::vector<FakeSubscriber> subscribers(subscriber_count);
+        std::shared_ptr<const structures::RoutingTable> routing_table = buildRoutingTable(subscribers);
+        const auto* routes = &routing_table->modules_[0].publish_[0].routes_;
+
+        BENCHMARK("inline fan-out, " + std::to_string(subscriber_count) + " subscribers")
+        {
+            for (const auto& route : *routes)
+            {
+                route.module_->processMessage(route.channel_id_, source_channel, message);
+            }
+        };
+
+        MessageDispatcher dispatcher(1, 1 << 20, &logger);
+        BENCHMARK("dispatched publish, " + std::to_string(subscriber_count) + " subscribers")
+        {
+            return dispatcher.dispatchMessage(routing_table.get(), routes, source_channel, message);
+        };
+        dispatcher.stop();
+    }
+}
+
+
+
+TEST_CASE( "MessageDispatcher ordering", "[message_dispatcher]" )
+{
+    SilentLogger logger;
+
+    class OrderCheckingSubscriber : public FakeSubscriber
+    {
+    public:
+        void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageEnvelope* envelope) noexcept override
+        {
+            const aergo::module::message::MessageHeader& message = envelope->message();
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_order_ = in_order_ && (message.id_ == next_id_[source_channel.producer_module_id_]);
+            next_id_[source_channel.producer_module_id_] = message.id_ + 1;
+            ++received_;
+        }
+
+        std::mutex mutex_;
+        bool in_order_ = true;
+        uint64_t next_id_[4] = { 0, 0, 0, 0 };
+        uint64_t received_ = 0;
+    };
+
+    std::vector<OrderCheckingSubscriber> subscribers(3);
+    auto routing_table = std::make_shared<structures::RoutingTable>();
+    routing_table->modules_.resize(4);
+    for (auto& module_routes : routing_table->modules_)
+    {
+        module_routes.publish_.resize(1);
+        for (auto& subscriber : subscribers)
+        {
+            module_routes.publish_[0].routes_.push_back({ &subscriber, 0 });
+        }
+    }
+
+    uint64_t message_count = 1000;
+    {
+        MessageDispatcher dispatcher(2, 1 << 16, &logger);
+
+        for (uint64_t id = 0; id < message_count; ++id)
+        {
+            for (uint64_t producer = 0; producer < 4; ++producer)
+            {
+                aergo::module::message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = id, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+                REQUIRE(dispatcher.dispatchMessage(routing_table.get(), &routing_table->modules_[producer].publish_[0].routes_, { .producer_module_id_ = producer, .producer_channel_id_ = 0 }, message));
+            }
+        }
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            bool done = true;
+            for (auto& subscriber : subscribers)
+            {
+                std::lock_guard<std::mutex> lock(subscriber.mutex_);
+                done = done && (subscriber.received_ == 4 * message_count);
+            }
+            if (done)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(dispatcher.droppedCount() == 0);
+    }
+
+    for (auto& subscriber : subscribers)
+    {
+        REQUIRE(subscriber.received_ == 4 * message_count);
+        REQUIRE(subscriber.in_order_);
+    }
+}
+
+
+TEST_CASE( "MessageDispatcher full queue", "[message_dispatcher]" )
+{
+    SilentLogger logger;
+
+    /// @brief Blocks the dispatcher thread in its first delivery until opened. Optionally sends a response from the delivery.
+    class GatedModule : public FakeSubscriber
+    {
+    public:
+        void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageEnvelope* envelope) noexcept override
+        {
+            std::function<void()> respond = std::move(respond_);
+            respond_ = nullptr;
+            if (respond)
+            {
+                respond();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++received_;
+            cv_.notify_all();
+            cv_.wait(lock, [this] { return open_; });
+        }
+
+        void open()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+            cv_.notify_all();
+        }
+
+        bool waitReceived(uint64_t count)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return cv_.wait_for(lock, std::chrono::seconds(5), [this, count] { return received_ >= count; });
+        }
+
+        std::function<void()> respond_;
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool open_ = false;
+        uint64_t received_ = 0;
+    };
+
+    GatedModule module;
+    auto routing_table = std::make_shared<structures::RoutingTable>();
+    routing_table->modules_.resize(1);
+    routing_table->modules_[0].publish_.push_back({ .table_ = routing_table.get(), .routes_ = { { &module, 0 } } });
+    const auto* routes = &routing_table->modules_[0].publish_[0].routes_;
+    structures::RoutingTable::Route target { &module, 0 };
+
+    aergo::module::ChannelIdentifier source_channel { .producer_module_id_ = 0, .producer_channel_id_ = 0 };
+    aergo::module::message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+
+    MessageDispatcher dispatcher(1, 1, &logger);
+
+    // first task is being delivered, second fills the queue
+    REQUIRE(dispatcher.dispatchMessage(routing_table.get(), routes, source_channel, message));
+    REQUIRE(module.waitReceived(1));
+    REQUIRE(dispatcher.dispatchMessage(routing_table.get(), routes, source_channel, message));
+
+    SECTION("messages are dropped")
+    {
+        REQUIRE_FALSE(dispatcher.dispatchMessage(routing_table.get(), routes, source_channel, message));
+        REQUIRE(dispatcher.droppedCount() == 1);
+        module.open();
+    }
+
+    SECTION("requests wait for space")
+    {
+        std::atomic<bool> sent = false;
+        bool dispatched = false;
+        std::thread sender([&] {
+            dispatched = dispatcher.dispatchSingle(aergo::module::IModule::ProcessingType::REQUEST, routing_table.get(), target, source_channel, message);
+            sent = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE_FALSE(sent);
+
+        module.open();
+        sender.join();
+        REQUIRE(dispatched);
+        REQUIRE(module.waitReceived(3));
+        REQUIRE(dispatcher.droppedCount() == 0);
+    }
+
+    SECTION("responses sent from a delivery do not wait")
+    {
+        // delivery of the queued message fills the shard again and responds into it
+        bool dispatched = false;
+        module.respond_ = [&] {
+            dispatched = dispatcher.dispatchMessage(routing_table.get(), routes, source_channel, message)
+                && dispatcher.dispatchSingle(aergo::module::IModule::ProcessingType::RESPONSE, routing_table.get(), target, source_channel, message);
+        };
+        module.open();
+        REQUIRE(module.waitReceived(4));
+        REQUIRE(dispatched);
+    }
+
+    dispatcher.stop();
+}
+
+
+
+TEST_CASE( "MessageDispatcher routing table references", "[message_dispatcher]" )
+{
+    SilentLogger logger;
+
+    class CountingSubscriber : public FakeSubscriber
+    {
+    public:
+        void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, aergo::module::ChannelIdentifier source_channel, aergo::module::message::MessageEnvelope* envelope) noexcept override
+        {
+            ++received_;
+        }
+
+        bool waitReceived(uint64_t count)
+        {
+            for (int i = 0; i < 1000 && received_ < count; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return received_ >= count;
+        }
+
+        std::atomic<uint64_t> received_ = 0;
+    };
+
+    std::vector<CountingSubscriber> subscribers(1);
+    aergo::module::ChannelIdentifier source_channel { .producer_module_id_ = 0, .producer_channel_id_ = 0 };
+    aergo::module::message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+
+    MessageDispatcher dispatcher(1, 16, &logger);
+
+    // the shard keeps the table of queued tasks, the caller does not have to
+    auto first_table = std::make_shared<structures::RoutingTable>();
+    first_table->modules_.resize(1);
+    first_table->modules_[0].publish_.push_back({ .table_ = first_table.get(), .routes_ = { { &subscribers[0], 0 } } });
+    std::weak_ptr<structures::RoutingTable> first_table_reference = first_table;
+    REQUIRE(dispatcher.dispatchMessage(first_table.get(), &first_table->modules_[0].publish_[0].routes_, source_channel, message));
+    REQUIRE(dispatcher.dispatchMessage(first_table.get(), &first_table->modules_[0].publish_[0].routes_, source_channel, message));
+    first_table.reset();
+
+    REQUIRE(subscribers[0].waitReceived(2));
+    REQUIRE_FALSE(first_table_reference.expired());
+
+    // idle table is replaced by the next one
+    auto second_table = std::make_shared<structures::RoutingTable>();
+    second_table->modules_.resize(1);
+    second_table->modules_[0].publish_.push_back({ .table_ = second_table.get(), .routes_ = { { &subscribers[0], 0 } } });
+    std::weak_ptr<structures::RoutingTable> second_table_reference = second_table;
+    REQUIRE(dispatcher.dispatchMessage(second_table.get(), &second_table->modules_[0].publish_[0].routes_, source_channel, message));
+    REQUIRE(first_table_reference.expired());
+    second_table.reset();
+
+    REQUIRE(subscribers[0].waitReceived(3));
+    dispatcher.releaseIdleTables();
+    REQUIRE(second_table_reference.expired());
+
+    dispatcher.stop();
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/core.h"
+#include "core/topology_tracker.h"
+
+#include <vector>
+
+using namespace aergo::core;
+using Type = aergo::module::TopologyEvent::Type;
+
+
+
+namespace
+{
+    class SilentLogger : public logging::ILogger
+    {
+    public:
+        void log(logging::SourceType source_type, const char* source_name, uint64_t source_module_id, aergo::module::logging::LogType log_type, const char* message) override {}
+    };
+
+
+
+    /// @brief Running modules of "core" as the core passes them to the tracker (not owning).
+    std::vector<std::shared_ptr<structures::ModuleData>> runningModules(Core& core)
+    {
+        std::vector<std::shared_ptr<structures::ModuleData>> running_modules;
+        for (uint64_t module_id = 0; module_id < core.getCreatedModulesCount(); ++module_id)
+        {
+            running_modules.emplace_back(core.getCreatedModulesInfo(module_id), [](structures::ModuleData*) {});
+        }
+        return running_modules;
+    }
+}
+
+
+
+TEST_CASE( "TopologyTracker", "[topology_tracker]" )
+{
+    SilentLogger logger;
+    Core core(&logger);
+    REQUIRE_NOTHROW(core.initialize("../../../../../../../backend/binaries/tests/test_core_1", "."));
+
+    // module E is loaded module 4 and auto-created as module 0
+    const structures::ModuleLoaderData* loaded_modules = core.getCreatedModulesInfo(0)->module_loader_data_ - 4;
+
+    TopologyTracker tracker;
+    auto events = tracker.update(runningModules(core), loaded_modules);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type_ == Type::MODULE_ADDED);
+    REQUIRE(events[0].module_id_ == 0);
+    REQUIRE(events[0].loaded_module_id_ == 4);
+
+    REQUIRE(tracker.update(runningModules(core), loaded_modules).empty());
+
+    // A (module 1) publishes message_6 to E (AUTO_ALL), B (module 2) subscribes to A and publishes message_6 to E
+    aergo::module::InputChannelMapInfo channel_map_info_a { nullptr, 0, nullptr, 0 };
+    REQUIRE(core.addModule(0, channel_map_info_a) == true);
+
+    aergo::module::ChannelIdentifier channel_id_b { .producer_module_id_ = 1, .producer_channel_id_ = 1 };
+    aergo::module::InputChannelMapInfo::IndividualChannelInfo single_channel_info_b { .channel_identifier_ = &channel_id_b, .channel_identifier_count_ = 1 };
+    aergo::module::InputChannelMapInfo channel_map_info_b { &single_channel_info_b, 1, nullptr, 0 };
+    REQUIRE(core.addModule(1, channel_map_info_b) == true);
+
+    events = tracker.update(runningModules(core), loaded_modules);
+    REQUIRE(events.size() == 5);
+    REQUIRE(events[0].type_ == Type::MODULE_ADDED);
+    REQUIRE(events[0].module_id_ == 1);
+    REQUIRE(events[0].loaded_module_id_ == 0);
+    REQUIRE(events[1].type_ == Type::MODULE_ADDED);
+    REQUIRE(events[1].module_id_ == 2);
+    REQUIRE(events[1].loaded_module_id_ == 1);
+
+    // connections by consumer module
+    REQUIRE(events[2].type_ == Type::CONNECTION_ADDED);
+    REQUIRE(events[2].module_id_ == 0);
+    REQUIRE(events[2].producer_ == aergo::module::ChannelIdentifier{1, 0});
+    REQUIRE(events[3].type_ == Type::CONNECTION_ADDED);
+    REQUIRE(events[3].module_id_ == 0);
+    REQUIRE(events[3].producer_ == aergo::module::ChannelIdentifier{2, 0});
+    REQUIRE(events[4].type_ == Type::CONNECTION_ADDED);
+    REQUIRE(events[4].module_id_ == 2);
+    REQUIRE(events[4].consumer_channel_id_ == 0);
+    REQUIRE_FALSE(events[4].request_);
+    REQUIRE(events[4].producer_ == aergo::module::ChannelIdentifier{1, 1});
+
+    REQUIRE(core.removeModule(1, true) == Core::RemoveResult::SUCCESS);
+
+    events = tracker.update(runningModules(core), loaded_modules);
+    REQUIRE(events.size() == 5);
+    REQUIRE(events[0].type_ == Type::CONNECTION_REMOVED);
+    REQUIRE(events[0].module_id_ == 0);
+    REQUIRE(events[0].producer_ == aergo::module::ChannelIdentifier{1, 0});
+    REQUIRE(events[1].type_ == Type::CONNECTION_REMOVED);
+    REQUIRE(events[1].module_id_ == 0);
+    REQUIRE(events[1].producer_ == aergo::module::ChannelIdentifier{2, 0});
+    REQUIRE(events[2].type_ == Type::CONNECTION_REMOVED);
+    REQUIRE(events[2].module_id_ == 2);
+    REQUIRE(events[3].type_ == Type::MODULE_REMOVED);
+    REQUIRE(events[3].module_id_ == 1);
+    REQUIRE(events[4].type_ == Type::MODULE_REMOVED);
+    REQUIRE(events[4].module_id_ == 2);
+
+    REQUIRE(tracker.update(runningModules(core), loaded_modules).empty());
+}
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include "module_common/module_interface_.h"
 #include "module_common/dll_interface_threads.h"
 
-#define CORE_API_VERSION 2
+#define CORE_API_VERSION 19
 
 #ifdef _WIN32
   #define WIN32_LEAN_AND_MEAN  // ERROR is a macro. Yes, really. Someone signed off on that.
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "module_common/module_interface_.h"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+namespace aergo::core::executor
+{
+    /// @brief Fixed-size thread pool. Every worker thread has its own task deque, idle workers steal tasks from the other deques.
+    /// Tasks submitted from a worker thread go to the deque of that worker, other submits are spread round-robin.
+    /// Owner takes tasks from the front of its deque, thieves from the back.
+    class WorkStealingExecutor : public aergo::module::IExecutor
+    {
+    public:
+        /// @param thread_count number of worker threads, min 1
+        WorkStealingExecutor(uint32_t thread_count);
+        ~WorkStealingExecutor() override;
+
+        WorkStealingExecutor(const WorkStealingExecutor& other) = delete;
+        WorkStealingExecutor& operator=(const WorkStealingExecutor& other) = delete;
+
+        virtual bool submit(aergo::module::IExecutorTask* task) noexcept override final;
+
+        /// @brief Stop and join the worker threads. Tasks that did not run yet are discarded. Subsequent submit calls fail.
+        void stop() noexcept;
+
+        uint32_t threadCount() const noexcept;
+
+        /// @brief Number of tasks taken from the deque of another worker.
+        uint64_t stolenCount() const noexcept;
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex_;
+            std::deque<aergo::module::IExecutorTask*> tasks_;
+            std::thread thread_;
+        };
+
+        void workerThreadFunc(uint32_t worker_idx);
+
+        aergo::module::IExecutorTask* popLocal(uint32_t worker_idx);  // front of own deque, nullptr if empty
+        aergo::module::IExecutorTask* steal(uint32_t worker_idx);     // back of the other deques, nullptr if all empty
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        std::atomic<uint64_t> pending_{0};       // submitted tasks not yet taken by a worker
+        std::atomic<uint32_t> sleeping_{0};      // workers waiting on park_cv_
+        std::atomic<uint32_t> next_worker_{0};   // round-robin target for submits from outside the pool
+        std::atomic<uint64_t> stolen_count_{0};
+        std::atomic<bool> stop_threads_{false};
+
+        std::mutex park_mutex_;
+        std::condition_variable park_cv_;
+    };
+}
\ No newline at end of file
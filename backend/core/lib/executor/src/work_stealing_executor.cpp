@@ -0,0 +1,173 @@
+#include "utils/executor/work_stealing_executor.h"
+
+using namespace aergo::core::executor;
+
+
+
+namespace
+{
+    // identifies the worker thread calling submit, so tasks submitted from a task stay on the same worker
+    thread_local const WorkStealingExecutor* current_executor = nullptr;
+    thread_local uint32_t current_worker_idx = 0;
+}
+
+
+
+WorkStealingExecutor::WorkStealingExecutor(uint32_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    workers_.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        workers_[i]->thread_ = std::thread(&WorkStealingExecutor::workerThreadFunc, this, i);
+    }
+}
+
+
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    stop();
+}
+
+
+
+bool WorkStealingExecutor::submit(aergo::module::IExecutorTask* task) noexcept
+{
+    if (task == nullptr || stop_threads_)
+    {
+        return false;
+    }
+
+    uint32_t worker_idx = (current_executor == this) ? current_worker_idx : (next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size());
+    {
+        // counted under the deque lock, so a worker that sees pending_ > 0 will find the task
+        std::lock_guard<std::mutex> lock(workers_[worker_idx]->mutex_);
+        pending_.fetch_add(1);
+        workers_[worker_idx]->tasks_.push_back(task);
+    }
+
+    // sleeping worker checks pending_ after announcing itself in sleeping_, so one of the two sides always sees the other
+    if (sleeping_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_cv_.notify_one();
+    }
+
+    return true;
+}
+
+
+
+void WorkStealingExecutor::stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        stop_threads_ = true;
+    }
+    park_cv_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        if (worker->thread_.joinable())
+        {
+            worker->thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(worker->mutex_);
+        worker->tasks_.clear();
+    }
+}
+
+
+
+uint32_t WorkStealingExecutor::threadCount() const noexcept
+{
+    return static_cast<uint32_t>(workers_.size());
+}
+
+
+
+uint64_t WorkStealingExecutor::stolenCount() const noexcept
+{
+    return stolen_count_;
+}
+
+
+
+void WorkStealingExecutor::workerThreadFunc(uint32_t worker_idx)
+{
+    current_executor = this;
+    current_worker_idx = worker_idx;
+
+    while (!stop_threads_)
+    {
+        aergo::module::IExecutorTask* task = popLocal(worker_idx);
+        if (task == nullptr)
+        {
+            task = steal(worker_idx);
+        }
+
+        if (task != nullptr)
+        {
+            task->run();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        ++sleeping_;
+        park_cv_.wait(lock, [&] { return stop_threads_ || pending_.load() > 0; });
+        --sleeping_;
+    }
+
+    current_executor = nullptr;
+}
+
+
+
+aergo::module::IExecutorTask* WorkStealingExecutor::popLocal(uint32_t worker_idx)
+{
+    Worker& worker = *workers_[worker_idx];
+
+    std::lock_guard<std::mutex> lock(worker.mutex_);
+    if (worker.tasks_.empty())
+    {
+        return nullptr;
+    }
+
+    aergo::module::IExecutorTask* task = worker.tasks_.front();
+    worker.tasks_.pop_front();
+    --pending_;
+    return task;
+}
+
+
+
+aergo::module::IExecutorTask* WorkStealingExecutor::steal(uint32_t worker_idx)
+{
+    for (uint32_t i = 1; i < workers_.size(); ++i)
+    {
+        Worker& victim = *workers_[(worker_idx + i) % workers_.size()];
+
+        std::lock_guard<std::mutex> lock(victim.mutex_);
+        if (!victim.tasks_.empty())
+        {
+            aergo::module::IExecutorTask* task = victim.tasks_.back();
+            victim.tasks_.pop_back();
+            --pending_;
+            ++stolen_count_;
+            return task;
+        }
+    }
+
+    return nullptr;
+}
\ No newline at end of file
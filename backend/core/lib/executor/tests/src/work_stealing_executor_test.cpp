@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/executor/work_stealing_executor.h"
+
+#include <chrono>
+
+using namespace aergo::core::executor;
+
+
+
+namespace
+{
+    class CountingTask : public aergo::module::IExecutorTask
+    {
+    public:
+        void run() noexcept override { ++runs_; }
+
+        std::atomic<uint64_t> runs_{0};
+    };
+
+
+
+    /// @brief Submits "fan_out_" sleeping tasks from a worker thread, so other workers have to steal them.
+    class FanOutTask : public aergo::module::IExecutorTask
+    {
+    public:
+        class SleepingTask : public aergo::module::IExecutorTask
+        {
+        public:
+            void run() noexcept override
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                ++(*done_);
+            }
+
+            std::atomic<uint64_t>* done_;
+        };
+
+        FanOutTask(WorkStealingExecutor* executor, uint32_t fan_out)
+        : executor_(executor), children_(fan_out)
+        {
+            for (auto& child : children_)
+            {
+                child.done_ = &done_;
+            }
+        }
+
+        void run() noexcept override
+        {
+            for (auto& child : children_)
+            {
+                executor_->submit(&child);
+            }
+        }
+
+        WorkStealingExecutor* executor_;
+        std::vector<SleepingTask> children_;
+        std::atomic<uint64_t> done_{0};
+    };
+
+
+
+    /// @brief Resubmits itself until it ran "remaining_" times.
+    class ResubmittingTask : public aergo::module::IExecutorTask
+    {
+    public:
+        void run() noexcept override
+        {
+            if (--remaining_ > 0)
+            {
+                executor_->submit(this);
+            }
+            ++runs_; // last access, the task may be destroyed once all runs are counted
+        }
+
+        WorkStealingExecutor* executor_;
+        std::atomic<uint64_t> remaining_;
+        std::atomic<uint64_t> runs_{0};
+    };
+
+
+
+    template <typename Predicate>
+    bool waitFor(Predicate predicate, uint32_t timeout_ms = 5000)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeout_ms))
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+
+
+TEST_CASE("WorkStealingExecutor", "[executor]")
+{
+    WorkStealingExecutor executor(4);
+    REQUIRE(executor.threadCount() == 4);
+
+    SECTION("every submit runs once")
+    {
+        std::vector<CountingTask> tasks(100);
+        for (uint32_t round = 0; round < 100; ++round)
+        {
+            for (auto& task : tasks)
+            {
+                REQUIRE(executor.submit(&task));
+            }
+        }
+
+        REQUIRE(waitFor([&] {
+            for (auto& task : tasks)
+            {
+                if (task.runs_ != 100) return false;
+            }
+            return true;
+        }));
+        executor.stop();
+    }
+
+    SECTION("idle workers steal")
+    {
+        FanOutTask fan_out(&executor, 1000);
+        REQUIRE(executor.submit(&fan_out));
+
+        REQUIRE(waitFor([&] { return fan_out.done_ == 1000; }));
+        REQUIRE(executor.stolenCount() > 0);
+        executor.stop();
+    }
+
+    SECTION("task resubmits itself")
+    {
+        ResubmittingTask task;
+        task.executor_ = &executor;
+        task.remaining_ = 1000;
+        REQUIRE(executor.submit(&task));
+
+        REQUIRE(waitFor([&] { return task.runs_ == 1000; }));
+        executor.stop(); // workers are joined before the tasks go out of scope
+    }
+
+    SECTION("submit fails after stop")
+    {
+        CountingTask task;
+        executor.stop();
+        REQUIRE(!executor.submit(&task));
+        REQUIRE(!executor.submit(nullptr));
+    }
+}
+
+
+
+TEST_CASE("WorkStealingExecutor minimum thread count", "[executor]")
+{
+    WorkStealingExecutor executor(0);
+    REQUIRE(executor.threadCount() == 1);
+
+    CountingTask task;
+    REQUIRE(executor.submit(&task));
+    REQUIRE(waitFor([&] { return task.runs_ == 1; }));
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "module_common/module_interface_.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace aergo::core::memory_allocation
+{
+    /// @brief Samples 1 in sample_period allocations (per thread) and keeps them until the data is released, to find blobs that are
+    /// held for long or leaked. Samples are keyed by data pointer in a fixed table of cache line sized buckets: releasing or publishing
+    /// untracked data costs one relaxed load while nothing is sampled and one bucket scan otherwise, without locking.
+    /// Allocations sampled while their bucket is full are only counted (droppedSamples). Disabled (sample_period 0) by default. Thread safe.
+    class AllocationTracker
+    {
+    public:
+        static constexpr uint32_t DEFAULT_CAPACITY = 4096;
+
+        /// @param capacity maximum number of samples tracked at once, rounded up to a power of two buckets
+        AllocationTracker(uint32_t capacity = DEFAULT_CAPACITY);
+
+        AllocationTracker(const AllocationTracker& other) = delete;
+        AllocationTracker& operator=(const AllocationTracker& other) = delete;
+
+        /// @param sample_period sample every "sample_period"-th allocation, 1 for all, 0 to disable (tracked samples are kept)
+        void setSamplePeriod(uint32_t sample_period);
+        uint32_t samplePeriod() const;
+
+        /// @brief Successful allocation of "data" by allocator "allocator_id" of module "module_id".
+        void allocated(aergo::module::ISharedData* data, uint64_t module_id, uint64_t allocator_id);
+
+        /// @brief Last owner of "data" is gone.
+        void released(aergo::module::ISharedData* data);
+
+        /// @brief "data" was sent on "channel", the first channel is kept.
+        void published(uint8_t* data, aergo::module::ChannelIdentifier channel);
+
+        /// @brief Tracked samples allocated at least "min_age_ns" ago, oldest first.
+        std::vector<aergo::module::AllocationSample> outstanding(uint64_t min_age_ns);
+
+        /// @brief Any sample tracked, check before looking up data of sent messages.
+        bool hasSamples() const;
+
+        /// @brief Samples not tracked because their bucket was full.
+        uint64_t droppedSamples() const;
+
+        static uint64_t nowNs();
+
+    private:
+        static constexpr uint32_t BUCKET_SLOTS = 8;
+
+        struct alignas(64) Bucket
+        {
+            std::atomic<uint8_t*> keys_[BUCKET_SLOTS];
+        };
+
+        bool shouldSample(uint32_t sample_period);
+        std::atomic<uint8_t*>* findKey(uint8_t* data);  // nullptr if "data" is not tracked
+        uint64_t slotIndex(std::atomic<uint8_t*>* key);
+        Bucket& bucket(uint8_t* data);
+
+        std::atomic<uint32_t> sample_period_ = 0;
+        std::atomic<uint64_t> tracked_ = 0;             // keys set, fast path for released and published
+        std::atomic<uint64_t> dropped_ = 0;
+
+        uint64_t bucket_mask_;
+        std::unique_ptr<Bucket[]> buckets_;
+        std::unique_ptr<aergo::module::AllocationSample[]> samples_;    // by slot, guarded by mutex_
+
+        std::mutex mutex_;                              // inserting, removing and reading samples
+    };
+}
\ No newline at end of file
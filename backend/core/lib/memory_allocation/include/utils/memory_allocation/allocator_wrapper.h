@@ -1,6 +1,7 @@
 #pragma once
 
 #include "allocator_interface_core.h"
+#include "allocation_tracker.h"
 #include "module_common/module_interface_.h"
 
 #include <memory>
@@ -10,7 +11,8 @@ namespace aergo::core::memory_allocation
     class AllocatorWrapper : public aergo::module::IAllocator
     {
     public:
-        AllocatorWrapper(std::unique_ptr<ICoreAllocator> allocator);
+        /// @param tracker samples allocations as allocator "allocator_id" of module "module_id", nullptr for no tracking
+        AllocatorWrapper(std::unique_ptr<ICoreAllocator> allocator, AllocationTracker* tracker = nullptr, uint64_t module_id = 0, uint64_t allocator_id = 0);
         
         /// @brief Allocate "number_of_bytes" bytes of shared memory. If the allocator has fixed byte size, "number_of_bytes" parameter is ignored.
         /// @return SharedDataBlob, check for validity by calling the valid() function
@@ -25,5 +27,8 @@ namespace aergo::core::memory_allocation
 
     private:
         std::unique_ptr<ICoreAllocator> allocator_;
+        AllocationTracker* tracker_;
+        uint64_t module_id_;
+        uint64_t allocator_id_;
     };
 };
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "utils/logging/logger.h"
 #include "shared_data_core.h"
 #include "allocator_interface_core.h"
+#include "memory_account.h"
+#include "slab_memory_allocator.h"
 
 #include <map>
 #include <set>
@@ -15,7 +17,12 @@ namespace aergo::core::memory_allocation
     class DynamicAllocator : public ICoreAllocator
     {
     public:
-        DynamicAllocator(aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator = nullptr);
+        /// @param custom_allocator memory for the data, if nullptr SlabMemoryAllocator (default options) or AlignedMemoryAllocator
+        /// @param options alignment and page backing of the data, used if custom_allocator is nullptr
+        /// @param account charged with the allocated data (live and reserved), must outlive the allocator, nullptr for no accounting
+        DynamicAllocator(aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator = nullptr, aergo::module::AllocationOptions options = {},
+            MemoryAccount* account = nullptr);
+        ~DynamicAllocator() override;
 
         virtual aergo::module::ISharedData* allocate(uint64_t number_of_bytes) noexcept override final;
         virtual void addOwner(aergo::module::ISharedData* data) noexcept override final;
@@ -30,8 +37,10 @@ namespace aergo::core::memory_allocation
         void log(aergo::module::logging::LogType log_type, const char* message);
 
         IMemoryAllocator* memory_allocator_;
-        DefaultAllocator default_memory_allocator_;
+        SlabMemoryAllocator default_memory_allocator_;   // recycles same-size buffers, declared before allocated_data_ so it outlives the data
+        AlignedMemoryAllocator aligned_memory_allocator_;
         aergo::core::logging::ILogger* logger_;
+        MemoryAccount* account_;
 
         std::map<uint64_t, SharedDataCore> allocated_data_;
         std::set<std::size_t> allocated_memory_slots_;
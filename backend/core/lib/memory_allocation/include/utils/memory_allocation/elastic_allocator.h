@@ -0,0 +1,100 @@
+#pragma once
+
+#include "module_common/module_interface_.h"
+#include "utils/logging/logger.h"
+#include "shared_data_core.h"
+#include "allocator_interface_core.h"
+#include "memory_account.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace aergo::core::memory_allocation
+{
+    /// @brief Fixed size slots like StaticAllocator, but the pool grows by chunks of grow_slots_ slots (up to max_slots_) when every slot
+    /// is owned, instead of failing. Chunks added by growing are freed once none of their slots was owned for idle_trim_ms_
+    /// (checked on allocate/removeOwner, or by calling trimIdleChunks). Allocation prefers older chunks, so newer ones drain first.
+    /// Pressure events (growth, trimming, allocation failing at max_slots_) are logged and counted in stats(). Thread safe.
+    class ElasticAllocator : public ICoreAllocator
+    {
+    public:
+        class ElasticAllocatorInitializationException : public std::exception {};
+
+        struct Stats
+        {
+            uint32_t slots_;                // slots currently allocated (owned or free)
+            uint32_t used_slots_;           // slots currently owned
+            uint32_t peak_slots_;           // maximum of slots_
+            uint64_t grow_events_;
+            uint64_t trim_events_;          // chunks freed
+            uint64_t exhausted_events_;     // allocations failed with max_slots_ slots owned (or upstream failure while growing)
+        };
+
+        /// @throws ElasticAllocatorInitializationException if options are invalid (max_slots_ zero or below min_slots_) or min_slots_ slots could not be allocated.
+        /// @param allocation_options alignment and page backing of the slots, used if custom_allocator is nullptr
+        /// @param account charged with the slots (reserved) and owned slots (live), must outlive the allocator, nullptr for no accounting
+        ElasticAllocator(uint64_t slot_size_bytes, aergo::module::ElasticBufferOptions options, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator = nullptr,
+            aergo::module::AllocationOptions allocation_options = {}, MemoryAccount* account = nullptr);
+        ~ElasticAllocator() override;
+
+        ElasticAllocator(const ElasticAllocator& other) = delete;
+        ElasticAllocator& operator=(const ElasticAllocator& other) = delete;
+
+        /// @param number_of_bytes parameter is ignored, since we have fixed slots
+        virtual aergo::module::ISharedData* allocate(uint64_t number_of_bytes) noexcept override final;
+        virtual void addOwner(aergo::module::ISharedData* data) noexcept override final;
+        virtual void removeOwner(aergo::module::ISharedData* data) noexcept override final;
+
+        // separate for testing that it does not throw exceptions
+        aergo::module::ISharedData* allocateImpl();
+        void addOwnerImpl(aergo::module::ISharedData* data);
+        void removeOwnerImpl(aergo::module::ISharedData* data);
+
+        Stats stats();
+
+        /// @brief Free chunks added by growing that have no owned slots.
+        /// @param force also free chunks that were not unused for idle_trim_ms_ yet
+        void trimIdleChunks(bool force = false);
+
+    private:
+        struct Chunk
+        {
+            std::vector<SharedDataCore> slots_;
+            std::vector<bool> allocated_;
+            std::vector<uint32_t> free_slots_;
+            uint64_t idle_since_ns_ = 0;    // time the last owned slot was freed
+            bool trimmable_;                // false for the min_slots_ chunk
+        };
+
+        void log(aergo::module::logging::LogType log_type, const char* message);
+        static uint64_t nowNs();
+
+        bool addChunk(uint32_t number_of_slots, bool trimmable);                            // call with mutex locked
+        bool findSlot(aergo::module::ISharedData* data, Chunk*& chunk, uint32_t& idx);      // call with mutex locked
+        void trimChunks(bool force, uint64_t now_ns);                                       // call with mutex locked
+
+        IMemoryAllocator* memory_allocator_;
+        AlignedMemoryAllocator default_memory_allocator_;
+        aergo::core::logging::ILogger* logger_;
+        MemoryAccount* account_;
+
+        uint64_t slot_size_bytes_;
+        uint32_t max_slots_;
+        uint32_t grow_slots_;
+        uint64_t idle_trim_ns_;
+
+        std::vector<std::unique_ptr<Chunk>> chunks_;           // oldest first
+        std::map<std::uintptr_t, Chunk*> chunk_by_address_;    // keyed by slots_.data()
+        uint32_t idle_chunks_ = 0;                             // trimmable chunks without owned slots
+        bool exhausted_ = false;                               // logged exhaustion, until a slot is freed again
+        uint64_t logged_lock_failures_ = 0;
+        uint64_t next_slot_id_ = 0;
+
+        Stats stats_ {};
+
+        std::mutex mutex_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "module_common/module_interface_.h"
+#include "utils/logging/logger.h"
+#include "shared_data_core.h"
+#include "allocator_interface_core.h"
+#include "memory_account.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace aergo::core::memory_allocation
+{
+    /// @brief Data backed by a memory-mapped file. The file is an arena of records {RecordHeader, data} appended one after another
+    /// (data aligned to RECORD_ALIGNMENT), created sparse with capacity_bytes_ and truncated to the used part when the allocator
+    /// is destroyed. Space of released blobs is not reused, the file keeps every allocated blob.
+    /// In read mode an existing file is mapped privately (changes stay in memory) and allocate returns the recorded blobs in order,
+    /// so they can be passed on without copying. Thread safe.
+    class MappedFileAllocator : public ICoreAllocator
+    {
+    public:
+        class MappedFileAllocatorInitializationException : public std::exception {};
+
+        static constexpr uint64_t RECORD_ALIGNMENT = 64;
+
+        /// @throws MappedFileAllocatorInitializationException if the file could not be created or mapped, capacity_bytes_ is too small
+        /// for the file header or (read mode) the file is not a recorded file.
+        /// @param account charged with owned blobs (live), must outlive the allocator, nullptr for no accounting
+        MappedFileAllocator(const std::string& path, aergo::module::MappedFileOptions options, aergo::core::logging::ILogger* logger, MemoryAccount* account = nullptr);
+        ~MappedFileAllocator() override;
+
+        MappedFileAllocator(const MappedFileAllocator& other) = delete;
+        MappedFileAllocator& operator=(const MappedFileAllocator& other) = delete;
+
+        /// @param number_of_bytes ignored in read mode, next recorded blob is returned
+        virtual aergo::module::ISharedData* allocate(uint64_t number_of_bytes) noexcept override final;
+        virtual void addOwner(aergo::module::ISharedData* data) noexcept override final;
+        virtual void removeOwner(aergo::module::ISharedData* data) noexcept override final;
+
+        // separate for testing that it does not throw exceptions
+        aergo::module::ISharedData* allocateImpl(uint64_t number_of_bytes);
+        void addOwnerImpl(aergo::module::ISharedData* data);
+        void removeOwnerImpl(aergo::module::ISharedData* data);
+
+        /// @brief Write modified pages to the file and wait for it (no-op in read mode).
+        /// @return false on failure
+        bool flush();
+
+        /// @brief Records allocated so far (write mode) or in the file (read mode).
+        uint64_t recordCount();
+
+        /// @brief File bytes used by the file header and the records.
+        uint64_t usedBytes();
+
+    private:
+        struct FileHeader
+        {
+            char magic_[8];
+            uint32_t version_;
+            uint32_t record_alignment_;
+            uint64_t used_bytes_;       // updated on every allocation, so a file of a crashed writer is readable up to the last record
+            uint64_t record_count_;
+            uint8_t reserved_[32];
+        };
+
+        struct RecordHeader
+        {
+            uint64_t magic_;
+            uint64_t size_;             // data bytes, data starts right after the header
+            uint64_t id_;               // index of the record
+            uint8_t reserved_[40];
+        };
+
+        static_assert(sizeof(FileHeader) == RECORD_ALIGNMENT && sizeof(RecordHeader) == RECORD_ALIGNMENT);
+
+        static constexpr char FILE_MAGIC[8] = { 'A', 'E', 'R', 'G', 'O', 'M', 'A', 'P' };
+        static constexpr uint32_t FILE_VERSION = 1;
+        static constexpr uint64_t RECORD_MAGIC = 0x44524F4345524741; // "AGRECORD"
+
+        bool mapFile(const std::string& path, uint64_t capacity_bytes);
+        void unmapFile();
+        bool readHeader();
+        static uint64_t alignUp(uint64_t bytes);
+
+        void log(aergo::module::logging::LogType log_type, const char* message);
+
+        aergo::core::logging::ILogger* logger_;
+        MemoryAccount* account_;
+        bool read_only_;
+
+        uint8_t* base_ = nullptr;
+        uint64_t mapped_bytes_ = 0;
+        FileHeader* header_ = nullptr;
+#if defined(_WIN32)
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#else
+        int file_ = -1;
+#endif
+
+        uint64_t read_offset_ = 0;      // read mode: next record
+        uint64_t read_count_ = 0;
+
+        std::unordered_map<aergo::module::ISharedData*, std::unique_ptr<SharedDataCore>> owned_data_;
+
+        std::mutex mutex_;
+    };
+}
\ No newline at end of file
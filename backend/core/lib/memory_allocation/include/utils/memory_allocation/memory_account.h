@@ -0,0 +1,67 @@
+#pragma once
+
+#include "module_common/module_interface_.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace aergo::core::memory_allocation
+{
+    /// @brief Memory accounting of an allocator or a module (parent of its allocators' accounts). Live bytes are limited by an optional quota,
+    /// an allocation is charged to the account and all its parents and fails if any quota would be exceeded. Lock-free, thread safe.
+    class MemoryAccount
+    {
+    public:
+        /// @param parent account also charged by this one, must outlive it
+        MemoryAccount(MemoryAccount* parent = nullptr);
+
+        MemoryAccount(const MemoryAccount& other) = delete;
+        MemoryAccount& operator=(const MemoryAccount& other) = delete;
+
+        /// @brief Charge "bytes" of new data to this account and its parents.
+        /// @return false (counted as failure, nothing charged) if a quota would be exceeded
+        bool tryAllocate(uint64_t bytes);
+
+        /// @brief Undo tryAllocate after the allocation itself failed, counted as failure.
+        void cancelAllocation(uint64_t bytes);
+
+        /// @brief Count an allocation failing for another reason (pool exhausted, out of memory) without calling tryAllocate.
+        void recordFailure();
+
+        /// @brief Data charged by tryAllocate was freed.
+        void free(uint64_t bytes);
+
+        /// @brief Memory held by the allocator changed (slots preallocated or released, dynamic data allocated or freed).
+        void addReserved(int64_t bytes);
+
+        /// @param quota_bytes limit of live bytes, 0 = unlimited
+        void setQuota(uint64_t quota_bytes);
+
+        aergo::module::MemoryStats stats() const;
+
+    private:
+        static uint64_t nowNs();
+
+        /// @brief Reserve live bytes here, then in the parents. Other counters are only updated once every quota passed,
+        /// on failure the reserved live bytes are released again.
+        bool charge(uint64_t bytes);
+        void updateRate(uint64_t bytes);
+
+        MemoryAccount* parent_;
+
+        std::atomic<uint64_t> live_bytes_ = 0;
+        std::atomic<uint64_t> peak_live_bytes_ = 0;
+        std::atomic<int64_t> reserved_bytes_ = 0;
+        std::atomic<uint64_t> allocation_count_ = 0;
+        std::atomic<uint64_t> allocated_bytes_ = 0;
+        std::atomic<uint64_t> failed_count_ = 0;
+        std::atomic<uint64_t> quota_bytes_ = 0;
+
+        // allocations are summed in one second windows, the rate of the last completed window is reported
+        std::atomic<uint64_t> window_start_ns_;
+        std::atomic<uint64_t> window_allocations_ = 0;
+        std::atomic<uint64_t> window_bytes_ = 0;
+        std::atomic<double> allocations_per_second_ = 0;
+        std::atomic<double> allocated_bytes_per_second_ = 0;
+    };
+}
\ No newline at end of file
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "module_common/module_interface_.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
 namespace aergo::core::memory_allocation
 {
     class IMemoryAllocator
@@ -17,4 +24,47 @@ namespace aergo::core::memory_allocation
         void* malloc(size_t size) override;
         void free(void* block) override;
     };
+
+    /// @brief Memory with the properties of AllocationOptions. Alignment alone is served from the heap (aligned operator new),
+    /// huge pages, prefaulting or locking map every block separately (mmap/VirtualAlloc), so it is meant for large blocks.
+    /// Default options behave like DefaultAllocator. Thread safe.
+    class AlignedMemoryAllocator : public IMemoryAllocator
+    {
+    public:
+        AlignedMemoryAllocator(aergo::module::AllocationOptions options = {});
+
+        /// @brief Unmaps blocks that were not freed.
+        ~AlignedMemoryAllocator() override;
+
+        AlignedMemoryAllocator(const AlignedMemoryAllocator& other) = delete;
+        AlignedMemoryAllocator& operator=(const AlignedMemoryAllocator& other) = delete;
+
+        /// @return nullptr on failure or if alignment_ is not a power of two
+        void* malloc(size_t size) override;
+        void free(void* block) override;
+
+        /// @brief Options equal to the defaults (plain heap memory).
+        bool plainHeap() const;
+
+        /// @brief Number of blocks lock_memory_ failed for (e.g. RLIMIT_MEMLOCK too low), the blocks are still usable.
+        uint64_t lockFailures() const;
+
+    private:
+        struct Mapping
+        {
+            void* base_;
+            size_t length_;
+        };
+
+        void* mapBlock(size_t size);
+        static void unmap(Mapping mapping);
+        static size_t pageSize();
+
+        aergo::module::AllocationOptions options_;
+        bool mapped_;                                  // huge pages, prefault or lock requested
+        std::atomic<uint64_t> lock_failures_ = 0;
+
+        std::unordered_map<void*, Mapping> mappings_;  // by returned block
+        std::mutex mappings_mutex_;
+    };
 }
\ No newline at end of file
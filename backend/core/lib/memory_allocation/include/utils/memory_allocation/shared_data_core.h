@@ -5,7 +5,8 @@
 
 namespace aergo::core::memory_allocation
 {
-    class SharedDataCore : public aergo::module::ISharedData
+    /// @brief Shared data counting its owners itself (ICountedSharedData), so SharedDataBlob copies do not enter the allocator.
+    class SharedDataCore : public aergo::module::ICountedSharedData
     {
     public:
         SharedDataCore() noexcept;
@@ -20,18 +21,24 @@ namespace aergo::core::memory_allocation
         virtual bool valid() noexcept override final;
         virtual uint8_t* data() noexcept override final;
         virtual uint64_t size() noexcept override final;
+        virtual aergo::module::ICountedSharedData* counted() noexcept override final;  // nullptr when invalid
         uint64_t id();
 
+        /// @brief Owner count, changed atomically (also by SharedDataBlob directly).
         uint64_t counter();
         void increaseCounter();
 
         /// @brief Does not decrease below zero. 
-        void decreaseCounter();
+        /// @return counter after the decrease, 0 means the last owner is gone
+        uint64_t decreaseCounter();
 
         /// @brief Attempt to allocate memory using defined allocator. Return reference to new memory if successful. 
         /// Return invalid (.valid() == false) if not successful.
         static SharedDataCore allocate(IMemoryAllocator* memory_allocator, uint64_t size, uint64_t id) noexcept;
 
+        /// @brief Shared data over memory owned elsewhere (e.g. a mapped file), the memory is not freed with the object.
+        static SharedDataCore wrap(uint8_t* data, uint64_t size, uint64_t id) noexcept;
+
     private:
         SharedDataCore(IMemoryAllocator* memory_allocator, uint8_t* data, uint64_t size, uint64_t id);
     
@@ -40,6 +47,5 @@ namespace aergo::core::memory_allocation
         uint64_t size_;
         uint64_t id_;
         bool valid_;
-        uint64_t counter_;
     };
 }
\ No newline at end of file
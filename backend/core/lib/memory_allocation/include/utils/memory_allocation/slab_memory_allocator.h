@@ -0,0 +1,111 @@
+#pragma once
+
+#include "memory_allocator.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aergo::core::memory_allocation
+{
+    /// @brief Size-class slab allocator. Requests up to MAX_CLASS_SIZE bytes are rounded up to a power of two and served from slabs
+    /// (blocks of one size class carved from a single upstream allocation), freed blocks are recycled for the same size class.
+    /// Each thread caches a few blocks per size class in a magazine (threads are spread over SHARD_COUNT magazine shards),
+    /// so repeated allocations of similar sizes usually take only an uncontended lock. Magazines not refilled for longer than the idle
+    /// period are emptied and slabs unused for longer than the idle period are returned to the upstream allocator (checked on free,
+    /// or by calling releaseIdleSlabs). Larger requests go to the upstream allocator directly.
+    /// Thread safe.
+    class SlabMemoryAllocator : public IMemoryAllocator
+    {
+    public:
+        static constexpr size_t MIN_CLASS_SIZE = 64;
+        static constexpr size_t MAX_CLASS_SIZE = 1 << 20;
+
+        /// @param upstream allocator for slabs and large blocks, DefaultAllocator if nullptr
+        /// @param idle_release_ms completely unused slabs are returned to the upstream allocator after this time
+        SlabMemoryAllocator(IMemoryAllocator* upstream = nullptr, uint64_t idle_release_ms = 1000);
+
+        /// @brief Returns all slabs to the upstream allocator. Blocks must not be used afterwards.
+        ~SlabMemoryAllocator() override;
+
+        SlabMemoryAllocator(const SlabMemoryAllocator& other) = delete;
+        SlabMemoryAllocator& operator=(const SlabMemoryAllocator& other) = delete;
+
+        /// @return nullptr if the upstream allocator fails
+        void* malloc(size_t size) override;
+        void free(void* block) override;
+
+        /// @brief Move blocks out of idle magazines and return slabs without used blocks to the upstream allocator.
+        /// @param force also empty magazines and return slabs that are not idle long enough yet
+        void releaseIdleSlabs(bool force = false);
+
+        /// @brief Number of slabs currently held from the upstream allocator.
+        uint64_t slabCount();
+
+    private:
+        static constexpr uint32_t CLASS_COUNT = 15;                // 64 B .. 1 MiB
+        static constexpr uint32_t SHARD_COUNT = 16;
+        static constexpr uint32_t MAGAZINE_CAPACITY = 32;          // blocks per size class and shard (limited to MAGAZINE_BYTES)
+        static constexpr uint64_t MAGAZINE_BYTES = 256 * 1024;
+        static constexpr uint64_t SLAB_BYTES = 256 * 1024;         // minimum slab size, a slab has at least one block
+        static constexpr uint32_t LARGE_BLOCK = UINT32_MAX;        // BlockHeader::size_class_ of blocks from upstream directly
+
+        struct Slab;
+
+        /// @brief Precedes every block, keeps 16 B alignment of the returned memory.
+        struct alignas(16) BlockHeader
+        {
+            Slab* slab_;             // nullptr for large blocks
+            uint32_t size_class_;
+        };
+
+        struct Slab
+        {
+            uint8_t* memory_;
+            uint64_t bytes_;
+            uint32_t used_count_ = 0;     // blocks outside of the size class free list (used or cached in magazines)
+            uint64_t idle_since_ns_ = 0;  // last use of a returned block, the slab is idle since then once used_count_ is zero
+        };
+
+        struct SizeClass
+        {
+            std::mutex mutex_;
+            std::vector<std::unique_ptr<Slab>> slabs_;
+            std::vector<void*> free_blocks_;             // blocks (pointers after the header) not used by anyone
+            uint32_t blocks_per_slab_ = 1;
+            uint32_t magazine_capacity_ = 1;
+        };
+
+        struct Magazine
+        {
+            std::mutex mutex_;                                                  // uncontended unless threads share the shard
+            std::array<std::array<void*, MAGAZINE_CAPACITY>, CLASS_COUNT> blocks_;
+            std::array<uint32_t, CLASS_COUNT> counts_ {};
+            std::array<uint64_t, CLASS_COUNT> last_used_ns_ {};                 // time blocks were last put into the magazine
+        };
+
+        static uint32_t sizeClass(size_t size);                    // size must be <= MAX_CLASS_SIZE
+        static size_t classSize(uint32_t size_class) { return MIN_CLASS_SIZE << size_class; }
+        static uint32_t shardIndex();                               // magazine shard of the calling thread
+        static uint64_t nowNs();
+
+        /// @brief Move up to "count" free blocks to "out", creating a slab if needed. Call with size_class mutex locked.
+        /// @return number of blocks moved, 0 if the upstream allocator fails
+        uint32_t takeBlocks(uint32_t size_class, void** out, uint32_t count);
+        /// @brief Put blocks back to the free list. Call with size_class mutex locked.
+        /// @param used_ns time the blocks were last used, slabs without used blocks are idle since then
+        void returnBlocks(uint32_t size_class, void* const* blocks, uint32_t count, uint64_t used_ns);
+        void releaseSlabs(uint32_t size_class, bool force, uint64_t now_ns);          // call with size_class mutex locked
+
+        IMemoryAllocator* upstream_;
+        DefaultAllocator default_upstream_;
+        uint64_t idle_release_ns_;
+        std::atomic<uint64_t> next_release_check_ns_;
+
+        std::array<SizeClass, CLASS_COUNT> size_classes_;
+        std::array<Magazine, SHARD_COUNT> magazines_;
+    };
+}
\ No newline at end of file
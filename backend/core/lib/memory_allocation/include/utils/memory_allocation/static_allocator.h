@@ -4,29 +4,31 @@
 #include "utils/logging/logger.h"
 #include "shared_data_core.h"
 #include "allocator_interface_core.h"
+#include "memory_account.h"
 
 #include <vector>
-#include <deque>
-#include <set>
-#include <optional>
-#include <mutex>
+#include <atomic>
+#include <memory>
 
 
 namespace aergo::core::memory_allocation
 {
+    /// @brief Fixed number of fixed size slots, allocated up front. Lock-free: free slots are a tagged-index Treiber stack,
+    /// owners are counted atomically in the slot's SharedDataCore and pointers are validated by address range and index arithmetic.
     class StaticAllocator : public ICoreAllocator
     {
     public:
         class StaticAllocatorInitializationException : public std::exception {};
 
+        /// @param options alignment and page backing of the slots, used if custom_allocator is nullptr
+        /// @param account charged with the slots (reserved) and owned slots (live), must outlive the allocator, nullptr for no accounting
         /// @throws StaticAllocatorInitializationException if data could not be allocated.
-        StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator = nullptr);
+        StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator = nullptr,
+            aergo::module::AllocationOptions options = {}, MemoryAccount* account = nullptr);
+        ~StaticAllocator() override;
 
         StaticAllocator(const StaticAllocator& other) = delete;
-        StaticAllocator(StaticAllocator&& other) noexcept = default;
-
         StaticAllocator& operator=(const StaticAllocator& other) = delete;
-        StaticAllocator& operator=(StaticAllocator&& other) noexcept = default;
 
         /// @param number_of_bytes parameter is ignored, since we have fixed slots
         virtual aergo::module::ISharedData* allocate(uint64_t number_of_bytes) noexcept override final;
@@ -42,14 +44,25 @@ namespace aergo::core::memory_allocation
         void log(aergo::module::logging::LogType log_type, const char* message);
 
         IMemoryAllocator* memory_allocator_;
-        DefaultAllocator default_memory_allocator_;
+        AlignedMemoryAllocator default_memory_allocator_;
         aergo::core::logging::ILogger* logger_;
+        MemoryAccount* account_;
+        uint64_t slot_size_bytes_;
+
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+        /// @brief Index of the slot "data" points to, false if "data" does not point to the start of a slot.
+        bool slotIndex(aergo::module::ISharedData* data, uint32_t& idx);
+
+        uint32_t popFreeSlot(); // NO_SLOT if none is free
+        void pushFreeSlot(uint32_t idx);
 
         std::vector<SharedDataCore> preallocated_data_;
 
-        std::deque<std::size_t> free_memory_slot_ids_;
-        std::set<std::size_t> allocated_memory_slots_; // for checking pointer validity in addOwnerImpl / removeOwnerImpl
+        std::unique_ptr<std::atomic<bool>[]> slot_allocated_; // false for slots in the free stack
 
-        std::mutex mutex_;
+        // free slots stack, head is {uint32_t tag (upper bits), uint32_t slot index}, tag changes on every update (ABA protection)
+        std::atomic<uint64_t> free_head_;
+        std::unique_ptr<std::atomic<uint32_t>[]> free_next_; // next free slot below "idx", NO_SLOT at the bottom
     };
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "utils/memory_allocation/allocation_tracker.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+using namespace aergo::core::memory_allocation;
+
+
+
+AllocationTracker::AllocationTracker(uint32_t capacity)
+{
+    uint64_t bucket_count = std::bit_ceil(std::max<uint64_t>(1, (static_cast<uint64_t>(capacity) + BUCKET_SLOTS - 1) / BUCKET_SLOTS));
+    bucket_mask_ = bucket_count - 1;
+    buckets_ = std::make_unique<Bucket[]>(bucket_count);
+    samples_ = std::make_unique<aergo::module::AllocationSample[]>(bucket_count * BUCKET_SLOTS);
+
+    for (uint64_t i = 0; i < bucket_count; ++i)
+    {
+        for (auto& key : buckets_[i].keys_)
+        {
+            key.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+}
+
+
+
+void AllocationTracker::setSamplePeriod(uint32_t sample_period)
+{
+    sample_period_.store(sample_period, std::memory_order_relaxed);
+}
+
+
+
+uint32_t AllocationTracker::samplePeriod() const
+{
+    return sample_period_.load(std::memory_order_relaxed);
+}
+
+
+
+void AllocationTracker::allocated(aergo::module::ISharedData* shared_data, uint64_t module_id, uint64_t allocator_id)
+{
+    uint32_t sample_period = sample_period_.load(std::memory_order_relaxed);
+    if (sample_period == 0 || !shouldSample(sample_period))
+    {
+        return;
+    }
+
+    uint8_t* data = shared_data->data();
+    uint64_t size = shared_data->size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Bucket& data_bucket = bucket(data);
+    for (auto& key : data_bucket.keys_)
+    {
+        if (key.load(std::memory_order_relaxed) == nullptr)
+        {
+            samples_[slotIndex(&key)] = aergo::module::AllocationSample {
+                .module_id_ = module_id,
+                .allocator_id_ = allocator_id,
+                .size_bytes_ = size,
+                .allocated_ns_ = nowNs(),
+                .published_on_ = { .producer_module_id_ = UINT64_MAX, .producer_channel_id_ = UINT32_MAX }
+            };
+            key.store(data, std::memory_order_relaxed);
+            tracked_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+void AllocationTracker::released(aergo::module::ISharedData* shared_data)
+{
+    if (tracked_.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    uint8_t* data = shared_data->data();
+    std::atomic<uint8_t*>* key = findKey(data);
+    if (key == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (key->load(std::memory_order_relaxed) == data)
+    {
+        key->store(nullptr, std::memory_order_relaxed);
+        tracked_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+
+
+void AllocationTracker::published(uint8_t* data, aergo::module::ChannelIdentifier channel)
+{
+    if (tracked_.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    std::atomic<uint8_t*>* key = findKey(data);
+    if (key == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    aergo::module::AllocationSample& sample = samples_[slotIndex(key)];
+    if (key->load(std::memory_order_relaxed) == data && sample.published_on_.producer_module_id_ == UINT64_MAX)
+    {
+        sample.published_on_ = channel;
+    }
+}
+
+
+
+std::vector<aergo::module::AllocationSample> AllocationTracker::outstanding(uint64_t min_age_ns)
+{
+    std::vector<aergo::module::AllocationSample> result;
+    uint64_t now_ns = nowNs();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (uint64_t i = 0; i <= bucket_mask_; ++i)
+        {
+            for (auto& key : buckets_[i].keys_)
+            {
+                const aergo::module::AllocationSample& sample = samples_[slotIndex(&key)];
+                if (key.load(std::memory_order_relaxed) != nullptr && now_ns - sample.allocated_ns_ >= min_age_ns)
+                {
+                    result.push_back(sample);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](auto& a, auto& b) { return a.allocated_ns_ < b.allocated_ns_; });
+    return result;
+}
+
+
+
+bool AllocationTracker::hasSamples() const
+{
+    return tracked_.load(std::memory_order_relaxed) > 0;
+}
+
+
+
+uint64_t AllocationTracker::droppedSamples() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+
+
+uint64_t AllocationTracker::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+bool AllocationTracker::shouldSample(uint32_t sample_period)
+{
+    // per thread, so counting does not contend between allocating threads
+    thread_local uint32_t countdown = 0;
+    if (countdown == 0 || countdown > sample_period)
+    {
+        countdown = sample_period;
+    }
+    return --countdown == 0;
+}
+
+
+
+std::atomic<uint8_t*>* AllocationTracker::findKey(uint8_t* data)
+{
+    for (auto& key : bucket(data).keys_)
+    {
+        if (key.load(std::memory_order_relaxed) == data)
+        {
+            return &key;
+        }
+    }
+    return nullptr;
+}
+
+
+
+uint64_t AllocationTracker::slotIndex(std::atomic<uint8_t*>* key)
+{
+    Bucket* key_bucket = reinterpret_cast<Bucket*>(reinterpret_cast<uintptr_t>(key) & ~static_cast<uintptr_t>(alignof(Bucket) - 1));
+    return static_cast<uint64_t>(key_bucket - buckets_.get()) * BUCKET_SLOTS + static_cast<uint64_t>(key - key_bucket->keys_);
+}
+
+
+
+AllocationTracker::Bucket& AllocationTracker::bucket(uint8_t* data)
+{
+    // data is at least 16 byte aligned, the multiplier spreads neighbouring blocks over the buckets
+    uint64_t hash = (reinterpret_cast<uintptr_t>(data) >> 4) * 0x9E3779B97F4A7C15ull;
+    return buckets_[(hash >> 32) & bucket_mask_];
+}
\ No newline at end of file
@@ -4,8 +4,8 @@ using namespace aergo::core::memory_allocation;
 
 
 
-AllocatorWrapper::AllocatorWrapper(std::unique_ptr<ICoreAllocator> allocator)
-: allocator_(std::move(allocator)) {}
+AllocatorWrapper::AllocatorWrapper(std::unique_ptr<ICoreAllocator> allocator, AllocationTracker* tracker, uint64_t module_id, uint64_t allocator_id)
+: allocator_(std::move(allocator)), tracker_(tracker), module_id_(module_id), allocator_id_(allocator_id) {}
 
 
 
@@ -14,6 +14,10 @@ aergo::module::message::SharedDataBlob AllocatorWrapper::allocate(uint64_t numbe
     aergo::module::ISharedData* data = allocator_->allocate(number_of_bytes);
     if (data)
     {
+        if (tracker_ != nullptr)
+        {
+            tracker_->allocated(data, module_id_, allocator_id_);
+        }
         return aergo::module::message::SharedDataBlob(data, this);
     }
     else
@@ -33,5 +37,10 @@ void AllocatorWrapper::addOwner(aergo::module::ISharedData* data) noexcept
 
 void AllocatorWrapper::removeOwner(aergo::module::ISharedData* data) noexcept
 {
+    // core allocators count owners in the shared data (ICountedSharedData), so only the last owner gets here
+    if (tracker_ != nullptr && data != nullptr)
+    {
+        tracker_->released(data);
+    }
     allocator_->removeOwner(data);
 }
\ No newline at end of file
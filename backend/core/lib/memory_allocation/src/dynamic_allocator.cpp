@@ -4,13 +4,18 @@ using namespace aergo::core::memory_allocation;
 
 
 
-DynamicAllocator::DynamicAllocator(aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator)
-: allocation_id_(0), logger_(logger)
+DynamicAllocator::DynamicAllocator(aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator, aergo::module::AllocationOptions options,
+    MemoryAccount* account)
+: aligned_memory_allocator_(options), logger_(logger), account_(account), allocation_id_(0)
 {
     if (custom_allocator)
     {
         memory_allocator_ = custom_allocator;
     }
+    else if (!aligned_memory_allocator_.plainHeap())
+    {
+        memory_allocator_ = &aligned_memory_allocator_;
+    }
     else
     {
         memory_allocator_ = &default_memory_allocator_;
@@ -19,6 +24,21 @@ DynamicAllocator::DynamicAllocator(aergo::core::logging::ILogger* logger, IMemor
 
 
 
+DynamicAllocator::~DynamicAllocator()
+{
+    // data still owned is freed with the allocator
+    if (account_ != nullptr)
+    {
+        for (auto& [id, data] : allocated_data_)
+        {
+            account_->free(data.size());
+            account_->addReserved(-static_cast<int64_t>(data.size()));
+        }
+    }
+}
+
+
+
 aergo::module::ISharedData* DynamicAllocator::allocate(uint64_t number_of_bytes) noexcept { return allocateImpl(number_of_bytes); }
 void DynamicAllocator::addOwner(aergo::module::ISharedData* data) noexcept { addOwnerImpl(data); }
 void DynamicAllocator::removeOwner(aergo::module::ISharedData* data) noexcept { removeOwnerImpl(data); }
@@ -26,6 +46,11 @@ void DynamicAllocator::removeOwner(aergo::module::ISharedData* data) noexcept {
 
 aergo::module::ISharedData* DynamicAllocator::allocateImpl(uint64_t number_of_bytes)
 {
+    if (account_ != nullptr && !account_->tryAllocate(number_of_bytes))
+    {
+        return nullptr;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     
     uint64_t new_id = allocation_id_++;
@@ -40,11 +65,19 @@ aergo::module::ISharedData* DynamicAllocator::allocateImpl(uint64_t number_of_by
             std::move(new_data)  
         );
         allocated_memory_slots_.insert((std::size_t)(&it->second));
+        if (account_ != nullptr)
+        {
+            account_->addReserved(static_cast<int64_t>(number_of_bytes));
+        }
 
         return &it->second;
     }
     else
     {
+        if (account_ != nullptr)
+        {
+            account_->cancelAllocation(number_of_bytes);
+        }
         log(aergo::module::logging::LogType::ERROR, "Failed to allocate memory.");
         return nullptr;
     }
@@ -110,9 +143,13 @@ void DynamicAllocator::removeOwnerImpl(aergo::module::ISharedData* data)
         auto it = allocated_data_.find(data_core->id());
         if (it != allocated_data_.end() && (data == &it->second))
         {
-            data_core->decreaseCounter();
-            if (data_core->counter() == 0)
+            if (data_core->decreaseCounter() == 0)
             {
+                if (account_ != nullptr)
+                {
+                    account_->free(data_core->size());
+                    account_->addReserved(-static_cast<int64_t>(data_core->size()));
+                }
                 allocated_data_.erase(it);
                 allocated_memory_slots_.erase((std::size_t)data);
             }
@@ -0,0 +1,299 @@
+#include "utils/memory_allocation/elastic_allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+using namespace aergo::core::memory_allocation;
+
+
+
+ElasticAllocator::ElasticAllocator(uint64_t slot_size_bytes, aergo::module::ElasticBufferOptions options, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator,
+    aergo::module::AllocationOptions allocation_options, MemoryAccount* account)
+: default_memory_allocator_(allocation_options), logger_(logger), account_(account), slot_size_bytes_(slot_size_bytes), max_slots_(options.max_slots_), idle_trim_ns_(options.idle_trim_ms_ * 1'000'000)
+{
+    if (custom_allocator)
+    {
+        memory_allocator_ = custom_allocator;
+    }
+    else
+    {
+        memory_allocator_ = &default_memory_allocator_;
+    }
+
+    grow_slots_ = std::max<uint32_t>(1, (options.grow_slots_ > 0) ? options.grow_slots_ : options.min_slots_);
+
+    if (options.max_slots_ == 0 || options.max_slots_ < options.min_slots_)
+    {
+        log(aergo::module::logging::LogType::ERROR, "Invalid ElasticAllocator options.");
+        throw ElasticAllocatorInitializationException();
+    }
+
+    if (options.min_slots_ > 0 && !addChunk(options.min_slots_, false))
+    {
+        log(aergo::module::logging::LogType::ERROR, "Failed to initialize ElasticAllocator");
+        throw ElasticAllocatorInitializationException();
+    }
+}
+
+
+
+ElasticAllocator::~ElasticAllocator()
+{
+    // slots still owned are freed with the allocator
+    if (account_ != nullptr)
+    {
+        account_->free(slot_size_bytes_ * stats_.used_slots_);
+        account_->addReserved(-static_cast<int64_t>(slot_size_bytes_ * stats_.slots_));
+    }
+}
+
+
+
+aergo::module::ISharedData* ElasticAllocator::allocate([[maybe_unused]] uint64_t number_of_bytes) noexcept { return allocateImpl(); }
+void ElasticAllocator::addOwner(aergo::module::ISharedData* data) noexcept { addOwnerImpl(data); }
+void ElasticAllocator::removeOwner(aergo::module::ISharedData* data) noexcept { removeOwnerImpl(data); }
+
+
+
+aergo::module::ISharedData* ElasticAllocator::allocateImpl()
+{
+    // quota is checked before growing, so a module over its quota does not grow the pool
+    if (account_ != nullptr && !account_->tryAllocate(slot_size_bytes_))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = std::find_if(chunks_.begin(), chunks_.end(), [](auto& chunk) { return !chunk->free_slots_.empty(); });
+    if (it == chunks_.end())
+    {
+        uint32_t grow_by = std::min(grow_slots_, max_slots_ - stats_.slots_);
+        if (grow_by == 0 || !addChunk(grow_by, true))
+        {
+            ++stats_.exhausted_events_;
+            if (!exhausted_)
+            {
+                exhausted_ = true;
+                log(aergo::module::logging::LogType::WARNING, (grow_by == 0)
+                    ? ("ElasticAllocator exhausted, all " + std::to_string(max_slots_) + " slots are owned.").c_str()
+                    : "ElasticAllocator failed to grow.");
+            }
+
+            if (account_ != nullptr)
+            {
+                account_->cancelAllocation(slot_size_bytes_);
+            }
+            return nullptr;
+        }
+
+        ++stats_.grow_events_;
+        log(aergo::module::logging::LogType::INFO, ("ElasticAllocator grew to " + std::to_string(stats_.slots_) + " slots.").c_str());
+        it = chunks_.end() - 1;
+    }
+
+    Chunk& chunk = **it;
+    if (chunk.trimmable_ && chunk.free_slots_.size() == chunk.slots_.size())
+    {
+        --idle_chunks_;
+    }
+
+    uint32_t idx = chunk.free_slots_.back();
+    chunk.free_slots_.pop_back();
+    chunk.allocated_[idx] = true;
+    ++stats_.used_slots_;
+
+    if (idle_chunks_ > 0)
+    {
+        trimChunks(false, nowNs());
+    }
+
+    return &chunk.slots_[idx];
+}
+
+
+
+void ElasticAllocator::addOwnerImpl(aergo::module::ISharedData* data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Chunk* chunk;
+    uint32_t idx;
+    if (!findSlot(data, chunk, idx) || !chunk->allocated_[idx])
+    {
+        log(aergo::module::logging::LogType::ERROR, "Attempting to add owner on invalid or unowned data.");
+        return;
+    }
+
+    chunk->slots_[idx].increaseCounter();
+}
+
+
+
+void ElasticAllocator::removeOwnerImpl(aergo::module::ISharedData* data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Chunk* chunk;
+    uint32_t idx;
+    if (!findSlot(data, chunk, idx) || !chunk->allocated_[idx])
+    {
+        log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from invalid or unowned data.");
+        return;
+    }
+
+    if (chunk->slots_[idx].decreaseCounter() > 0)
+    {
+        return;
+    }
+
+    chunk->allocated_[idx] = false;
+    chunk->free_slots_.push_back(idx);
+    --stats_.used_slots_;
+    if (account_ != nullptr)
+    {
+        account_->free(slot_size_bytes_);
+    }
+    exhausted_ = false;
+
+    if (chunk->trimmable_ && chunk->free_slots_.size() == chunk->slots_.size())
+    {
+        chunk->idle_since_ns_ = nowNs();
+        ++idle_chunks_;
+    }
+
+    if (idle_chunks_ > 0)
+    {
+        trimChunks(false, nowNs());
+    }
+}
+
+
+
+ElasticAllocator::Stats ElasticAllocator::stats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+
+
+void ElasticAllocator::trimIdleChunks(bool force)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    trimChunks(force, nowNs());
+}
+
+
+
+bool ElasticAllocator::addChunk(uint32_t number_of_slots, bool trimmable)
+{
+    auto chunk = std::make_unique<Chunk>();
+    chunk->slots_.reserve(number_of_slots);
+    chunk->allocated_.resize(number_of_slots, false);
+    chunk->free_slots_.reserve(number_of_slots);
+    chunk->trimmable_ = trimmable;
+
+    for (uint32_t i = 0; i < number_of_slots; ++i)
+    {
+        chunk->slots_.emplace_back(SharedDataCore::allocate(memory_allocator_, slot_size_bytes_, next_slot_id_++));
+        if (!chunk->slots_.back().valid())
+        {
+            return false;
+        }
+
+        // lowest index on top of the free stack
+        chunk->free_slots_.push_back(number_of_slots - 1 - i);
+    }
+
+    if (default_memory_allocator_.lockFailures() > logged_lock_failures_)
+    {
+        logged_lock_failures_ = default_memory_allocator_.lockFailures();
+        log(aergo::module::logging::LogType::WARNING, "Failed to lock ElasticAllocator slots in memory.");
+    }
+
+    // counted as idle until its first slot is taken
+    if (trimmable)
+    {
+        chunk->idle_since_ns_ = nowNs();
+        ++idle_chunks_;
+    }
+
+    chunk_by_address_.emplace(reinterpret_cast<std::uintptr_t>(chunk->slots_.data()), chunk.get());
+    chunks_.push_back(std::move(chunk));
+
+    stats_.slots_ += number_of_slots;
+    if (account_ != nullptr)
+    {
+        account_->addReserved(static_cast<int64_t>(slot_size_bytes_ * number_of_slots));
+    }
+    stats_.peak_slots_ = std::max(stats_.peak_slots_, stats_.slots_);
+    return true;
+}
+
+
+
+bool ElasticAllocator::findSlot(aergo::module::ISharedData* data, Chunk*& chunk, uint32_t& idx)
+{
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+    auto it = chunk_by_address_.upper_bound(address);
+    if (it == chunk_by_address_.begin())
+    {
+        return false;
+    }
+    --it;
+
+    std::uintptr_t offset = address - it->first;
+    if (offset % sizeof(SharedDataCore) != 0 || offset / sizeof(SharedDataCore) >= it->second->slots_.size())
+    {
+        return false;
+    }
+
+    chunk = it->second;
+    idx = static_cast<uint32_t>(offset / sizeof(SharedDataCore));
+    return true;
+}
+
+
+
+void ElasticAllocator::trimChunks(bool force, uint64_t now_ns)
+{
+    uint32_t slots_before = stats_.slots_;
+
+    std::erase_if(chunks_, [&](const std::unique_ptr<Chunk>& chunk) {
+        if (!chunk->trimmable_ || chunk->free_slots_.size() != chunk->slots_.size() || (!force && now_ns - chunk->idle_since_ns_ < idle_trim_ns_))
+        {
+            return false;
+        }
+
+        chunk_by_address_.erase(reinterpret_cast<std::uintptr_t>(chunk->slots_.data()));
+        stats_.slots_ -= static_cast<uint32_t>(chunk->slots_.size());
+        if (account_ != nullptr)
+        {
+            account_->addReserved(-static_cast<int64_t>(slot_size_bytes_ * chunk->slots_.size()));
+        }
+        ++stats_.trim_events_;
+        --idle_chunks_;
+        return true;
+    });
+
+    if (stats_.slots_ != slots_before)
+    {
+        log(aergo::module::logging::LogType::INFO, ("ElasticAllocator trimmed to " + std::to_string(stats_.slots_) + " slots.").c_str());
+    }
+}
+
+
+
+uint64_t ElasticAllocator::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+void ElasticAllocator::log(aergo::module::logging::LogType log_type, const char* message)
+{
+    logger_->log(aergo::core::logging::SourceType::CORE, "ElasticAllocator", 0, log_type, message);
+}
\ No newline at end of file
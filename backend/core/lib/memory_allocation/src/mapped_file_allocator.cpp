@@ -0,0 +1,389 @@
+#include "utils/memory_allocation/mapped_file_allocator.h"
+
+#include <cstring>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace aergo::core::memory_allocation;
+
+
+
+MappedFileAllocator::MappedFileAllocator(const std::string& path, aergo::module::MappedFileOptions options, aergo::core::logging::ILogger* logger, MemoryAccount* account)
+: logger_(logger), account_(account), read_only_(options.read_only_)
+{
+    if (!read_only_ && options.capacity_bytes_ < sizeof(FileHeader))
+    {
+        log(aergo::module::logging::LogType::ERROR, "MappedFileAllocator capacity is smaller than the file header.");
+        throw MappedFileAllocatorInitializationException();
+    }
+
+    if (!mapFile(path, options.capacity_bytes_))
+    {
+        log(aergo::module::logging::LogType::ERROR, ("Failed to map file \"" + path + "\".").c_str());
+        unmapFile();
+        throw MappedFileAllocatorInitializationException();
+    }
+
+    header_ = reinterpret_cast<FileHeader*>(base_);
+    if (read_only_)
+    {
+        if (!readHeader())
+        {
+            log(aergo::module::logging::LogType::ERROR, ("File \"" + path + "\" is not a recorded file.").c_str());
+            unmapFile();
+            throw MappedFileAllocatorInitializationException();
+        }
+        read_offset_ = sizeof(FileHeader);
+    }
+    else
+    {
+        std::memcpy(header_->magic_, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header_->version_ = FILE_VERSION;
+        header_->record_alignment_ = RECORD_ALIGNMENT;
+        header_->used_bytes_ = sizeof(FileHeader);
+        header_->record_count_ = 0;
+    }
+}
+
+
+
+MappedFileAllocator::~MappedFileAllocator()
+{
+    // blobs still owned are freed with the allocator
+    if (account_ != nullptr)
+    {
+        for (auto& [address, data] : owned_data_)
+        {
+            account_->free(data->size());
+        }
+    }
+    owned_data_.clear();
+
+    unmapFile();
+}
+
+
+
+aergo::module::ISharedData* MappedFileAllocator::allocate(uint64_t number_of_bytes) noexcept { return allocateImpl(number_of_bytes); }
+void MappedFileAllocator::addOwner(aergo::module::ISharedData* data) noexcept { addOwnerImpl(data); }
+void MappedFileAllocator::removeOwner(aergo::module::ISharedData* data) noexcept { removeOwnerImpl(data); }
+
+
+
+aergo::module::ISharedData* MappedFileAllocator::allocateImpl(uint64_t number_of_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint8_t* data;
+    uint64_t size;
+    uint64_t id;
+
+    if (read_only_)
+    {
+        // the end of the file is not an error, the reader just got every record
+        if (read_count_ >= header_->record_count_)
+        {
+            return nullptr;
+        }
+
+        RecordHeader* record = reinterpret_cast<RecordHeader*>(base_ + read_offset_);
+        if (read_offset_ + sizeof(RecordHeader) > header_->used_bytes_ || record->magic_ != RECORD_MAGIC
+            || record->size_ > header_->used_bytes_ - read_offset_ - sizeof(RecordHeader))
+        {
+            log(aergo::module::logging::LogType::ERROR, "Corrupted record in mapped file.");
+            return nullptr;
+        }
+
+        data = base_ + read_offset_ + sizeof(RecordHeader);
+        size = record->size_;
+        id = record->id_;
+    }
+    else
+    {
+        uint64_t record_bytes = sizeof(RecordHeader) + alignUp(number_of_bytes);
+        if (number_of_bytes > mapped_bytes_ || record_bytes > mapped_bytes_ - header_->used_bytes_)
+        {
+            log(aergo::module::logging::LogType::ERROR, "Mapped file is full.");
+            if (account_ != nullptr)
+            {
+                account_->recordFailure();
+            }
+            return nullptr;
+        }
+
+        RecordHeader* record = reinterpret_cast<RecordHeader*>(base_ + header_->used_bytes_);
+        record->size_ = number_of_bytes;
+        record->id_ = header_->record_count_;
+        record->magic_ = RECORD_MAGIC;
+
+        data = base_ + header_->used_bytes_ + sizeof(RecordHeader);
+        size = number_of_bytes;
+        id = record->id_;
+    }
+
+    if (account_ != nullptr && !account_->tryAllocate(size))
+    {
+        return nullptr;
+    }
+
+    // the record is committed only once the allocation can not fail anymore
+    if (read_only_)
+    {
+        read_offset_ += sizeof(RecordHeader) + alignUp(size);
+        ++read_count_;
+    }
+    else
+    {
+        header_->used_bytes_ += sizeof(RecordHeader) + alignUp(size);
+        ++header_->record_count_;
+    }
+
+    auto data_core = std::make_unique<SharedDataCore>(SharedDataCore::wrap(data, size, id));
+    aergo::module::ISharedData* address = data_core.get();
+    owned_data_.emplace(address, std::move(data_core));
+    return address;
+}
+
+
+
+void MappedFileAllocator::addOwnerImpl(aergo::module::ISharedData* data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = owned_data_.find(data);
+    if (it == owned_data_.end())
+    {
+        log(aergo::module::logging::LogType::ERROR, "Attempting to add owner on invalid or unowned data.");
+        return;
+    }
+
+    it->second->increaseCounter();
+}
+
+
+
+void MappedFileAllocator::removeOwnerImpl(aergo::module::ISharedData* data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = owned_data_.find(data);
+    if (it == owned_data_.end())
+    {
+        log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from invalid or unowned data.");
+        return;
+    }
+
+    if (it->second->decreaseCounter() == 0)
+    {
+        if (account_ != nullptr)
+        {
+            account_->free(it->second->size());
+        }
+        owned_data_.erase(it);
+    }
+}
+
+
+
+bool MappedFileAllocator::flush()
+{
+    if (read_only_)
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+#if defined(_WIN32)
+    return FlushViewOfFile(base_, static_cast<SIZE_T>(header_->used_bytes_)) && FlushFileBuffers(static_cast<HANDLE>(file_));
+#else
+    return msync(base_, header_->used_bytes_, MS_SYNC) == 0;
+#endif
+}
+
+
+
+uint64_t MappedFileAllocator::recordCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_->record_count_;
+}
+
+
+
+uint64_t MappedFileAllocator::usedBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_->used_bytes_;
+}
+
+
+
+bool MappedFileAllocator::mapFile(const std::string& path, uint64_t capacity_bytes)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), read_only_ ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE), FILE_SHARE_READ, nullptr,
+        read_only_ ? OPEN_EXISTING : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if (read_only_)
+    {
+        if (!GetFileSizeEx(file, &size))
+        {
+            return false;
+        }
+        capacity_bytes = static_cast<uint64_t>(size.QuadPart);
+    }
+    else
+    {
+        // NTFS allocates the whole size unless the file is marked sparse
+        DWORD returned;
+        DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr);
+
+        size.QuadPart = static_cast<LONGLONG>(capacity_bytes);
+        if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+        {
+            return false;
+        }
+    }
+
+    if (capacity_bytes < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    mapping_ = CreateFileMappingA(file, nullptr, read_only_ ? PAGE_WRITECOPY : PAGE_READWRITE, 0, 0, nullptr);
+    if (mapping_ == nullptr)
+    {
+        return false;
+    }
+
+    base_ = static_cast<uint8_t*>(MapViewOfFile(static_cast<HANDLE>(mapping_), read_only_ ? FILE_MAP_COPY : FILE_MAP_WRITE, 0, 0, 0));
+    if (base_ == nullptr)
+    {
+        return false;
+    }
+#else
+    file_ = read_only_ ? open(path.c_str(), O_RDONLY) : open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file_ < 0)
+    {
+        return false;
+    }
+
+    if (read_only_)
+    {
+        struct stat file_stat;
+        if (fstat(file_, &file_stat) != 0)
+        {
+            return false;
+        }
+        capacity_bytes = static_cast<uint64_t>(file_stat.st_size);
+    }
+    else if (ftruncate(file_, static_cast<off_t>(capacity_bytes)) != 0)   // holes are not backed by disk space (sparse)
+    {
+        return false;
+    }
+
+    if (capacity_bytes < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    // private writable mapping for reading, modules may modify blobs without touching the file
+    void* base = mmap(nullptr, capacity_bytes, PROT_READ | PROT_WRITE, read_only_ ? MAP_PRIVATE : MAP_SHARED, file_, 0);
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(base);
+#endif
+
+    mapped_bytes_ = capacity_bytes;
+    return true;
+}
+
+
+
+void MappedFileAllocator::unmapFile()
+{
+    uint64_t used_bytes = (header_ != nullptr) ? header_->used_bytes_ : 0;
+
+#if defined(_WIN32)
+    if (base_ != nullptr)
+    {
+        UnmapViewOfFile(base_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+    if (file_ != nullptr)
+    {
+        if (!read_only_ && used_bytes > 0)
+        {
+            LARGE_INTEGER size;
+            size.QuadPart = static_cast<LONGLONG>(used_bytes);
+            SetFilePointerEx(static_cast<HANDLE>(file_), size, nullptr, FILE_BEGIN);
+            SetEndOfFile(static_cast<HANDLE>(file_));
+        }
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (base_ != nullptr)
+    {
+        munmap(base_, mapped_bytes_);
+    }
+    if (file_ >= 0)
+    {
+        // drop the unused capacity, the file ends with the last record
+        if (!read_only_ && used_bytes > 0 && ftruncate(file_, static_cast<off_t>(used_bytes)) != 0)
+        {
+            log(aergo::module::logging::LogType::WARNING, "Failed to truncate mapped file.");
+        }
+        close(file_);
+    }
+    file_ = -1;
+#endif
+
+    base_ = nullptr;
+    header_ = nullptr;
+    mapped_bytes_ = 0;
+}
+
+
+
+bool MappedFileAllocator::readHeader()
+{
+    return std::memcmp(header_->magic_, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 && header_->version_ == FILE_VERSION
+        && header_->record_alignment_ == RECORD_ALIGNMENT && header_->used_bytes_ >= sizeof(FileHeader) && header_->used_bytes_ <= mapped_bytes_;
+}
+
+
+
+uint64_t MappedFileAllocator::alignUp(uint64_t bytes)
+{
+    return (bytes + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+
+
+void MappedFileAllocator::log(aergo::module::logging::LogType log_type, const char* message)
+{
+    logger_->log(aergo::core::logging::SourceType::CORE, "MappedFileAllocator", 0, log_type, message);
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "utils/memory_allocation/memory_account.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace aergo::core::memory_allocation;
+
+
+
+MemoryAccount::MemoryAccount(MemoryAccount* parent)
+: parent_(parent), window_start_ns_(nowNs()) {}
+
+
+
+bool MemoryAccount::tryAllocate(uint64_t bytes)
+{
+    if (!charge(bytes))
+    {
+        recordFailure();
+        return false;
+    }
+    return true;
+}
+
+
+
+bool MemoryAccount::charge(uint64_t bytes)
+{
+    uint64_t live = live_bytes_.load(std::memory_order_relaxed);
+    do
+    {
+        uint64_t quota = quota_bytes_.load(std::memory_order_relaxed);
+        if (quota != 0 && live + bytes > quota)
+        {
+            return false;
+        }
+    }
+    while (!live_bytes_.compare_exchange_weak(live, live + bytes, std::memory_order_relaxed));
+
+    if (parent_ != nullptr && !parent_->charge(bytes))
+    {
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        return false;
+    }
+
+    // all quotas passed, count the allocation
+    uint64_t peak = peak_live_bytes_.load(std::memory_order_relaxed);
+    while (live + bytes > peak && !peak_live_bytes_.compare_exchange_weak(peak, live + bytes, std::memory_order_relaxed)) {}
+
+    allocation_count_.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    updateRate(bytes);
+    return true;
+}
+
+
+
+void MemoryAccount::cancelAllocation(uint64_t bytes)
+{
+    for (MemoryAccount* account = this; account != nullptr; account = account->parent_)
+    {
+        account->live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        account->allocation_count_.fetch_sub(1, std::memory_order_relaxed);
+        account->allocated_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    recordFailure();
+}
+
+
+
+void MemoryAccount::recordFailure()
+{
+    for (MemoryAccount* account = this; account != nullptr; account = account->parent_)
+    {
+        account->failed_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+
+void MemoryAccount::free(uint64_t bytes)
+{
+    for (MemoryAccount* account = this; account != nullptr; account = account->parent_)
+    {
+        account->live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
+
+
+
+void MemoryAccount::addReserved(int64_t bytes)
+{
+    for (MemoryAccount* account = this; account != nullptr; account = account->parent_)
+    {
+        account->reserved_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+
+
+void MemoryAccount::setQuota(uint64_t quota_bytes)
+{
+    quota_bytes_.store(quota_bytes, std::memory_order_relaxed);
+}
+
+
+
+aergo::module::MemoryStats MemoryAccount::stats() const
+{
+    return aergo::module::MemoryStats {
+        .live_bytes_ = live_bytes_.load(std::memory_order_relaxed),
+        .peak_live_bytes_ = peak_live_bytes_.load(std::memory_order_relaxed),
+        .reserved_bytes_ = static_cast<uint64_t>(std::max<int64_t>(0, reserved_bytes_.load(std::memory_order_relaxed))),
+        .allocation_count_ = allocation_count_.load(std::memory_order_relaxed),
+        .allocated_bytes_ = allocated_bytes_.load(std::memory_order_relaxed),
+        .failed_count_ = failed_count_.load(std::memory_order_relaxed),
+        .quota_bytes_ = quota_bytes_.load(std::memory_order_relaxed),
+        .allocations_per_second_ = allocations_per_second_.load(std::memory_order_relaxed),
+        .allocated_bytes_per_second_ = allocated_bytes_per_second_.load(std::memory_order_relaxed)
+    };
+}
+
+
+
+uint64_t MemoryAccount::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+void MemoryAccount::updateRate(uint64_t bytes)
+{
+    window_allocations_.fetch_add(1, std::memory_order_relaxed);
+    window_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+
+    uint64_t now_ns = nowNs();
+    uint64_t window_start_ns = window_start_ns_.load(std::memory_order_relaxed);
+    if (now_ns - window_start_ns >= 1'000'000'000 && window_start_ns_.compare_exchange_strong(window_start_ns, now_ns, std::memory_order_relaxed))
+    {
+        // allocations racing with the window switch may land in either window
+        double seconds = (now_ns - window_start_ns) / 1e9;
+        allocations_per_second_.store(window_allocations_.exchange(0, std::memory_order_relaxed) / seconds, std::memory_order_relaxed);
+        allocated_bytes_per_second_.store(window_bytes_.exchange(0, std::memory_order_relaxed) / seconds, std::memory_order_relaxed);
+    }
+}
\ No newline at end of file
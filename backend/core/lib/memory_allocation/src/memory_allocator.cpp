@@ -1,6 +1,18 @@
 #include "utils/memory_allocation/memory_allocator.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
 
 using namespace aergo::core::memory_allocation;
 
@@ -16,4 +28,207 @@ void* DefaultAllocator::malloc(size_t size)
 void DefaultAllocator::free(void* block)
 {
     std::free(block);
+}
+
+
+AlignedMemoryAllocator::AlignedMemoryAllocator(aergo::module::AllocationOptions options)
+: options_(options), mapped_(options.huge_pages_ || options.prefault_ || options.lock_memory_) {}
+
+
+
+AlignedMemoryAllocator::~AlignedMemoryAllocator()
+{
+    for (auto& [block, mapping] : mappings_)
+    {
+        unmap(mapping);
+    }
+}
+
+
+
+void* AlignedMemoryAllocator::malloc(size_t size)
+{
+    if ((options_.alignment_ & (options_.alignment_ - 1)) != 0)
+    {
+        return nullptr;
+    }
+
+    if (mapped_)
+    {
+        return mapBlock(size);
+    }
+
+    if (options_.alignment_ <= alignof(std::max_align_t))
+    {
+        return std::malloc(size);
+    }
+
+    return ::operator new(size, std::align_val_t(options_.alignment_), std::nothrow);
+}
+
+
+
+void AlignedMemoryAllocator::free(void* block)
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    if (mapped_)
+    {
+        Mapping mapping;
+        {
+            std::lock_guard<std::mutex> lock(mappings_mutex_);
+            auto it = mappings_.find(block);
+            if (it == mappings_.end())
+            {
+                return;
+            }
+            mapping = it->second;
+            mappings_.erase(it);
+        }
+        unmap(mapping);
+    }
+    else if (options_.alignment_ <= alignof(std::max_align_t))
+    {
+        std::free(block);
+    }
+    else
+    {
+        ::operator delete(block, std::align_val_t(options_.alignment_));
+    }
+}
+
+
+
+bool AlignedMemoryAllocator::plainHeap() const
+{
+    return !mapped_ && options_.alignment_ == 0;
+}
+
+
+
+uint64_t AlignedMemoryAllocator::lockFailures() const
+{
+    return lock_failures_.load(std::memory_order_relaxed);
+}
+
+
+
+void* AlignedMemoryAllocator::mapBlock(size_t size)
+{
+    // mappings are page aligned, larger alignments are reached by mapping more and skipping the start
+    size_t page_size = pageSize();
+    size_t extra = (options_.alignment_ > page_size) ? options_.alignment_ : 0;
+    size_t length = (std::max<size_t>(size, 1) + extra + page_size - 1) / page_size * page_size;
+    void* base = nullptr;
+
+#if defined(_WIN32)
+    if (options_.huge_pages_)
+    {
+        // needs SeLockMemoryPrivilege, falls back to regular pages
+        size_t large_page_size = GetLargePageMinimum();
+        if (large_page_size > 0)
+        {
+            size_t large_length = (length + large_page_size - 1) / large_page_size * large_page_size;
+            base = VirtualAlloc(nullptr, large_length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            length = (base != nullptr) ? large_length : length;
+        }
+    }
+
+    if (base == nullptr)
+    {
+        base = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (base == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    if (options_.lock_memory_ && !VirtualLock(base, length))
+    {
+        lock_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+#else
+#if defined(MAP_HUGETLB)
+    if (options_.huge_pages_)
+    {
+        // explicit huge pages need reserved pages (vm.nr_hugepages), transparent huge pages are the fallback
+        constexpr size_t huge_page_size = 2 * 1024 * 1024;
+        size_t huge_length = (length + huge_page_size - 1) / huge_page_size * huge_page_size;
+        base = mmap(nullptr, huge_length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            base = nullptr;
+        }
+        else
+        {
+            length = huge_length;
+        }
+    }
+#endif
+
+    if (base == nullptr)
+    {
+        base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+#if defined(MADV_HUGEPAGE)
+        if (options_.huge_pages_)
+        {
+            madvise(base, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // locking faults the pages in as well
+    if (options_.lock_memory_ && mlock(base, length) != 0)
+    {
+        lock_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+
+    if (options_.prefault_)
+    {
+        volatile uint8_t* bytes = static_cast<uint8_t*>(base);
+        for (size_t offset = 0; offset < length; offset += page_size)
+        {
+            bytes[offset] = 0;
+        }
+    }
+
+    uintptr_t alignment = (options_.alignment_ > 0) ? options_.alignment_ : 1;
+    void* block = reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(base) + alignment - 1) / alignment * alignment);
+
+    std::lock_guard<std::mutex> lock(mappings_mutex_);
+    mappings_.emplace(block, Mapping { .base_ = base, .length_ = length });
+    return block;
+}
+
+
+
+void AlignedMemoryAllocator::unmap(Mapping mapping)
+{
+#if defined(_WIN32)
+    VirtualFree(mapping.base_, 0, MEM_RELEASE);
+#else
+    munmap(mapping.base_, mapping.length_);
+#endif
+}
+
+
+
+size_t AlignedMemoryAllocator::pageSize()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
 }
\ No newline at end of file
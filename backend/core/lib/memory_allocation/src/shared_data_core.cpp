@@ -5,12 +5,12 @@ using namespace aergo::core::memory_allocation;
 
 
 SharedDataCore::SharedDataCore() noexcept
-: memory_allocator_(nullptr), data_(nullptr), size_(0), id_(0), valid_(false), counter_(0) {}
+: memory_allocator_(nullptr), data_(nullptr), size_(0), id_(0), valid_(false) {}
 
 
 
 SharedDataCore::SharedDataCore(IMemoryAllocator* memory_allocator, uint8_t* data, uint64_t size, uint64_t id) 
-: memory_allocator_(memory_allocator), data_(data), size_(size), id_(id), valid_(true), counter_(0) {}
+: memory_allocator_(memory_allocator), data_(data), size_(size), id_(id), valid_(true) {}
 
 
 
@@ -18,28 +18,33 @@ SharedDataCore::~SharedDataCore()
 {
     if (valid_)
     {
-        memory_allocator_->free(data_);
+        if (memory_allocator_ != nullptr)
+        {
+            memory_allocator_->free(data_);
+        }
         
         memory_allocator_ = nullptr;
         valid_ = false;
         data_ = nullptr;
         size_ = 0;
         id_ = 0;
-        counter_ = 0;
+        owners_.store(0, std::memory_order_relaxed);
     }
 }
 
 
 
 SharedDataCore::SharedDataCore(SharedDataCore&& other) noexcept
-: memory_allocator_(other.memory_allocator_), data_(other.data_), size_(other.size_), id_(other.id_), valid_(other.valid_), counter_(other.counter_)
+: memory_allocator_(other.memory_allocator_), data_(other.data_), size_(other.size_), id_(other.id_), valid_(other.valid_)
 {
+    owners_.store(other.owners_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
     other.memory_allocator_ = nullptr;
     other.data_ = nullptr;
     other.size_ = 0;
     other.id_ = 0;
     other.valid_ = false;
-    other.counter_ = 0;
+    other.owners_.store(0, std::memory_order_relaxed);
 }
 
 
@@ -52,13 +57,13 @@ SharedDataCore& SharedDataCore::operator=(SharedDataCore&& other) noexcept
         size_ = other.size_;
         id_ = other.id_;
         valid_ = other.valid_;
-        counter_ = other.counter_;
+        owners_.store(other.owners_.load(std::memory_order_relaxed), std::memory_order_relaxed);
         other.memory_allocator_ = nullptr;
         other.data_ = nullptr;
         other.size_ = 0;
         other.id_ = 0;
         other.valid_ = false;
-        other.counter_ = 0;
+        other.owners_.store(0, std::memory_order_relaxed);
     }
     return *this;
 }
@@ -86,6 +91,13 @@ uint64_t SharedDataCore::size() noexcept
 
 
 
+aergo::module::ICountedSharedData* SharedDataCore::counted() noexcept
+{
+    return valid_ ? this : nullptr;
+}
+
+
+
 uint64_t SharedDataCore::id()
 {
     return id_;
@@ -95,7 +107,7 @@ uint64_t SharedDataCore::id()
 
 uint64_t SharedDataCore::counter()
 {
-    return counter_;
+    return owners_.load(std::memory_order_acquire);
 }
 
 
@@ -104,18 +116,25 @@ void SharedDataCore::increaseCounter()
 {
     if (valid_)
     {
-        ++counter_;
+        owners_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
 
 
-void SharedDataCore::decreaseCounter()
+uint64_t SharedDataCore::decreaseCounter()
 {
-    if (counter_ > 0 && valid_)
+    uint64_t owners = owners_.load(std::memory_order_relaxed);
+    while (owners > 0 && valid_)
     {
-        --counter_;
+        // acquire: the owner that frees the data sees the writes of all previous owners
+        if (owners_.compare_exchange_weak(owners, owners - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return owners - 1;
+        }
     }
+
+    return owners;
 }
 
 
@@ -131,4 +150,11 @@ SharedDataCore SharedDataCore::allocate(IMemoryAllocator* allocator, uint64_t si
     {
         return SharedDataCore();
     }
+}
+
+
+
+SharedDataCore SharedDataCore::wrap(uint8_t* data, uint64_t size, uint64_t id) noexcept
+{
+    return SharedDataCore(nullptr, data, size, id);
 }
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "utils/memory_allocation/slab_memory_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <new>
+
+using namespace aergo::core::memory_allocation;
+
+
+
+SlabMemoryAllocator::SlabMemoryAllocator(IMemoryAllocator* upstream, uint64_t idle_release_ms)
+: upstream_(upstream ? upstream : &default_upstream_), idle_release_ns_(idle_release_ms * 1'000'000), next_release_check_ns_(0)
+{
+    for (uint32_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        uint64_t stride = sizeof(BlockHeader) + classSize(i);
+        size_classes_[i].blocks_per_slab_ = static_cast<uint32_t>(std::max<uint64_t>(1, SLAB_BYTES / stride));
+        size_classes_[i].magazine_capacity_ = static_cast<uint32_t>(std::clamp<uint64_t>(MAGAZINE_BYTES / classSize(i), 1, MAGAZINE_CAPACITY));
+    }
+}
+
+
+
+SlabMemoryAllocator::~SlabMemoryAllocator()
+{
+    for (auto& size_class : size_classes_)
+    {
+        for (auto& slab : size_class.slabs_)
+        {
+            upstream_->free(slab->memory_);
+        }
+    }
+}
+
+
+
+void* SlabMemoryAllocator::malloc(size_t size)
+{
+    if (size > MAX_CLASS_SIZE)
+    {
+        uint8_t* memory = static_cast<uint8_t*>(upstream_->malloc(sizeof(BlockHeader) + size));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        new (memory) BlockHeader { .slab_ = nullptr, .size_class_ = LARGE_BLOCK };
+        return memory + sizeof(BlockHeader);
+    }
+
+    uint32_t size_class = sizeClass(size);
+    Magazine& magazine = magazines_[shardIndex()];
+    std::lock_guard<std::mutex> magazine_lock(magazine.mutex_);
+
+    uint32_t& count = magazine.counts_[size_class];
+    if (count == 0)
+    {
+        // refill half of the magazine, so alternating malloc/free does not go to the size class every time
+        SizeClass& target_class = size_classes_[size_class];
+        std::lock_guard<std::mutex> class_lock(target_class.mutex_);
+        count = takeBlocks(size_class, magazine.blocks_[size_class].data(), std::max<uint32_t>(1, target_class.magazine_capacity_ / 2));
+        if (count == 0)
+        {
+            return nullptr;
+        }
+        magazine.last_used_ns_[size_class] = nowNs();
+    }
+
+    return magazine.blocks_[size_class][--count];
+}
+
+
+
+void SlabMemoryAllocator::free(void* block)
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(block) - sizeof(BlockHeader));
+    if (header->size_class_ == LARGE_BLOCK)
+    {
+        upstream_->free(header);
+        return;
+    }
+
+    uint32_t size_class = header->size_class_;
+    SizeClass& target_class = size_classes_[size_class];
+    uint64_t now_ns = nowNs();
+
+    {
+        Magazine& magazine = magazines_[shardIndex()];
+        std::lock_guard<std::mutex> magazine_lock(magazine.mutex_);
+
+        uint32_t& count = magazine.counts_[size_class];
+        if (count == target_class.magazine_capacity_)
+        {
+            // keep the newer half cached (likely still in the CPU cache), return the older half
+            uint32_t returned = std::max<uint32_t>(1, count / 2);
+            std::lock_guard<std::mutex> class_lock(target_class.mutex_);
+            returnBlocks(size_class, magazine.blocks_[size_class].data(), returned, now_ns);
+            std::copy(magazine.blocks_[size_class].begin() + returned, magazine.blocks_[size_class].begin() + count, magazine.blocks_[size_class].begin());
+            count -= returned;
+        }
+
+        magazine.blocks_[size_class][count++] = block;
+        magazine.last_used_ns_[size_class] = now_ns;
+    }
+
+    uint64_t next_check_ns = next_release_check_ns_.load(std::memory_order_relaxed);
+    if (now_ns >= next_check_ns && next_release_check_ns_.compare_exchange_strong(next_check_ns, now_ns + std::max<uint64_t>(idle_release_ns_ / 2, 1'000'000)))
+    {
+        releaseIdleSlabs(false);
+    }
+}
+
+
+
+void SlabMemoryAllocator::releaseIdleSlabs(bool force)
+{
+    uint64_t now_ns = nowNs();
+
+    // cached blocks keep their slabs used, so magazines of threads that stopped allocating are emptied first
+    for (auto& magazine : magazines_)
+    {
+        std::lock_guard<std::mutex> magazine_lock(magazine.mutex_);
+        for (uint32_t i = 0; i < CLASS_COUNT; ++i)
+        {
+            uint64_t used_ns = magazine.last_used_ns_[i];
+            if (magazine.counts_[i] > 0 && (force || (now_ns >= used_ns && now_ns - used_ns >= idle_release_ns_)))
+            {
+                std::lock_guard<std::mutex> class_lock(size_classes_[i].mutex_);
+                returnBlocks(i, magazine.blocks_[i].data(), magazine.counts_[i], used_ns);
+                magazine.counts_[i] = 0;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        std::lock_guard<std::mutex> class_lock(size_classes_[i].mutex_);
+        releaseSlabs(i, force, now_ns);
+    }
+}
+
+
+
+uint64_t SlabMemoryAllocator::slabCount()
+{
+    uint64_t count = 0;
+    for (auto& size_class : size_classes_)
+    {
+        std::lock_guard<std::mutex> class_lock(size_class.mutex_);
+        count += size_class.slabs_.size();
+    }
+    return count;
+}
+
+
+
+uint32_t SlabMemoryAllocator::sizeClass(size_t size)
+{
+    if (size <= MIN_CLASS_SIZE)
+    {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(std::bit_width(size - 1) - std::bit_width(MIN_CLASS_SIZE - 1));
+}
+
+
+
+uint32_t SlabMemoryAllocator::shardIndex()
+{
+    static std::atomic<uint32_t> next_thread_index{0};
+    thread_local uint32_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return thread_index % SHARD_COUNT;
+}
+
+
+
+uint64_t SlabMemoryAllocator::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+uint32_t SlabMemoryAllocator::takeBlocks(uint32_t size_class, void** out, uint32_t count)
+{
+    SizeClass& target_class = size_classes_[size_class];
+
+    if (target_class.free_blocks_.empty())
+    {
+        uint64_t stride = sizeof(BlockHeader) + classSize(size_class);
+        uint64_t bytes = stride * target_class.blocks_per_slab_;
+        uint8_t* memory = static_cast<uint8_t*>(upstream_->malloc(bytes));
+        if (memory == nullptr)
+        {
+            return 0;
+        }
+
+        target_class.slabs_.push_back(std::make_unique<Slab>(Slab { .memory_ = memory, .bytes_ = bytes }));
+        Slab* slab = target_class.slabs_.back().get();
+
+        // reversed, so blocks are handed out in address order
+        for (uint32_t i = target_class.blocks_per_slab_; i-- > 0;)
+        {
+            uint8_t* block_memory = memory + i * stride;
+            new (block_memory) BlockHeader { .slab_ = slab, .size_class_ = size_class };
+            target_class.free_blocks_.push_back(block_memory + sizeof(BlockHeader));
+        }
+    }
+
+    uint32_t taken = 0;
+    while (taken < count && !target_class.free_blocks_.empty())
+    {
+        void* block = target_class.free_blocks_.back();
+        target_class.free_blocks_.pop_back();
+
+        Slab* slab = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(block) - sizeof(BlockHeader))->slab_;
+        ++slab->used_count_;
+        out[taken++] = block;
+    }
+
+    return taken;
+}
+
+
+
+void SlabMemoryAllocator::returnBlocks(uint32_t size_class, void* const* blocks, uint32_t count, uint64_t used_ns)
+{
+    SizeClass& target_class = size_classes_[size_class];
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Slab* slab = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(blocks[i]) - sizeof(BlockHeader))->slab_;
+        --slab->used_count_;
+
+        // blocks returned from idle magazines may be older than blocks of the same slab returned before
+        slab->idle_since_ns_ = std::max(slab->idle_since_ns_, used_ns);
+        target_class.free_blocks_.push_back(blocks[i]);
+    }
+}
+
+
+
+void SlabMemoryAllocator::releaseSlabs(uint32_t size_class, bool force, uint64_t now_ns)
+{
+    SizeClass& target_class = size_classes_[size_class];
+
+    auto releasable = [&](const Slab* slab) {
+        return slab->used_count_ == 0 && (force || (now_ns >= slab->idle_since_ns_ && now_ns - slab->idle_since_ns_ >= idle_release_ns_));
+    };
+
+    if (std::none_of(target_class.slabs_.begin(), target_class.slabs_.end(), [&](const std::unique_ptr<Slab>& slab) { return releasable(slab.get()); }))
+    {
+        return;
+    }
+
+    // drop free blocks of released slabs, then the slabs themselves
+    std::erase_if(target_class.free_blocks_, [&](void* block) {
+        return releasable(reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(block) - sizeof(BlockHeader))->slab_);
+    });
+
+    std::erase_if(target_class.slabs_, [&](const std::unique_ptr<Slab>& slab) {
+        if (!releasable(slab.get()))
+        {
+            return false;
+        }
+
+        upstream_->free(slab->memory_);
+        return true;
+    });
+}
\ No newline at end of file
@@ -4,8 +4,9 @@ using namespace aergo::core::memory_allocation;
 
 
 
-StaticAllocator::StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator)
-: logger_(logger)
+StaticAllocator::StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, aergo::core::logging::ILogger* logger, IMemoryAllocator* custom_allocator,
+    aergo::module::AllocationOptions options, MemoryAccount* account)
+: default_memory_allocator_(options), logger_(logger), account_(account), slot_size_bytes_(slot_size_bytes)
 {
     if (custom_allocator)
     {
@@ -17,6 +18,8 @@ StaticAllocator::StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_sl
     }
 
     preallocated_data_.reserve(number_of_slots);
+    slot_allocated_ = std::make_unique<std::atomic<bool>[]>(number_of_slots);
+    free_next_ = std::make_unique<std::atomic<uint32_t>[]>(number_of_slots);
 
     for (uint32_t i = 0; i < number_of_slots; ++i)
     {
@@ -27,7 +30,39 @@ StaticAllocator::StaticAllocator(uint64_t slot_size_bytes, uint32_t number_of_sl
             throw StaticAllocatorInitializationException();
         }
 
-        free_memory_slot_ids_.push_back(i);
+        slot_allocated_[i].store(false, std::memory_order_relaxed);
+        free_next_[i].store((i + 1 < number_of_slots) ? i + 1 : NO_SLOT, std::memory_order_relaxed);
+    }
+
+    if (memory_allocator_ == &default_memory_allocator_ && default_memory_allocator_.lockFailures() > 0)
+    {
+        log(aergo::module::logging::LogType::WARNING, "Failed to lock StaticAllocator slots in memory.");
+    }
+
+    // slots are handed out in index order first
+    free_head_.store((number_of_slots > 0) ? 0 : NO_SLOT, std::memory_order_release);
+
+    if (account_ != nullptr)
+    {
+        account_->addReserved(static_cast<int64_t>(slot_size_bytes_ * number_of_slots));
+    }
+}
+
+
+
+StaticAllocator::~StaticAllocator()
+{
+    if (account_ != nullptr)
+    {
+        // slots still owned are freed with the allocator
+        for (uint32_t i = 0; i < preallocated_data_.size(); ++i)
+        {
+            if (slot_allocated_[i].load(std::memory_order_relaxed))
+            {
+                account_->free(slot_size_bytes_);
+            }
+        }
+        account_->addReserved(-static_cast<int64_t>(slot_size_bytes_ * preallocated_data_.size()));
     }
 }
 
@@ -41,88 +76,133 @@ void StaticAllocator::removeOwner(aergo::module::ISharedData* data) noexcept { r
 
 aergo::module::ISharedData* StaticAllocator::allocateImpl()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (free_memory_slot_ids_.empty())
+    if (account_ != nullptr && !account_->tryAllocate(slot_size_bytes_))
     {
         return nullptr;
     }
 
-    size_t free_id = free_memory_slot_ids_.front();
-    free_memory_slot_ids_.pop_front();
-
-    allocated_memory_slots_.insert((size_t)(&preallocated_data_[free_id]));
+    uint32_t idx = popFreeSlot();
+    if (idx == NO_SLOT)
+    {
+        if (account_ != nullptr)
+        {
+            account_->cancelAllocation(slot_size_bytes_);
+        }
+        return nullptr;
+    }
 
-    return &preallocated_data_[free_id];
+    slot_allocated_[idx].store(true, std::memory_order_release);
+    return &preallocated_data_[idx];
 }
 
 
 
 void StaticAllocator::addOwnerImpl(aergo::module::ISharedData* data)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (!allocated_memory_slots_.contains((std::size_t)data))
+    uint32_t idx;
+    if (!slotIndex(data, idx))
     {
         log(aergo::module::logging::LogType::ERROR, "Attempting to add owner on invalid or unowned data.");
         return;
     }
-    
-    SharedDataCore* data_core = dynamic_cast<SharedDataCore*>(data);
 
-    if (data_core && data_core->valid())
-    {
-        data_core->increaseCounter();
-    }
-    else if (!data)
-    {
-        log(aergo::module::logging::LogType::ERROR, "Attempting to add owner to nullptr.");
-    }
-    else if (!data_core)
-    {
-        log(aergo::module::logging::LogType::ERROR, "Dynamic cast failed in add owner");
-    }
-    else if (!data_core->valid())
+    if (!slot_allocated_[idx].load(std::memory_order_acquire))
     {
-        log(aergo::module::logging::LogType::ERROR, "Attempting to add owner to invalid data.");
+        log(aergo::module::logging::LogType::ERROR, "Attempting to add owner on invalid or unowned data.");
+        return;
     }
+
+    preallocated_data_[idx].increaseCounter();
 }
 
 
 
 void StaticAllocator::removeOwnerImpl(aergo::module::ISharedData* data)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-     if (!allocated_memory_slots_.contains((std::size_t)data))
+    uint32_t idx;
+    if (!slotIndex(data, idx))
     {
         log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from invalid or unowned data.");
         return;
     }
 
-    SharedDataCore* data_core = dynamic_cast<SharedDataCore*>(data);
+    if (!slot_allocated_[idx].load(std::memory_order_acquire))
+    {
+        log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from invalid or unowned data.");
+        return;
+    }
 
-    if (data_core && data_core->valid())
+    // last owner (or none yet) frees the slot, exchange makes sure it is pushed only once
+    if (preallocated_data_[idx].decreaseCounter() == 0 && slot_allocated_[idx].exchange(false, std::memory_order_acq_rel))
     {
-        data_core->decreaseCounter();
-        if (data_core->counter() == 0)
+        pushFreeSlot(idx);
+        if (account_ != nullptr)
         {
-            free_memory_slot_ids_.push_back(data_core->id());
-            allocated_memory_slots_.erase((std::size_t)data);
+            account_->free(slot_size_bytes_);
         }
     }
-    else if (!data)
+}
+
+
+
+bool StaticAllocator::slotIndex(aergo::module::ISharedData* data, uint32_t& idx)
+{
+    if (preallocated_data_.empty())
+    {
+        return false;
+    }
+
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(preallocated_data_.data());
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+    if (address < begin || (address - begin) % sizeof(SharedDataCore) != 0)
+    {
+        return false;
+    }
+
+    std::uintptr_t offset = (address - begin) / sizeof(SharedDataCore);
+    if (offset >= preallocated_data_.size())
     {
-        log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from nullptr.");
+        return false;
     }
-    else if (!data_core)
+
+    idx = static_cast<uint32_t>(offset);
+    return true;
+}
+
+
+
+uint32_t StaticAllocator::popFreeSlot()
+{
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (true)
     {
-        log(aergo::module::logging::LogType::ERROR, "Dynamic cast failed in remove owner.");
+        uint32_t idx = static_cast<uint32_t>(head);
+        if (idx == NO_SLOT)
+        {
+            return NO_SLOT;
+        }
+
+        // may read a stale next if "idx" was popped meanwhile, the tag makes the exchange fail then
+        uint64_t new_head = (((head >> 32) + 1) << 32) | free_next_[idx].load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return idx;
+        }
     }
-    else if (!data_core->valid())
+}
+
+
+
+void StaticAllocator::pushFreeSlot(uint32_t idx)
+{
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do
     {
-        log(aergo::module::logging::LogType::ERROR, "Attempting to remove owner from invalid data.");
+        free_next_[idx].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        new_head = (((head >> 32) + 1) << 32) | idx;
     }
+    while (!free_head_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
 }
 
 
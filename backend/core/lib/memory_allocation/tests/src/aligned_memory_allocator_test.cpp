@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_logger.h"
+#include "utils/memory_allocation/memory_allocator.h"
+#include "utils/memory_allocation/static_allocator.h"
+#include "utils/memory_allocation/dynamic_allocator.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+namespace
+{
+    bool aligned(void* block, uint64_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(block) % alignment == 0;
+    }
+}
+
+
+
+TEST_CASE( "AlignedMemoryAllocator", "[aligned_memory_allocator]" )
+{
+    SECTION("default options")
+    {
+        AlignedMemoryAllocator allocator;
+        REQUIRE(allocator.plainHeap());
+
+        void* block = allocator.malloc(100);
+        REQUIRE(block != nullptr);
+        std::memset(block, 1, 100);
+        allocator.free(block);
+        allocator.free(nullptr);
+    }
+
+    SECTION("invalid alignment")
+    {
+        AlignedMemoryAllocator allocator({ .alignment_ = 48 });
+        REQUIRE(allocator.malloc(100) == nullptr);
+
+        AlignedMemoryAllocator mapped_allocator({ .alignment_ = 48, .prefault_ = true });
+        REQUIRE(mapped_allocator.malloc(100) == nullptr);
+    }
+
+    for (uint64_t alignment : { 64, 4096, 2 * 1024 * 1024 })
+    {
+        for (bool mapped : { false, true })
+        {
+            DYNAMIC_SECTION("alignment " << alignment << (mapped ? " mapped" : " heap"))
+            {
+                AlignedMemoryAllocator allocator({ .alignment_ = alignment, .prefault_ = mapped });
+                REQUIRE_FALSE(allocator.plainHeap());
+
+                std::vector<void*> blocks;
+                for (size_t size : { 1, 100, 5000, 1280 * 720 * 3 })
+                {
+                    void* block = allocator.malloc(size);
+                    REQUIRE(block != nullptr);
+                    REQUIRE(aligned(block, alignment));
+                    std::memset(block, 1, size);
+                    blocks.push_back(block);
+                }
+
+                for (void* block : blocks)
+                {
+                    allocator.free(block);
+                }
+            }
+        }
+    }
+
+    SECTION("huge pages and locking fall back")
+    {
+        // without reserved huge pages or enough RLIMIT_MEMLOCK the memory is still usable
+        AlignedMemoryAllocator allocator({ .alignment_ = 64, .huge_pages_ = true, .prefault_ = true, .lock_memory_ = true });
+        size_t size = 1280 * 720 * 3;
+        void* block = allocator.malloc(size);
+        REQUIRE(block != nullptr);
+        REQUIRE(aligned(block, 64));
+        std::memset(block, 1, size);
+        allocator.free(block);
+
+        // not freed blocks are unmapped by the destructor
+        REQUIRE(allocator.malloc(size) != nullptr);
+    }
+
+    SECTION("buffer and dynamic allocator options")
+    {
+        TestLogger logger;
+        StaticAllocator static_allocator(1280 * 720 * 3, 4, &logger, nullptr, { .alignment_ = 4096, .prefault_ = true });
+        REQUIRE(logger.logs().size() == 0);
+        for (int i = 0; i < 4; ++i)
+        {
+            aergo::module::ISharedData* data = static_allocator.allocateImpl();
+            REQUIRE(data != nullptr);
+            REQUIRE(aligned(data->data(), 4096));
+        }
+
+        DynamicAllocator dynamic_allocator(&logger, nullptr, { .alignment_ = 64 });
+        aergo::module::ISharedData* data = dynamic_allocator.allocateImpl(1000);
+        REQUIRE(data != nullptr);
+        REQUIRE(aligned(data->data(), 64));
+        dynamic_allocator.removeOwnerImpl(data);
+
+        REQUIRE_THROWS_AS(StaticAllocator(1000, 4, &logger, nullptr, { .alignment_ = 3 }), StaticAllocator::StaticAllocatorInitializationException);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_logger.h"
+#include "utils/memory_allocation/allocation_tracker.h"
+#include "utils/memory_allocation/allocator_wrapper.h"
+#include "utils/memory_allocation/dynamic_allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+TEST_CASE( "AllocationTracker", "[allocation_tracker]" )
+{
+    TestLogger logger;
+    DynamicAllocator allocator(&logger);
+
+    SECTION("sampling")
+    {
+        AllocationTracker tracker;
+        std::vector<aergo::module::ISharedData*> allocated_data;
+        for (int i = 0; i < 100; ++i)
+        {
+            allocated_data.push_back(allocator.allocateImpl(100));
+            tracker.allocated(allocated_data.back(), 7, 1);
+        }
+        REQUIRE_FALSE(tracker.hasSamples());
+
+        tracker.setSamplePeriod(4);
+        for (int i = 0; i < 100; ++i)
+        {
+            tracker.allocated(allocated_data[i], 7, 1);
+        }
+        REQUIRE(tracker.outstanding(0).size() == 25);
+
+        for (auto data : allocated_data)
+        {
+            tracker.released(data);
+            allocator.removeOwnerImpl(data);
+        }
+        REQUIRE_FALSE(tracker.hasSamples());
+        REQUIRE(tracker.outstanding(0).empty());
+    }
+
+    SECTION("samples")
+    {
+        AllocationTracker tracker;
+        tracker.setSamplePeriod(1);
+
+        aergo::module::ISharedData* first = allocator.allocateImpl(100);
+        tracker.allocated(first, 7, 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        aergo::module::ISharedData* second = allocator.allocateImpl(200);
+        tracker.allocated(second, 8, 2);
+
+        tracker.published(second->data(), { .producer_module_id_ = 8, .producer_channel_id_ = 3 });
+        tracker.published(second->data(), { .producer_module_id_ = 9, .producer_channel_id_ = 0 });
+        tracker.published(second->data() + 1, { .producer_module_id_ = 9, .producer_channel_id_ = 0 });
+
+        auto samples = tracker.outstanding(0);
+        REQUIRE(samples.size() == 2);
+        REQUIRE(samples[0].module_id_ == 7);
+        REQUIRE(samples[0].allocator_id_ == 1);
+        REQUIRE(samples[0].size_bytes_ == 100);
+        REQUIRE(samples[0].published_on_.producer_module_id_ == UINT64_MAX);
+        REQUIRE(samples[1].module_id_ == 8);
+        REQUIRE(samples[1].size_bytes_ == 200);
+        REQUIRE(samples[1].published_on_ == aergo::module::ChannelIdentifier { .producer_module_id_ = 8, .producer_channel_id_ = 3 });
+        REQUIRE(samples[1].allocated_ns_ > samples[0].allocated_ns_);
+
+        // only the older one is 10 ms old
+        samples = tracker.outstanding(10'000'000);
+        REQUIRE(samples.size() == 1);
+        REQUIRE(samples[0].module_id_ == 7);
+
+        tracker.released(first);
+        REQUIRE(tracker.outstanding(0).size() == 1);
+        tracker.released(second);
+        REQUIRE_FALSE(tracker.hasSamples());
+
+        allocator.removeOwnerImpl(first);
+        allocator.removeOwnerImpl(second);
+    }
+
+    SECTION("full table")
+    {
+        // single bucket
+        AllocationTracker tracker(8);
+        tracker.setSamplePeriod(1);
+
+        std::vector<aergo::module::ISharedData*> allocated_data;
+        for (int i = 0; i < 10; ++i)
+        {
+            allocated_data.push_back(allocator.allocateImpl(100));
+            tracker.allocated(allocated_data.back(), 7, 1);
+        }
+        REQUIRE(tracker.outstanding(0).size() == 8);
+        REQUIRE(tracker.droppedSamples() == 2);
+
+        for (auto data : allocated_data)
+        {
+            tracker.released(data);
+            allocator.removeOwnerImpl(data);
+        }
+        REQUIRE_FALSE(tracker.hasSamples());
+    }
+
+    SECTION("allocator wrapper")
+    {
+        AllocationTracker tracker;
+        tracker.setSamplePeriod(1);
+        AllocatorWrapper wrapper(std::make_unique<DynamicAllocator>(&logger), &tracker, 7, 3);
+
+        {
+            auto blob = wrapper.allocate(100);
+            REQUIRE(blob.valid());
+            {
+                auto copy = blob;
+                auto view = blob.view(10, 10);
+            }
+            REQUIRE(tracker.outstanding(0).size() == 1);
+            REQUIRE(tracker.outstanding(0)[0].allocator_id_ == 3);
+        }
+        REQUIRE_FALSE(tracker.hasSamples());
+    }
+
+    REQUIRE(logger.logs().size() == 0);
+}
+
+
+
+namespace
+{
+    /// @brief Best of several rounds, to filter out scheduling noise.
+    double allocateReleaseNs(AllocatorWrapper& wrapper)
+    {
+        constexpr int ROUNDS = 10;
+        constexpr int ITERATIONS = 200'000;
+        double best_ns = 0;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < ITERATIONS; ++i)
+            {
+                auto blob = wrapper.allocate(1024);
+                blob.data()[0] = 1;
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+            best_ns = (round == 0) ? ns : std::min(best_ns, ns);
+        }
+        return best_ns;
+    }
+}
+
+
+
+TEST_CASE( "AllocationTracker overhead", "[.][benchmark][allocation_tracker]" )
+{
+    TestLogger logger;
+    AllocationTracker tracker;
+    AllocatorWrapper untracked(std::make_unique<DynamicAllocator>(&logger));
+    AllocatorWrapper tracked(std::make_unique<DynamicAllocator>(&logger), &tracker, 7, 1);
+
+    // warm up the slabs
+    allocateReleaseNs(untracked);
+    allocateReleaseNs(tracked);
+
+    double baseline_ns = allocateReleaseNs(untracked);
+    std::cout << "untracked: " << baseline_ns << " ns per allocation" << std::endl;
+    for (uint32_t sample_period : { 0u, 1024u, 64u, 1u })
+    {
+        tracker.setSamplePeriod(sample_period);
+        double ns = allocateReleaseNs(tracked);
+        std::cout << "sample period " << sample_period << ": " << ns << " ns per allocation ("
+            << (ns / baseline_ns - 1.0) * 100.0 << " % overhead)" << std::endl;
+    }
+
+    REQUIRE_FALSE(tracker.hasSamples());
+}
\ No newline at end of file
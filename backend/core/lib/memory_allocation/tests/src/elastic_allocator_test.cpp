@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_memory_allocator.h"
+#include "test_logger.h"
+#include "utils/memory_allocation/elastic_allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+namespace
+{
+    uint64_t countFrees(TestMemoryAllocator& memory_allocator)
+    {
+        return std::count_if(memory_allocator.operations().begin(), memory_allocator.operations().end(),
+            [](auto& op) { return op.type_ == TestMemoryAllocator::Op::Type::FREE; });
+    }
+}
+
+
+
+TEST_CASE( "ElasticAllocator", "[elastic_allocator]" )
+{
+    TestLogger logger;
+    uint64_t slot_size_bytes = 1000;
+
+    SECTION("invalid options and broken allocator")
+    {
+        TestMemoryAllocator memory_allocator(false);
+        REQUIRE_THROWS_AS(ElasticAllocator(slot_size_bytes, { .min_slots_ = 4, .max_slots_ = 2 }, &logger), ElasticAllocator::ElasticAllocatorInitializationException);
+        REQUIRE_THROWS_AS(ElasticAllocator(slot_size_bytes, { .min_slots_ = 0, .max_slots_ = 0 }, &logger), ElasticAllocator::ElasticAllocatorInitializationException);
+        REQUIRE_THROWS_AS(ElasticAllocator(slot_size_bytes, { .min_slots_ = 4, .max_slots_ = 8 }, &logger, &memory_allocator), ElasticAllocator::ElasticAllocatorInitializationException);
+        REQUIRE(logger.logs().size() == 3);
+
+        // no initial slots, growing fails
+        ElasticAllocator elastic_allocator(slot_size_bytes, { .min_slots_ = 0, .max_slots_ = 8 }, &logger, &memory_allocator);
+        REQUIRE(elastic_allocator.allocateImpl() == nullptr);
+        REQUIRE(elastic_allocator.allocateImpl() == nullptr);
+        REQUIRE(elastic_allocator.stats().exhausted_events_ == 2);
+        REQUIRE(logger.logs().size() == 4);
+        REQUIRE(logger.logs()[3] == aergo::module::logging::LogType::WARNING);
+    }
+
+    SECTION("grows under pressure up to the maximum")
+    {
+        TestMemoryAllocator memory_allocator(true);
+        ElasticAllocator elastic_allocator(slot_size_bytes, { .min_slots_ = 4, .max_slots_ = 10, .grow_slots_ = 4, .idle_trim_ms_ = 60'000 }, &logger, &memory_allocator);
+        REQUIRE(elastic_allocator.stats().slots_ == 4);
+        REQUIRE(logger.logs().size() == 0);
+
+        std::vector<aergo::module::ISharedData*> allocated_data;
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            aergo::module::ISharedData* data = elastic_allocator.allocateImpl();
+            REQUIRE(data != nullptr);
+            REQUIRE(data->valid());
+            REQUIRE(data->size() == slot_size_bytes);
+            REQUIRE(std::find(allocated_data.begin(), allocated_data.end(), data) == allocated_data.end());
+            allocated_data.push_back(data);
+        }
+
+        // 4 + 4 + 2 (limited by max_slots_)
+        auto stats = elastic_allocator.stats();
+        REQUIRE(stats.slots_ == 10);
+        REQUIRE(stats.used_slots_ == 10);
+        REQUIRE(stats.peak_slots_ == 10);
+        REQUIRE(stats.grow_events_ == 2);
+        REQUIRE(memory_allocator.operations().size() == 10);
+
+        // exhaustion is logged once per episode
+        REQUIRE(elastic_allocator.allocateImpl() == nullptr);
+        REQUIRE(elastic_allocator.allocateImpl() == nullptr);
+        REQUIRE(elastic_allocator.stats().exhausted_events_ == 2);
+        REQUIRE(std::count(logger.logs().begin(), logger.logs().end(), aergo::module::logging::LogType::WARNING) == 1);
+
+        elastic_allocator.removeOwnerImpl(allocated_data[0]);
+        REQUIRE(elastic_allocator.allocateImpl() == allocated_data[0]);
+        REQUIRE(elastic_allocator.allocateImpl() == nullptr);
+        REQUIRE(std::count(logger.logs().begin(), logger.logs().end(), aergo::module::logging::LogType::WARNING) == 2);
+
+        // owners are counted
+        elastic_allocator.addOwnerImpl(allocated_data[9]);
+        elastic_allocator.addOwnerImpl(allocated_data[9]);
+        elastic_allocator.removeOwnerImpl(allocated_data[9]);
+        REQUIRE(elastic_allocator.stats().used_slots_ == 10);
+        elastic_allocator.removeOwnerImpl(allocated_data[9]);
+        REQUIRE(elastic_allocator.stats().used_slots_ == 9);
+
+        // not idle long enough
+        for (uint32_t i = 4; i < 9; ++i)
+        {
+            elastic_allocator.removeOwnerImpl(allocated_data[i]);
+        }
+        elastic_allocator.trimIdleChunks();
+        REQUIRE(elastic_allocator.stats().slots_ == 10);
+
+        // the initial chunk stays
+        elastic_allocator.trimIdleChunks(true);
+        stats = elastic_allocator.stats();
+        REQUIRE(stats.slots_ == 4);
+        REQUIRE(stats.used_slots_ == 4);
+        REQUIRE(stats.trim_events_ == 2);
+        REQUIRE(stats.peak_slots_ == 10);
+        REQUIRE(countFrees(memory_allocator) == 6);
+        REQUIRE(std::count(logger.logs().begin(), logger.logs().end(), aergo::module::logging::LogType::ERROR) == 0);
+    }
+
+    SECTION("partially used chunks are not trimmed")
+    {
+        TestMemoryAllocator memory_allocator(true);
+        ElasticAllocator elastic_allocator(slot_size_bytes, { .min_slots_ = 1, .max_slots_ = 10, .grow_slots_ = 3, .idle_trim_ms_ = 0 }, &logger, &memory_allocator);
+
+        aergo::module::ISharedData* first = elastic_allocator.allocateImpl();
+        aergo::module::ISharedData* second = elastic_allocator.allocateImpl();
+        aergo::module::ISharedData* third = elastic_allocator.allocateImpl();
+        REQUIRE(elastic_allocator.stats().slots_ == 4);
+
+        elastic_allocator.removeOwnerImpl(second);
+        REQUIRE(elastic_allocator.stats().slots_ == 4);
+
+        // zero idle time, freed with the last owned slot
+        elastic_allocator.removeOwnerImpl(third);
+        REQUIRE(elastic_allocator.stats().slots_ == 1);
+        REQUIRE(countFrees(memory_allocator) == 3);
+
+        elastic_allocator.removeOwnerImpl(first);
+        REQUIRE(elastic_allocator.stats().slots_ == 1);
+    }
+
+    SECTION("idle chunks are trimmed on later calls")
+    {
+        TestMemoryAllocator memory_allocator(true);
+        ElasticAllocator elastic_allocator(slot_size_bytes, { .min_slots_ = 1, .max_slots_ = 4, .idle_trim_ms_ = 1 }, &logger, &memory_allocator);
+
+        aergo::module::ISharedData* first = elastic_allocator.allocateImpl();
+        aergo::module::ISharedData* second = elastic_allocator.allocateImpl();
+        REQUIRE(elastic_allocator.stats().slots_ == 2);
+        elastic_allocator.removeOwnerImpl(second);
+        REQUIRE(elastic_allocator.stats().slots_ == 2);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        elastic_allocator.removeOwnerImpl(first);
+        REQUIRE(elastic_allocator.stats().slots_ == 1);
+    }
+
+    SECTION("invalid data")
+    {
+        TestMemoryAllocator memory_allocator(true);
+        ElasticAllocator elastic_allocator(slot_size_bytes, { .min_slots_ = 2, .max_slots_ = 2 }, &logger, &memory_allocator);
+        aergo::module::ISharedData* data = elastic_allocator.allocateImpl();
+
+        REQUIRE_NOTHROW(elastic_allocator.addOwnerImpl(nullptr));
+        REQUIRE_NOTHROW(elastic_allocator.removeOwnerImpl(nullptr));
+        REQUIRE_NOTHROW(elastic_allocator.removeOwnerImpl(reinterpret_cast<aergo::module::ISharedData*>(reinterpret_cast<uint8_t*>(data) + 1)));
+        REQUIRE_NOTHROW(elastic_allocator.removeOwnerImpl(reinterpret_cast<aergo::module::ISharedData*>(&logger)));
+
+        // second slot is free
+        elastic_allocator.removeOwnerImpl(data);
+        REQUIRE_NOTHROW(elastic_allocator.removeOwnerImpl(data));
+        REQUIRE(logger.logs().size() == 5);
+        for (auto log_type : logger.logs())
+        {
+            REQUIRE(log_type == aergo::module::logging::LogType::ERROR);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_logger.h"
+#include "utils/memory_allocation/mapped_file_allocator.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+namespace
+{
+    /// @brief File name in the temp directory unique to this run, so concurrent test runs do not share files.
+    /// Files starting with the name are removed on destruction, also when a REQUIRE fails.
+    class TempFile
+    {
+    public:
+        TempFile()
+        {
+            std::random_device random;
+            path_ = (std::filesystem::temp_directory_path() / ("aergo_mapped_file_allocator_test_" + std::to_string(random()) + "_" + std::to_string(random()) + ".bin")).string();
+        }
+
+        ~TempFile()
+        {
+            std::error_code error;
+            for (const char* suffix : { "", ".2", ".missing" })
+            {
+                std::filesystem::remove(path_ + suffix, error);
+            }
+        }
+
+        std::string path_;
+    };
+}
+
+
+
+TEST_CASE( "MappedFileAllocator", "[mapped_file_allocator]" )
+{
+    TestLogger logger;
+    TempFile temp_file;
+    const std::string& path = temp_file.path_;
+
+    SECTION("written blobs are read back")
+    {
+        {
+            MappedFileAllocator writer(path, { .capacity_bytes_ = 1024 * 1024 }, &logger);
+            for (uint8_t i = 0; i < 5; ++i)
+            {
+                aergo::module::ISharedData* data = writer.allocateImpl(100 + i);
+                REQUIRE(data != nullptr);
+                REQUIRE(data->size() == 100 + i);
+                REQUIRE(reinterpret_cast<uintptr_t>(data->data()) % MappedFileAllocator::RECORD_ALIGNMENT == 0);
+                std::memset(data->data(), i + 1, data->size());
+
+                // blobs stay in the file after their owners are gone
+                writer.addOwnerImpl(data);
+                writer.removeOwnerImpl(data);
+            }
+            REQUIRE(writer.recordCount() == 5);
+            REQUIRE(writer.flush());
+        }
+
+        // truncated to header + 5 records with 128 B of data each
+        REQUIRE(std::filesystem::file_size(path) == 64 + 5 * (64 + 128));
+
+        MappedFileAllocator reader(path, { .read_only_ = true }, &logger);
+        REQUIRE(reader.recordCount() == 5);
+
+        std::vector<aergo::module::ISharedData*> blobs;
+        for (uint8_t i = 0; i < 5; ++i)
+        {
+            aergo::module::ISharedData* data = reader.allocateImpl(0);
+            REQUIRE(data != nullptr);
+            REQUIRE(data->size() == 100 + i);
+            REQUIRE(data->data()[0] == i + 1);
+            REQUIRE(data->data()[data->size() - 1] == i + 1);
+            blobs.push_back(data);
+        }
+        REQUIRE(reader.allocateImpl(0) == nullptr);
+
+        // changes are private to the reader
+        blobs[0]->data()[0] = 42;
+        MappedFileAllocator second_reader(path, { .read_only_ = true }, &logger);
+        REQUIRE(second_reader.allocateImpl(0)->data()[0] == 1);
+
+        REQUIRE(logger.logs().size() == 0);
+    }
+
+    SECTION("full file and accounting")
+    {
+        MemoryAccount account;
+        MappedFileAllocator writer(path, { .capacity_bytes_ = 64 + 2 * (64 + 1024) }, &logger, &account);
+
+        aergo::module::ISharedData* first = writer.allocateImpl(1024);
+        REQUIRE(first != nullptr);
+        REQUIRE(writer.allocateImpl(1024) != nullptr);
+        REQUIRE(account.stats().live_bytes_ == 2048);
+
+        REQUIRE(writer.allocateImpl(1) == nullptr);
+        REQUIRE(account.stats().failed_count_ == 1);
+        REQUIRE(logger.logs().size() == 1);
+
+        writer.removeOwnerImpl(first);
+        REQUIRE(account.stats().live_bytes_ == 1024);
+        REQUIRE(writer.usedBytes() == 64 + 2 * (64 + 1024));
+
+        account.setQuota(1024);
+        MappedFileAllocator second_writer(path + ".2", { .capacity_bytes_ = 4096 }, &logger, &account);
+        REQUIRE(second_writer.allocateImpl(1) == nullptr);
+        REQUIRE(second_writer.recordCount() == 0);
+    }
+
+    SECTION("invalid files and data")
+    {
+        REQUIRE_THROWS_AS(MappedFileAllocator(path, { .capacity_bytes_ = 8 }, &logger), MappedFileAllocator::MappedFileAllocatorInitializationException);
+        REQUIRE_THROWS_AS(MappedFileAllocator(path + ".missing", { .read_only_ = true }, &logger), MappedFileAllocator::MappedFileAllocatorInitializationException);
+
+        {
+            std::ofstream file(path, std::ios::binary);
+            std::vector<char> garbage(1024, 'x');
+            file.write(garbage.data(), garbage.size());
+        }
+        REQUIRE_THROWS_AS(MappedFileAllocator(path, { .read_only_ = true }, &logger), MappedFileAllocator::MappedFileAllocatorInitializationException);
+
+        MappedFileAllocator writer(path, { .capacity_bytes_ = 4096 }, &logger);
+        aergo::module::ISharedData* data = writer.allocateImpl(10);
+        REQUIRE_NOTHROW(writer.addOwnerImpl(nullptr));
+        REQUIRE_NOTHROW(writer.removeOwnerImpl(reinterpret_cast<aergo::module::ISharedData*>(&logger)));
+        writer.removeOwnerImpl(data);
+        REQUIRE_NOTHROW(writer.removeOwnerImpl(data));
+        REQUIRE(logger.logs().size() == 6);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_memory_allocator.h"
+#include "test_logger.h"
+#include "utils/memory_allocation/memory_account.h"
+#include "utils/memory_allocation/dynamic_allocator.h"
+#include "utils/memory_allocation/static_allocator.h"
+#include "utils/memory_allocation/elastic_allocator.h"
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+TEST_CASE( "MemoryAccount", "[memory_account]" )
+{
+    MemoryAccount module_account;
+    MemoryAccount first_account(&module_account);
+    MemoryAccount second_account(&module_account);
+
+    SECTION("charges parents")
+    {
+        REQUIRE(first_account.tryAllocate(100));
+        REQUIRE(second_account.tryAllocate(50));
+        first_account.addReserved(1000);
+
+        REQUIRE(first_account.stats().live_bytes_ == 100);
+        REQUIRE(first_account.stats().reserved_bytes_ == 1000);
+        REQUIRE(module_account.stats().live_bytes_ == 150);
+        REQUIRE(module_account.stats().reserved_bytes_ == 1000);
+        REQUIRE(module_account.stats().allocation_count_ == 2);
+        REQUIRE(module_account.stats().allocated_bytes_ == 150);
+
+        first_account.free(100);
+        REQUIRE(first_account.stats().live_bytes_ == 0);
+        REQUIRE(first_account.stats().peak_live_bytes_ == 100);
+        REQUIRE(module_account.stats().live_bytes_ == 50);
+        REQUIRE(module_account.stats().peak_live_bytes_ == 150);
+    }
+
+    SECTION("quota of the module limits all its allocators")
+    {
+        module_account.setQuota(100);
+        REQUIRE(first_account.tryAllocate(60));
+        REQUIRE_FALSE(second_account.tryAllocate(50));
+
+        // failed allocation is not charged anywhere
+        REQUIRE(second_account.stats().live_bytes_ == 0);
+        REQUIRE(second_account.stats().allocation_count_ == 0);
+        REQUIRE(second_account.stats().allocated_bytes_ == 0);
+        REQUIRE(second_account.stats().peak_live_bytes_ == 0);
+        REQUIRE(second_account.stats().failed_count_ == 1);
+        REQUIRE(module_account.stats().live_bytes_ == 60);
+        REQUIRE(module_account.stats().failed_count_ == 1);
+        REQUIRE(module_account.stats().quota_bytes_ == 100);
+
+        REQUIRE(second_account.tryAllocate(40));
+        first_account.free(60);
+        REQUIRE(second_account.tryAllocate(50));
+
+        second_account.cancelAllocation(50);
+        REQUIRE(module_account.stats().live_bytes_ == 40);
+        REQUIRE(module_account.stats().allocation_count_ == 2);
+        REQUIRE(module_account.stats().failed_count_ == 2);
+
+        module_account.setQuota(0);
+        REQUIRE(first_account.tryAllocate(1000));
+    }
+
+    SECTION("allocators")
+    {
+        TestLogger logger;
+        TestMemoryAllocator memory_allocator(true);
+        module_account.setQuota(3000);
+
+        DynamicAllocator dynamic_allocator(&logger, &memory_allocator, {}, &first_account);
+        auto data = dynamic_allocator.allocateImpl(1000);
+        REQUIRE(data != nullptr);
+        REQUIRE(first_account.stats().live_bytes_ == 1000);
+        REQUIRE(first_account.stats().reserved_bytes_ == 1000);
+
+        {
+            // buffer slots are reserved up front, owned slots are live
+            StaticAllocator static_allocator(500, 4, &logger, &memory_allocator, {}, &second_account);
+            REQUIRE(second_account.stats().reserved_bytes_ == 2000);
+            REQUIRE(second_account.stats().live_bytes_ == 0);
+
+            std::vector<aergo::module::ISharedData*> slots;
+            for (int i = 0; i < 4; ++i)
+            {
+                slots.push_back(static_allocator.allocateImpl());
+                REQUIRE(slots.back() != nullptr);
+            }
+            REQUIRE(module_account.stats().live_bytes_ == 3000);
+
+            // quota reached
+            REQUIRE(dynamic_allocator.allocateImpl(1) == nullptr);
+            REQUIRE(module_account.stats().failed_count_ == 1);
+
+            static_allocator.removeOwnerImpl(slots[0]);
+            REQUIRE(second_account.stats().live_bytes_ == 1500);
+            REQUIRE(dynamic_allocator.allocateImpl(500) != nullptr);
+        }
+        REQUIRE(second_account.stats().reserved_bytes_ == 0);
+
+        dynamic_allocator.removeOwnerImpl(data);
+        REQUIRE(first_account.stats().live_bytes_ == 500);
+        REQUIRE(first_account.stats().reserved_bytes_ == 500);
+
+        {
+            ElasticAllocator elastic_allocator(100, { .min_slots_ = 1, .max_slots_ = 4, .idle_trim_ms_ = 0 }, &logger, &memory_allocator, {}, &second_account);
+            auto first = elastic_allocator.allocateImpl();
+            auto second = elastic_allocator.allocateImpl();
+            REQUIRE(second_account.stats().reserved_bytes_ == 200);
+            REQUIRE(second_account.stats().live_bytes_ == 200);
+
+            elastic_allocator.removeOwnerImpl(second);
+            elastic_allocator.removeOwnerImpl(first);
+            REQUIRE(second_account.stats().reserved_bytes_ == 100);
+            REQUIRE(second_account.stats().live_bytes_ == 0);
+        }
+        REQUIRE(second_account.stats().reserved_bytes_ == 0);
+    }
+}
\ No newline at end of file
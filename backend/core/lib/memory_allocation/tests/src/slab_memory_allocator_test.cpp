@@ -0,0 +1,280 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_logger.h"
+#include "utils/memory_allocation/dynamic_allocator.h"
+#include "utils/memory_allocation/slab_memory_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace aergo::core::memory_allocation;
+using namespace aergo::core::logging;
+
+
+
+namespace
+{
+    /// @brief Upstream allocator counting live allocations.
+    class CountingMemoryAllocator : public IMemoryAllocator
+    {
+    public:
+        void* malloc(size_t size) override
+        {
+            ++mallocs_;
+            ++live_;
+            return std::malloc(size);
+        }
+
+        void free(void* block) override
+        {
+            --live_;
+            std::free(block);
+        }
+
+        std::atomic<int64_t> mallocs_ = 0;
+        std::atomic<int64_t> live_ = 0;
+    };
+
+
+
+    /// @brief Allocation latency percentiles in ns of allocate/removeOwner with a sliding window of live blocks.
+    void reportLatency(const char* name, ICoreAllocator& allocator)
+    {
+        constexpr uint32_t iterations = 200000;
+        constexpr uint32_t window = 64;
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<uint64_t> size_distribution(1024, 256 * 1024);
+        std::vector<aergo::module::ISharedData*> live(window, nullptr);
+        std::vector<uint64_t> latencies;
+        latencies.reserve(iterations);
+
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            uint64_t size = size_distribution(random);
+            auto& slot = live[i % window];
+            if (slot != nullptr)
+            {
+                allocator.removeOwner(slot);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            slot = allocator.allocate(size);
+            auto end = std::chrono::steady_clock::now();
+
+            slot->data()[0] = 1;
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        for (auto data : live)
+        {
+            allocator.removeOwner(data);
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+        std::cout << name << " allocation latency [ns]: p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+            << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999) << std::endl;
+    }
+}
+
+
+
+TEST_CASE("SlabMemoryAllocator", "[slab_memory_allocator]")
+{
+    CountingMemoryAllocator upstream;
+
+    SECTION("blocks are usable and aligned")
+    {
+        SlabMemoryAllocator allocator(&upstream);
+        std::vector<void*> blocks;
+        for (size_t size : { 1, 63, 64, 65, 1000, 4096, 100000, 1 << 20 })
+        {
+            void* block = allocator.malloc(size);
+            REQUIRE(block != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(block) % 16 == 0);
+            std::memset(block, 0xAB, size);
+            blocks.push_back(block);
+        }
+
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            for (size_t j = i + 1; j < blocks.size(); ++j)
+            {
+                REQUIRE(blocks[i] != blocks[j]);
+            }
+        }
+
+        for (void* block : blocks)
+        {
+            allocator.free(block);
+        }
+        allocator.free(nullptr);
+    }
+
+    SECTION("same size buffers are recycled")
+    {
+        SlabMemoryAllocator allocator(&upstream);
+        void* first = allocator.malloc(3000);
+        allocator.free(first);
+        int64_t mallocs = upstream.mallocs_;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            void* block = allocator.malloc(2500);   // same size class (4 KiB)
+            REQUIRE(block == first);
+            allocator.free(block);
+        }
+        REQUIRE(upstream.mallocs_ == mallocs);
+    }
+
+    SECTION("large blocks bypass the slabs")
+    {
+        SlabMemoryAllocator allocator(&upstream);
+        void* block = allocator.malloc(SlabMemoryAllocator::MAX_CLASS_SIZE + 1);
+        REQUIRE(block != nullptr);
+        REQUIRE(upstream.live_ == 1);
+        REQUIRE(allocator.slabCount() == 0);
+
+        allocator.free(block);
+        REQUIRE(upstream.live_ == 0);
+    }
+
+    SECTION("slabs are released")
+    {
+        SlabMemoryAllocator allocator(&upstream, 60'000);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(allocator.malloc(64 << (i % 8)));
+        }
+        REQUIRE(allocator.slabCount() > 0);
+        REQUIRE(upstream.live_ == static_cast<int64_t>(allocator.slabCount()));
+
+        allocator.releaseIdleSlabs(true);
+        REQUIRE(allocator.slabCount() > 0);    // blocks still used
+
+        for (void* block : blocks)
+        {
+            allocator.free(block);
+        }
+        allocator.releaseIdleSlabs();
+        REQUIRE(allocator.slabCount() > 0);    // not idle long enough
+
+        allocator.releaseIdleSlabs(true);
+        REQUIRE(allocator.slabCount() == 0);
+        REQUIRE(upstream.live_ == 0);
+    }
+
+    SECTION("idle slabs are released on free")
+    {
+        SlabMemoryAllocator allocator(&upstream, 0);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(allocator.malloc(4000));
+        }
+        uint64_t slab_count = allocator.slabCount();
+        for (void* block : blocks)
+        {
+            allocator.free(block);
+        }
+
+        REQUIRE(slab_count > 0);
+
+        // the idle magazine is emptied too, so no slab is kept
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        allocator.free(allocator.malloc(4000));
+        REQUIRE(allocator.slabCount() == 0);
+    }
+
+    SECTION("idle magazines are emptied")
+    {
+        SlabMemoryAllocator allocator(&upstream, 20);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(allocator.malloc(64 << (i % 8)));
+        }
+        for (void* block : blocks)
+        {
+            allocator.free(block);
+        }
+        REQUIRE(allocator.slabCount() > 0);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        allocator.releaseIdleSlabs();
+        REQUIRE(allocator.slabCount() == 0);
+        REQUIRE(upstream.live_ == 0);
+    }
+
+    SECTION("concurrent use")
+    {
+        SlabMemoryAllocator allocator(&upstream);
+        std::atomic<bool> corrupted = false;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&allocator, &corrupted, t]() {
+                std::vector<std::pair<uint8_t*, size_t>> blocks;
+                for (int i = 0; i < 5000; ++i)
+                {
+                    size_t size = 64 + (i * 37) % 5000;
+                    uint8_t* block = static_cast<uint8_t*>(allocator.malloc(size));
+                    std::memset(block, t, size);
+                    blocks.emplace_back(block, size);
+
+                    if (blocks.size() > 16)
+                    {
+                        auto [old_block, old_size] = blocks[i % blocks.size()];
+                        blocks.erase(blocks.begin() + (i % blocks.size()));
+                        if (std::any_of(old_block, old_block + old_size, [t](uint8_t value) { return value != t; }))
+                        {
+                            corrupted = true;
+                        }
+                        allocator.free(old_block);
+                    }
+                }
+
+                for (auto [block, size] : blocks)
+                {
+                    allocator.free(block);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        REQUIRE_FALSE(corrupted);
+
+        allocator.releaseIdleSlabs(true);
+        REQUIRE(upstream.live_ == 0);
+    }
+
+    REQUIRE(upstream.live_ == 0);
+}
+
+
+
+TEST_CASE("SlabMemoryAllocator latency", "[.][benchmark][slab_memory_allocator]")
+{
+    TestLogger logger;
+
+    DefaultAllocator default_memory_allocator;
+    DynamicAllocator malloc_allocator(&logger, &default_memory_allocator);
+    reportLatency("DefaultAllocator", malloc_allocator);
+
+    DynamicAllocator slab_allocator(&logger);
+    reportLatency("SlabMemoryAllocator", slab_allocator);
+
+    REQUIRE(logger.logs().size() == 0);
+}
\ No newline at end of file
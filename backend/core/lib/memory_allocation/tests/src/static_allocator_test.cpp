@@ -1,10 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include "test_memory_allocator.h"
 #include "test_logger.h"
 #include "utils/memory_allocation/static_allocator.h"
 
 #include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
 
 using namespace aergo::core::memory_allocation;
 
@@ -127,4 +131,95 @@ TEST_CASE( "StaticAllocator", "[static_allocator]" )
         
         REQUIRE(logger.logs().size() == 50);
     }
+}
+
+
+
+namespace
+{
+    /// @brief Each thread allocates, marks the slot as its own, shares it (add owner) and releases it twice.
+    /// Returns false if a slot was handed to two threads at once.
+    bool allocateConcurrently(StaticAllocator& static_allocator, uint32_t thread_count, uint32_t iterations)
+    {
+        std::atomic<bool> collision{false};
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (uint32_t i = 0; i < iterations; ++i)
+                {
+                    aergo::module::ISharedData* data = static_allocator.allocateImpl();
+                    if (data == nullptr)
+                    {
+                        continue; // all slots taken by other threads
+                    }
+
+                    std::atomic_ref<uint32_t> owner(*reinterpret_cast<uint32_t*>(data->data()));
+                    owner.store(t + 1);
+                    static_allocator.addOwnerImpl(data);
+                    static_allocator.addOwnerImpl(data);
+                    if (owner.load() != t + 1)
+                    {
+                        collision = true;
+                    }
+                    static_allocator.removeOwnerImpl(data);
+                    static_allocator.removeOwnerImpl(data);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        return !collision;
+    }
+}
+
+
+
+TEST_CASE("StaticAllocator concurrent", "[static_allocator]")
+{
+    TestLogger logger;
+    uint32_t number_of_slots = 8;
+    StaticAllocator static_allocator(64, number_of_slots, &logger);
+
+    REQUIRE(allocateConcurrently(static_allocator, 8, 10000));
+    REQUIRE(logger.logs().size() == 0);
+
+    // every slot is free again
+    std::vector<aergo::module::ISharedData*> allocated_data;
+    for (uint32_t i = 0; i < number_of_slots; ++i)
+    {
+        aergo::module::ISharedData* data = static_allocator.allocateImpl();
+        REQUIRE(data != nullptr);
+        REQUIRE(std::find(allocated_data.begin(), allocated_data.end(), data) == allocated_data.end());
+        allocated_data.push_back(data);
+    }
+    REQUIRE(static_allocator.allocateImpl() == nullptr);
+
+    // pointers inside or outside of the slots array are rejected without touching the slots
+    aergo::module::ISharedData* misaligned = reinterpret_cast<aergo::module::ISharedData*>(reinterpret_cast<uint8_t*>(allocated_data[0]) + 1);
+    aergo::module::ISharedData* outside = reinterpret_cast<aergo::module::ISharedData*>(&logger);
+    static_allocator.removeOwnerImpl(misaligned);
+    static_allocator.removeOwnerImpl(outside);
+    static_allocator.addOwnerImpl(nullptr);
+    REQUIRE(logger.logs().size() == 3);
+    REQUIRE(static_allocator.allocateImpl() == nullptr);
+}
+
+
+
+TEST_CASE("StaticAllocator contention", "[.][benchmark][static_allocator]")
+{
+    TestLogger logger;
+    StaticAllocator static_allocator(1024, 64, &logger);
+
+    for (uint32_t thread_count : { 1, 2, 4, 8, 16 })
+    {
+        BENCHMARK(std::to_string(thread_count) + " threads")
+        {
+            return allocateConcurrently(static_allocator, thread_count, 10000);
+        };
+    }
 }
\ No newline at end of file
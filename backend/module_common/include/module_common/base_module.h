@@ -24,6 +24,14 @@ namespace aergo::module
         /// @param publish_producer_id id of the channel to publish on
         void sendMessage(uint32_t publish_producer_id, message::MessageHeader message);
 
+        /// @brief Handle of channel "publish_producer_id" for sendMessageByHandle, which skips the channel lookup.
+        /// Get it once the module runs (not in the constructor) and keep it for the lifetime of the module.
+        /// @return nullptr if the module is not running yet or the channel does not exist
+        IPublishHandle* getPublishHandle(uint32_t publish_producer_id);
+
+        /// @brief Publish message to the channel of "publish_handle" (from getPublishHandle).
+        void sendMessageByHandle(IPublishHandle* publish_handle, message::MessageHeader message);
+
         /// @brief Send response to channel "response_producer_id". 
         /// Message request/response pair is identified by ID in MessageHeader. 
         /// @param response_producer_id id of the channel to respond on
@@ -31,7 +39,8 @@ namespace aergo::module
         void sendResponse(uint32_t response_producer_id, ChannelIdentifier target_channel, uint64_t request_id, message::MessageHeader message);
 
         /// @brief Send request to channel "request_consumer_id" to module "module_id".
-        /// Message request/response pair is identified by ID in MessageHeader. 
+        /// Message request/response pair is identified by ID in MessageHeader. Set deadline_ns_ (nowNs() based) to get a success_ = false
+        /// response instead of processing once the target did not start the request in time.
         /// @param request_consumer_id id of the channel to request on
         /// @param target_channel identifies the target response channel (module and channel ID)
         /// @return ID of the request (to match with response ID)
@@ -40,15 +49,30 @@ namespace aergo::module
 
 
         /// @brief Create dynamic allocator for shared data (to avoid copying large data). Each allocate call creates new memory.
+        /// Memory of the module's allocators is accounted to the module (ICoreControl::getModuleMemoryStats).
+        /// @param options alignment and page backing of the data
         /// @return New allocator or nullptr on failure.
-        AllocatorPtr createDynamicAllocator();
+        AllocatorPtr createDynamicAllocator(AllocationOptions options = {});
 
         /// @brief Create buffered allocator for shared data (to avoid copying large data). Allocation happens on a buffer.
         /// Memory is pre-allocated. Allocation can fail if all buffer space is used.
         /// @param slot_size_bytes Fixed allocation size in bytes.
         /// @param number_of_slots Number of "size_bytes" sized slots.
+        /// @param options alignment and page backing of the slots
+        /// @return New allocator or nullptr on failure.
+        AllocatorPtr createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, AllocationOptions options = {});
+
+        /// @brief Create buffered allocator that grows under pressure instead of failing, up to "options.max_slots_" slots.
+        /// Slots added by growing are freed again when unused.
+        /// @param slot_size_bytes Fixed allocation size in bytes.
+        /// @param allocation_options alignment and page backing of the slots
+        /// @return New allocator or nullptr on failure.
+        AllocatorPtr createElasticBufferAllocator(uint64_t slot_size_bytes, ElasticBufferOptions options, AllocationOptions allocation_options = {});
+
+        /// @brief Create allocator backed by a memory-mapped file, allocated blobs are appended to the file.
+        /// With "options.read_only_" allocate returns the blobs recorded in an existing file in order.
         /// @return New allocator or nullptr on failure.
-        AllocatorPtr createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots);
+        AllocatorPtr createMappedFileAllocator(const char* path, MappedFileOptions options);
 
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "module_interface_.h"
+#include "message_envelope.h"
 
 namespace aergo::module::dll
 {
@@ -15,5 +16,10 @@ namespace aergo::module::dll
         /// @brief Stop and join the background thread.
         /// @return true if the thread was running, stopped within "timeout_ms" milliseconds and joined. false otherwise. 
         virtual bool threadStop(uint32_t timeout_ms) noexcept = 0;
+
+        /// @brief Process message, request or response held by a shared envelope (same semantics as processMessage / processRequest / processResponse).
+        /// Module adds its own reference if it keeps the envelope, the caller keeps and releases its reference.
+        /// @param local_channel_id ID of this module's subscribe consumer / response producer / request consumer channel, based on "type"
+        virtual void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageEnvelope* envelope) noexcept = 0;
     };
 }
\ No newline at end of file
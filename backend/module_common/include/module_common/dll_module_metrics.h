@@ -21,6 +21,9 @@ namespace aergo::module
             uint64_t queue_empty_count = 0;
             uint64_t queue_one_count = 0;
             uint64_t queue_multi_count = 0;
+            uint64_t deadline_miss_count = 0;
+            uint64_t expired_enqueue_count = 0;
+            uint64_t expired_dequeue_count = 0;
             std::string channel_name;
             std::string channel_type;
         };
@@ -67,6 +70,9 @@ namespace aergo::module
                 oss << "  Queue empty: " << s.queue_empty_count << "\n";
                 oss << "  Queue one: " << s.queue_one_count << "\n";
                 oss << "  Queue multi: " << s.queue_multi_count << "\n";
+                oss << "  Deadline misses: " << s.deadline_miss_count << "\n";
+                oss << "  Expired (enqueue): " << s.expired_enqueue_count << "\n";
+                oss << "  Expired (dequeue): " << s.expired_dequeue_count << "\n";
             }
             log->log(aergo::module::logging::LogType::INFO, oss.str().c_str());
         }
@@ -85,6 +91,25 @@ namespace aergo::module
             if (decision == aergo::module::IModule::IngressDecision::ACCEPT_REPLACE_QUEUE) stats_[idx].deleted_replace_queue_count++;
         }
 
+        /// @brief Item of channel "idx" started processing after its deadline.
+        void recordDeadlineMiss(size_t idx) {
+            stats_[idx].deadline_miss_count++;
+        }
+
+        uint64_t deadlineMisses(size_t idx) const {
+            return stats_[idx].deadline_miss_count;
+        }
+
+        /// @brief Item of channel "idx" was dropped because its TTL or deadline passed, when it arrived (at_dequeue false) or when it was taken from the queue.
+        void recordExpired(size_t idx, bool at_dequeue) {
+            if (at_dequeue) stats_[idx].expired_dequeue_count++;
+            else stats_[idx].expired_enqueue_count++;
+        }
+
+        uint64_t expired(size_t idx) const {
+            return stats_[idx].expired_enqueue_count + stats_[idx].expired_dequeue_count;
+        }
+
     private:
         std::vector<ChannelStats> stats_;
     };
@@ -2,7 +2,6 @@
 
 #include <cstdint>
 #include <vector>
-#include <queue>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -12,6 +11,8 @@
 #include "dll_interface_threads.h"
 #include "base_module.h"
 #include "dll_module_metrics.h"
+#include "ring_buffer.h"
+#include "ready_list.h"
 
 namespace aergo::module::dll
 {
@@ -19,17 +20,20 @@ namespace aergo::module::dll
     {
     public:
         /// @brief module must be non-nullptr and valid (check IModule::valid()), module_info must be non-nullptr.
-        DllModuleWrapper(std::unique_ptr<aergo::module::IModule> module, const aergo::module::ModuleInfo* module_info, const aergo::module::logging::ILogger* logger);
+        /// @param core provides the executor for ExecutionMode::POOL, if nullptr the module always uses dedicated threads (and expired requests are not answered)
+        /// @param module_id ID of the module received from the core, source of responses to expired requests
+        DllModuleWrapper(std::unique_ptr<aergo::module::IModule> module, const aergo::module::ModuleInfo* module_info, const aergo::module::logging::ILogger* logger, aergo::module::ICore* core, uint64_t module_id);
 
-        ~DllModuleWrapper() override = default;
+        /// @brief Waits until no drain task of this module is scheduled on the core executor.
+        ~DllModuleWrapper() override;
 
-        /// @brief Start the worker threads.
+        /// @brief Start processing. POOL mode schedules processing on the core executor, DEDICATED_THREADS mode starts the worker threads.
         /// @param timeout_ms Wait up to "timeout_ms" milliseconds for the threads to start.
         /// @return true if started within timeout_ms. false on fail to start / timeout. Thread may exist if false.
         bool threadStart(uint32_t timeout_ms) noexcept override;
 
-        /// @brief Stop and join the worker threads.
-        /// @return true if the thread was running, stopped within "timeout_ms" milliseconds and joined. false otherwise. 
+        /// @brief Stop processing. POOL mode waits for running drain tasks to finish, DEDICATED_THREADS mode stops and joins the worker threads.
+        /// @return true if the module was running, stopped within "timeout_ms" milliseconds (and threads joined). false otherwise. 
         bool threadStop(uint32_t timeout_ms) noexcept override;
 
         /// @brief Process a message that came to subscribed channel "subscribe_consumer_id" from module "module_id".
@@ -49,6 +53,17 @@ namespace aergo::module::dll
         /// @param source_channel identifies the source response channel (module and channel ID)
         void processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override;
 
+        /// @brief Queue message, request or response held by a shared envelope. Adds one reference to the envelope if it gets queued.
+        void processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageEnvelope* envelope) noexcept override;
+
+        /// @brief Number of items of the channel that started processing after their deadline (timestamp_ns_ + latency_budget_us_).
+        /// @return 0 if the channel does not exist
+        uint64_t getDeadlineMissCount(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id);
+
+        /// @brief Number of items of the channel dropped (requests answered with success_ = false) because their TTL or deadline passed, at enqueue or dequeue.
+        /// @return 0 if the channel does not exist
+        uint64_t getExpiredCount(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id);
+
         aergo::module::IModule* getModule();
 
     private:
@@ -56,36 +71,82 @@ namespace aergo::module::dll
         {
             aergo::module::IModule::ProcessingType processing_type_;
             uint32_t local_channel_id_;
+            uint32_t queue_idx_;                // index to queues_
             ChannelIdentifier source_channel_;
 
-            message::MessageHeader message_;
-            std::vector<uint8_t> data_;
-            std::vector<message::SharedDataBlob> blobs_;
+            message::EnvelopeRef envelope_;     // message data and blobs, shared with other receivers
+            bool expired_ = false;              // TTL or deadline passed while queued, module does not process it
+        };
+
+        /// @brief POOL mode worker. Processes up to drain_batch_size_ items from the prioritized or regular queues, then resubmits itself
+        /// if more work is waiting (so other modules on the executor get their turn). Each instance is one allowed concurrent worker.
+        class DrainTask : public aergo::module::IExecutorTask
+        {
+        public:
+            DrainTask(DllModuleWrapper* wrapper, bool prioritized)
+            : wrapper_(wrapper), prioritized_(prioritized) {}
+
+            void run() noexcept override { wrapper_->drain(*this); }
+
+            DllModuleWrapper* wrapper_;
+            bool prioritized_;
         };
 
-        void pushProcessingData(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageHeader message);
+        static constexpr uint32_t drain_batch_size_ = 32;
+
+        void pushProcessingData(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageEnvelope* envelope);
+        void processData(ProcessingData& processing_data); // pass data to the module (or answer expired request)
+        void finishProcessing(const ProcessingData& processing_data); // call with mutex_ locked after processData, makes a strand channel ready again
 
         void regularWorkerThreadFunc();
         void prioritizedWorkerThreadFunc();
 
-        bool regularQueuesEmpty(); // true if all regular queues are empty
-        bool prioritizedQueuesEmpty(); // true if all prioritized queues are empty
+        /// @brief DEDICATED_THREADS worker wait, call with mutex_ locked (may be unlocked while spinning). Returns when stopping, when the
+        /// ready list is not empty or when work was signalled (caller re-checks, work may already be taken by another worker).
+        void waitForWork(std::unique_lock<std::mutex>& lock, bool prioritized);
+        bool signalWork(bool prioritized); // call with mutex_ locked after new ready work, true if a sleeping worker needs notify (no worker spinning)
+        static void cpuRelax(); // spin loop hint
+
+        void drain(DrainTask& task);
+        DrainTask* acquireDrainTask(bool prioritized); // call with mutex_ locked, returns idle drain task or nullptr if none is idle or pool is not running
+        void submitDrainTask(DrainTask* task); // call without mutex_ locked, returns the task to idle tasks if the executor refuses it
+        bool drainTasksIdle(); // call with mutex_ locked, true if no drain task is scheduled
+
+        bool regularQueuesEmpty(); // true if all regular queues are empty, O(1)
+        bool prioritizedQueuesEmpty(); // true if all prioritized queues are empty, O(1)
+
+        bool popRegularProcessingData(ProcessingData& data); // pops data from the next ready regular queue (round-robin), returns false if all queues are empty, O(1)
+        bool popPrioritizedProcessingData(ProcessingData& data); // pops data from the next ready prioritized queue (round-robin), returns false if all queues are empty, O(1)
+        bool popProcessingData(ReadyList& ready_list, ProcessingData& data);
 
-        bool popRegularProcessingData(ProcessingData& data); // pops data from any non-empty regular queue, returns false if all queues are empty
-        bool popPrioritizedProcessingData(ProcessingData& data); // pops data from any non-empty prioritized queue, returns false if all queues are empty
+        bool channelIndex(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, uint32_t& idx); // index to queues_, false if channel does not exist
+        void makeReady(uint32_t idx, bool continue_turn); // add non-empty channel to its ready list, continue_turn keeps WEIGHTED_FAIR turn going
+        uint32_t earliestDeadlineChannel(const ReadyList& ready_list); // ready list must not be empty
+        uint64_t deadlineNs(uint32_t idx, const ProcessingData& data); // NO_DEADLINE if the channel has no latency budget or data has no timestamp
 
-        int64_t nowMs();
+        static constexpr uint64_t NO_DEADLINE = UINT64_MAX;
+
+        bool isExpired(uint32_t idx, aergo::module::IModule::ProcessingType type, const message::MessageHeader& message, uint64_t now_ns); // channel TTL or request deadline_ns_ passed
+        void answerExpiredRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, uint64_t request_id); // call without mutex_ locked, responds with success_ = false
+
+        uint64_t nowNs(); // steady clock, same as BaseModule::nowNs
 
         std::mutex mutex_;
 
-        std::vector<std::queue<ProcessingData>> prioritized_queues_; // one queue per prioritized message/request/response channel
-        std::vector<std::queue<ProcessingData>> regular_queues_;     // one queue per regular message/request/response channel
+        std::vector<RingBuffer<ProcessingData>> queues_;             // one preallocated queue per message/request/response channel (prioritized or regular)
 
         std::vector<bool> is_queue_prioritized_;                     // true if channel is prioritized, false otherwise
+        std::vector<bool> is_queue_busy_;                            // strands only, true while an item of the channel is being processed (channel is not in a ready list)
+        bool channel_strands_;                                       // ModuleInfo::channel_strands_
         std::vector<uint16_t> queue_capacities_;                      // maximum number of waiting messages/requests/responses in the queue (beyond that, new messages/requests/responses are dropped)
+        std::vector<uint16_t> queue_weights_;                         // items per turn for WEIGHTED_FAIR
+        std::vector<uint64_t> queue_latency_budgets_ns_;              // 0 = no deadline
+        std::vector<uint64_t> queue_ttls_ns_;                         // 0 = no limit
+        std::vector<uint16_t> turn_served_;                           // items taken in the current turn (WEIGHTED_FAIR)
+        aergo::module::SchedulingPolicy scheduling_policy_;
 
-        uint32_t next_prioritized_queue_idx_ = 0;                    // index of next prioritized queue to check for data (round-robin)
-        uint32_t next_regular_queue_idx_ = 0;                        // index of next regular queue to check for data (round-robin)
+        ReadyList prioritized_ready_;                                // non-empty prioritized queues, in scheduling order
+        ReadyList regular_ready_;                                    // non-empty regular queues, in scheduling order
 
         uint32_t messages_channel_count_;                            // number of channels for receiving messages
         uint32_t requests_channel_count_;                            // number of channels for receiving requests
@@ -100,9 +161,31 @@ namespace aergo::module::dll
 
         std::condition_variable regular_worker_cv_;
         std::condition_variable prioritized_worker_cv_;
+        std::condition_variable worker_count_cv_;                    // notified when a worker thread starts or exits (running counts change under mutex_)
+
+        aergo::module::WaitStrategy regular_wait_strategy_;
+        aergo::module::WaitStrategy prioritized_wait_strategy_;
+        uint64_t wait_spin_ns_;
+        std::atomic<uint64_t> regular_work_signal_{0};              // incremented on new ready work, spinning workers watch it
+        std::atomic<uint64_t> prioritized_work_signal_{0};
+        std::atomic<uint32_t> regular_spinning_count_{0};           // workers spinning (mutex_ not held)
+        std::atomic<uint32_t> prioritized_spinning_count_{0};
+        uint32_t regular_sleeping_count_ = 0;                        // workers waiting on the condition variable, guarded by mutex_
+        uint32_t prioritized_sleeping_count_ = 0;
 
         std::atomic<bool> stop_threads_{false};
 
+        aergo::module::ICore* core_;
+        uint64_t module_id_;
+        bool pool_mode_;                                             // ExecutionMode::POOL and core available
+        bool pool_running_ = false;
+        aergo::module::IExecutor* prioritized_executor_ = nullptr;
+        aergo::module::IExecutor* regular_executor_ = nullptr;
+        std::vector<std::unique_ptr<DrainTask>> drain_tasks_;        // prioritized_workers_count_ prioritized and regular_workers_count_ regular tasks
+        std::vector<DrainTask*> idle_prioritized_drain_tasks_;       // not scheduled on the executor
+        std::vector<DrainTask*> idle_regular_drain_tasks_;           // not scheduled on the executor
+        std::condition_variable drain_idle_cv_;                      // notified when a drain task becomes idle
+
 
         std::unique_ptr<aergo::module::IModule> module_;
         const aergo::module::ModuleInfo* module_info_;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "module_interface_.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace aergo::module::message
+{
+    /// @brief Immutable, reference counted copy of a message (inline data and blob references in a single allocation).
+    /// One envelope is created per send and shared by all receivers, each receiver only increments the reference count.
+    /// Envelope is freed by the binary (core / module DLL) that created it, so it can be released from any binary.
+    class MessageEnvelope
+    {
+    public:
+        /// @brief Create envelope with a copy of message data and references to message blobs. Reference count starts at 1.
+        /// Header of the envelope points to the copies, id_, timestamp_ns_, success_ and deadline_ns_ are kept.
+        /// @return nullptr on allocation failure
+        static MessageEnvelope* create(const MessageHeader& message) noexcept;
+
+        MessageEnvelope(const MessageEnvelope& other) = delete;
+        MessageEnvelope& operator=(const MessageEnvelope& other) = delete;
+
+        void addRef() noexcept;
+
+        /// @brief Drop one reference, envelope (and its blob references) are destroyed when the last reference is dropped.
+        void release() noexcept;
+
+        /// @brief Message with data and blobs pointing inside the envelope. Valid while a reference is held. Do not modify.
+        const MessageHeader& message() const noexcept;
+
+        uint32_t refCount() const noexcept;
+
+    private:
+        MessageEnvelope() = default;
+        ~MessageEnvelope() = default;
+
+        static void destroy(MessageEnvelope* envelope) noexcept;
+
+        std::atomic<uint32_t> ref_count_;
+        void (*destroy_)(MessageEnvelope*) noexcept;  // destroy function of the creating binary
+        MessageHeader message_;
+    };
+
+
+
+    /// @brief Owning reference to MessageEnvelope, releases it on destruction. Copy adds a reference.
+    class EnvelopeRef
+    {
+    public:
+        EnvelopeRef() noexcept;
+
+        /// @brief Take over one reference held by the caller (does not add a reference).
+        explicit EnvelopeRef(MessageEnvelope* envelope) noexcept;
+
+        ~EnvelopeRef();
+        EnvelopeRef(const EnvelopeRef& other) noexcept;
+        EnvelopeRef& operator=(const EnvelopeRef& other) noexcept;
+        EnvelopeRef(EnvelopeRef&& other) noexcept;
+        EnvelopeRef& operator=(EnvelopeRef&& other) noexcept;
+
+        MessageEnvelope* get() const noexcept;
+        MessageEnvelope* operator->() const noexcept;
+        explicit operator bool() const noexcept;
+
+    private:
+        MessageEnvelope* envelope_;
+    };
+}
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 
-#define PLUGIN_API_VERSION 2
+#define PLUGIN_API_VERSION 19
 
 
 #if defined(_WIN32)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <typeinfo>
 
@@ -20,6 +21,9 @@ namespace aergo::module
             /// over non-prioritized channels. ONLY for channels that need low latency even after load (e.g. control commands, GUI etc).
             bool prioritized_ = false;
             uint16_t message_queue_capacity_ = 4; // maximum number of waiting requests in the queue (beyond that, new requests are dropped), min 1
+            uint16_t weight_ = 1;                 // only for ResponseProducer; requests processed per turn with SchedulingPolicy::WEIGHTED_FAIR, min 1
+            uint32_t latency_budget_us_ = 0;      // only for ResponseProducer; deadline is request timestamp_ns_ + budget (EARLIEST_DEADLINE_FIRST and deadline-miss counting), 0 = no deadline
+            uint32_t ttl_us_ = 0;                 // only for ResponseProducer; requests older than timestamp_ns_ + ttl are answered with success_ = false instead of being processed, 0 = no limit
         };
 
         /// @brief 2 types:
@@ -45,9 +49,35 @@ namespace aergo::module
             /// over non-prioritized channels. ONLY for channels that need low latency even after load (e.g. control commands, GUI etc).
             bool prioritized_ = false;
             uint16_t message_queue_capacity_ = 4; // maximum number of waiting messages/responses in the queue (beyond that, new messages/responses are dropped), min 1
+            uint16_t weight_ = 1;                 // messages/responses processed per turn with SchedulingPolicy::WEIGHTED_FAIR, min 1
+            uint32_t latency_budget_us_ = 0;      // deadline is message timestamp_ns_ + budget (EARLIEST_DEADLINE_FIRST and deadline-miss counting), 0 = no deadline
+            uint32_t ttl_us_ = 0;                 // messages/responses older than timestamp_ns_ + ttl are dropped without processing, 0 = no limit
         };
     };
 
+    /// @brief How the module's queued messages, requests and responses get processed.
+    enum class ExecutionMode 
+    { 
+        POOL,               // tasks on the core executor (shared by all modules), workers counts limit how many channels are processed concurrently
+        DEDICATED_THREADS   // module owns its worker threads, workers counts are the thread counts
+    };
+
+    /// @brief How workers pick the next channel queue (separately for prioritized and regular channels).
+    enum class SchedulingPolicy
+    {
+        ROUND_ROBIN,             // one item per channel in turn
+        WEIGHTED_FAIR,           // up to weight_ items per channel in turn
+        EARLIEST_DEADLINE_FIRST  // channel whose oldest item has the earliest deadline (timestamp_ns_ + latency_budget_us_), channels without deadline last, in turn
+    };
+
+    /// @brief How DEDICATED_THREADS workers wait for new work. Spinning trades CPU time for lower wake-up latency.
+    enum class WaitStrategy
+    {
+        BLOCKING,        // sleep on a condition variable until notified
+        SPIN_THEN_PARK,  // spin for wait_spin_us_, then sleep on a condition variable
+        BUSY_POLL        // spin until work arrives or the module stops, never sleeps (one core per worker, prioritized workers only recommended)
+    };
+
     struct ModuleInfo
     {
         // human-friendly displayed module name, e.g. "Camera"
@@ -75,8 +105,22 @@ namespace aergo::module
         /// @brief If true, automatically create a single instance of module. Can be used for example for visualizer modules that need to exist to set up other modules.
         bool auto_create_;
 
-        uint8_t prioritized_workers_count_ = 1;  // number of prioritized worker threads (for prioritized channels), min 1
-        uint8_t regular_workers_count_ = 1;      // number of regular worker threads (for non-prioritized channels), min 1
+        uint8_t prioritized_workers_count_ = 1;  // number of prioritized workers (for prioritized channels), min 1
+        uint8_t regular_workers_count_ = 1;      // number of regular workers (for non-prioritized channels), min 1
+
+        ExecutionMode execution_mode_ = ExecutionMode::POOL;
+
+        /// @brief If true, each input channel is a strand: its messages/requests/responses are processed one at a time, in order,
+        /// while different channels are processed in parallel (up to the workers count). If false, with more than one worker, 
+        /// consecutive items of the same channel can be processed concurrently.
+        bool channel_strands_ = false;
+
+        SchedulingPolicy scheduling_policy_ = SchedulingPolicy::ROUND_ROBIN;
+
+        // DEDICATED_THREADS only, POOL mode workers wait in the core executor
+        WaitStrategy prioritized_wait_strategy_ = WaitStrategy::BLOCKING;
+        WaitStrategy regular_wait_strategy_ = WaitStrategy::BLOCKING;
+        uint32_t wait_spin_us_ = 50;             // spin duration of SPIN_THEN_PARK before the worker sleeps
     };
 
     struct ChannelIdentifier
@@ -105,6 +149,32 @@ namespace aergo::module
         uint32_t request_consumer_info_count_;
     };
 
+    /// @brief Set of module removals and additions applied at once by ICoreControl::applyModuleBatch.
+    struct ModuleBatch
+    {
+        struct Add
+        {
+            uint64_t loaded_module_id_;
+            InputChannelMapInfo channel_map_info_;
+        };
+
+        // running modules to remove
+        uint64_t* remove_ids_;
+        uint32_t remove_count_;
+        bool recursive_remove_;     // also remove modules depending on removed ones (otherwise they have to be listed too)
+
+        // modules to create, added module i gets ID getRunningModulesCount() + i, so it can map channels of added modules before it
+        Add* adds_;
+        uint32_t add_count_;
+    };
+
+    namespace message
+    {
+        class SharedDataBlob;
+    };
+
+    class ICountedSharedData;
+
     /// @brief Reference to shared data in the core. 
     class ISharedData
     {
@@ -119,6 +189,23 @@ namespace aergo::module
 
         /// @brief Size of the data. Behavior not specified when invalid.
         virtual uint64_t size() noexcept = 0;
+
+        /// @brief This data if it counts its owners itself, nullptr if owners are counted by the allocator only.
+        inline virtual ICountedSharedData* counted() noexcept { return nullptr; }
+    };
+
+    /// @brief Shared data keeping its owner count itself. SharedDataBlob adds and removes owners with atomics and only calls
+    /// IAllocator::removeOwner for the last owner (allocator decrements to zero and frees). Owners of other ISharedData
+    /// implementations are changed through IAllocator::addOwner/removeOwner.
+    class ICountedSharedData : public ISharedData
+    {
+    public:
+        inline virtual ICountedSharedData* counted() noexcept override { return this; }
+
+    protected:
+        std::atomic<uint64_t> owners_{0};
+
+        friend class message::SharedDataBlob;
     };
     
     class IAllocator;
@@ -133,22 +220,66 @@ namespace aergo::module
 
             ~SharedDataBlob();
             SharedDataBlob(const SharedDataBlob& other);
-            SharedDataBlob& operator=(SharedDataBlob& other);
+            SharedDataBlob& operator=(const SharedDataBlob& other);
             SharedDataBlob(SharedDataBlob&& other) noexcept;
             SharedDataBlob& operator=(SharedDataBlob&& other) noexcept;
 
             /// @brief Is data valid. Do not call other functions/methods if data is invalid.
             bool valid();
 
-            /// @brief Return pointer to the data. Behavior not specified when invalid.
+            /// @brief Return pointer to the data (first byte of the view for views). Behavior not specified when invalid.
             uint8_t* data();
 
-            /// @brief Size of the data. Behavior not specified when invalid.
+            /// @brief Size of the data. For 2D views the bytes spanned from data() to the end of the last row. Behavior not specified when invalid.
             uint64_t size();
-             
+
+            /// @brief View of "length" bytes at "offset" of this blob's data, sharing ownership of the data (no copy).
+            /// Views are regular blobs, so they can be forwarded in MessageHeader::blobs_ and viewed again.
+            /// @return invalid blob if this blob is invalid or the range is out of bounds
+            SharedDataBlob view(uint64_t offset, uint64_t length) const;
+
+            /// @brief 2D view (e.g. image region): "rows" rows of "row_bytes" bytes each, the first at "offset", row starts "stride" bytes apart.
+            /// Offset and stride are in bytes of this blob's data, sharing ownership of the data (no copy).
+            /// @return invalid blob if this blob is invalid, row_bytes > stride or the region is out of bounds
+            SharedDataBlob view2D(uint64_t offset, uint64_t row_bytes, uint64_t rows, uint64_t stride) const;
+
+            /// @brief Does the blob cover only part of the shared data.
+            bool isView() const;
+
+            /// @brief Is this blob the only reference to the data (no copies or views held elsewhere), so the data can be modified in place.
+            /// Always false if owners are counted by the allocator only. Blobs of a received message (MessageHeader::blobs_) are shared
+            /// by the sender and all receivers, read only: copy one to a blob of your own and makeWritable that copy to modify the data.
+            bool unique() const;
+
+            /// @brief Take writable ownership of the data. No-op if unique(), otherwise copy-on-write: the data (span of a view, keeping
+            /// its layout) is copied to a new blob allocated from "allocator", or the blob's own allocator if nullptr. Other owners keep
+            /// the original data. Chained in-place filters thus reuse a single buffer as long as no one else holds it.
+            /// @return false if the blob is invalid or the allocation failed (blob is unchanged then)
+            bool makeWritable(IAllocator* allocator = nullptr);
+
+            /// @brief Number of rows, 1 unless the blob is a 2D view.
+            uint64_t rows();
+
+            /// @brief Bytes in one row, size() unless the blob is a 2D view.
+            uint64_t rowBytes();
+
+            /// @brief Bytes between row starts, size() unless the blob is a 2D view.
+            uint64_t stride();
+
         private:
+            void acquire(); // add owner for data_
+            void release(); // remove owner from data_
+            void swap(SharedDataBlob& other) noexcept;
+
             ISharedData* data_;
             IAllocator* allocator_;
+
+            // view into data_, whole data unless is_view_
+            bool is_view_;
+            uint64_t offset_;
+            uint64_t row_bytes_;
+            uint64_t rows_;
+            uint64_t stride_;
         };
 
         struct MessageHeader
@@ -161,6 +292,7 @@ namespace aergo::module
             uint64_t id_;
             uint64_t timestamp_ns_;
             bool success_;                // indicates successful processing of request
+            uint64_t deadline_ns_;        // requests only, steady clock time after which the request is answered with success_ = false instead of being processed, 0 = no deadline
         };
     };
 
@@ -184,6 +316,55 @@ namespace aergo::module
         friend class message::SharedDataBlob;
     };
 
+    /// @brief Memory backing the data of an allocator (ICoreBase::create*Allocator). Default options give plain heap memory.
+    struct AllocationOptions
+    {
+        uint64_t alignment_ = 0;        // data alignment in bytes (power of two, e.g. 64 for SIMD loads or 4096), 0 for the malloc default
+        bool huge_pages_ = false;       // back data by huge pages (MAP_HUGETLB, else transparent huge pages), falls back to regular pages
+        bool prefault_ = false;         // fault all pages in at allocation, so the first write does not page fault
+        bool lock_memory_ = false;      // lock data in RAM (mlock/VirtualLock), best effort, failures are logged by buffer allocators
+    };
+
+    /// @brief Memory accounting of a module or a single allocator (ICoreControl::getModuleMemoryStats).
+    struct MemoryStats
+    {
+        uint64_t live_bytes_;                 // bytes of currently owned data (fixed slot size for buffer allocators)
+        uint64_t peak_live_bytes_;            // high-water mark of live_bytes_
+        uint64_t reserved_bytes_;             // bytes held by the allocators, including free preallocated slots
+        uint64_t allocation_count_;           // successful allocations
+        uint64_t allocated_bytes_;            // total bytes of successful allocations
+        uint64_t failed_count_;               // failed allocations (quota exceeded, pool exhausted, out of memory)
+        uint64_t quota_bytes_;                // limit of live_bytes_, 0 = unlimited
+        double allocations_per_second_;       // over the last completed second with allocations
+        double allocated_bytes_per_second_;
+    };
+
+    /// @brief Sampled allocation whose data was not released yet (ICoreControl::getOutstandingAllocations).
+    struct AllocationSample
+    {
+        uint64_t module_id_;                  // module that created the allocator
+        uint64_t allocator_id_;               // allocators are numbered by the core in creation order
+        uint64_t size_bytes_;
+        uint64_t allocated_ns_;               // steady clock time of the allocation
+        ChannelIdentifier published_on_;      // first channel the data was sent on (whole blob, not a view), {UINT64_MAX, UINT32_MAX} if never
+    };
+
+    /// @brief Pool limits of an elastic buffer allocator (ICoreBase::createElasticBufferAllocator).
+    struct ElasticBufferOptions
+    {
+        uint32_t min_slots_;              // allocated up front and never trimmed
+        uint32_t max_slots_;              // allocation fails only when this many slots are owned
+        uint32_t grow_slots_ = 0;         // slots added per growth step, 0 to grow by min_slots_ (at least 1)
+        uint64_t idle_trim_ms_ = 1000;    // slots added by growing are freed after being unused this long
+    };
+
+    /// @brief File backing of a mapped file allocator (ICoreBase::createMappedFileAllocator).
+    struct MappedFileOptions
+    {
+        uint64_t capacity_bytes_ = 0;     // maximum file size when writing, disk space is only used by written data (sparse file)
+        bool read_only_ = false;          // open an existing file, allocate returns its recorded blobs in order instead of new ones
+    };
+
     namespace logging {
         enum class LogType { INFO, WARNING, ERROR };
 
@@ -208,6 +389,66 @@ namespace aergo::module
         message::SharedDataBlob channel_map_; 
     };
 
+    /// @brief Channel type of the core's topology channel. A module with an AUTO_ALL subscribe consumer of this type receives
+    /// a TopologyChange message from TOPOLOGY_CHANNEL after every change of the module mapping, starting with the change that created it.
+    inline constexpr const char* TOPOLOGY_CHANNEL_TYPE_IDENTIFIER = "aergo/core/topology/v1";
+
+    /// @brief Source channel of topology messages (sent by the core, not a module).
+    inline constexpr ChannelIdentifier TOPOLOGY_CHANNEL { .producer_module_id_ = UINT64_MAX, .producer_channel_id_ = 0 };
+
+    /// @brief Single change of the module mapping.
+    struct TopologyEvent
+    {
+        enum class Type : uint32_t { CONNECTION_REMOVED, MODULE_REMOVED, MODULE_ADDED, CONNECTION_ADDED };
+
+        Type type_;
+        bool request_;                      // CONNECTION_*: request/response connection, publish/subscribe otherwise
+        uint32_t consumer_channel_id_;      // CONNECTION_*: subscribe/request channel of module_id_
+        uint64_t module_id_;                // MODULE_*: the module, CONNECTION_*: consumer module
+        uint64_t loaded_module_id_;         // MODULE_ADDED only
+        ChannelIdentifier producer_;        // CONNECTION_*: publish/response channel
+    };
+
+    /// @brief Data of a topology message. Message has one blob with TopologyEvent[event_count_], ordered by type
+    /// (removed connections, removed modules, added modules, added connections), so applying them in order never leaves a dangling connection.
+    /// Message ID is the new state ID. Changes without events are not sent, so state IDs are not consecutive. If previous_state_id_ is not
+    /// the last state ID seen, a message was dropped and the observer should resync (getTopologySnapshot).
+    struct TopologyChange
+    {
+        uint64_t previous_state_id_;        // state ID of the previous topology message
+        uint64_t state_id_;                 // getModulesMappingStateId() after the change
+        uint64_t event_count_;
+    };
+
+    /// @brief Unit of work for IExecutor.
+    class IExecutorTask
+    {
+    public:
+        inline virtual ~IExecutorTask() = default;
+
+        virtual void run() noexcept = 0;
+    };
+
+    /// @brief Thread pool provided by the core.
+    class IExecutor
+    {
+    public:
+        inline virtual ~IExecutor() = default;
+
+        /// @brief Schedule task to run once on one of the executor threads. Task must stay valid until run() is called.
+        /// The same task may be submitted again (also from its own run()).
+        /// @return false if the executor is stopped (task will not run)
+        virtual bool submit(IExecutorTask* task) noexcept = 0;
+    };
+
+    /// @brief Publish channel of a running module with its subscribers resolved by the core (see ICoreBase::getPublishHandle).
+    /// Owned by the core, opaque to modules.
+    class IPublishHandle
+    {
+    protected:
+        ~IPublishHandle() = default;
+    };
+
     /// @brief Interface provided by the core to modules.
     class ICoreBase
     {
@@ -218,6 +459,14 @@ namespace aergo::module
         /// @param source_channel identifies the source publish channel (module and channel ID)
         virtual void sendMessage(ChannelIdentifier source_channel, message::MessageHeader message) noexcept = 0;
 
+        /// @brief Handle of publish channel "source_channel" for publishing without looking the channel up on every message.
+        /// The core keeps the handle pointed at the channel's current subscribers when the mapping changes, so get it once and keep it.
+        /// @return handle valid for the lifetime of the module or nullptr if the module is not running (also in its constructor) or the channel does not exist
+        virtual IPublishHandle* getPublishHandle(ChannelIdentifier source_channel) noexcept = 0;
+
+        /// @brief Publish message to the channel of "publish_handle" (from getPublishHandle).
+        virtual void sendMessage(IPublishHandle* publish_handle, message::MessageHeader message) noexcept = 0;
+
         /// @brief Send response to channel "response_producer_id". 
         /// Message request/response pair is identified by ID in MessageHeader. 
         /// @param source_channel identifies the source response channel (module and channel ID)
@@ -231,18 +480,44 @@ namespace aergo::module
         virtual void sendRequest(ChannelIdentifier source_channel, ChannelIdentifier target_channel, message::MessageHeader message) noexcept = 0;
 
         /// @brief Create dynamic allocator for shared data (to avoid copying large data). Each allocate call creates new memory.
+        /// @param module_id module creating the allocator, its memory is accounted to the module (see ICoreControl::getModuleMemoryStats)
+        /// @param options alignment and page backing of the data, page backed data is mapped separately for every allocation
         /// @return New allocator or nullptr on failure.
-        virtual IAllocator* createDynamicAllocator() noexcept = 0;
+        virtual IAllocator* createDynamicAllocator(uint64_t module_id, AllocationOptions options) noexcept = 0;
 
         /// @brief Create buffered allocator for shared data (to avoid copying large data). Allocation happens on a buffer.
         /// Memory is pre-allocated. Allocation can fail if all buffer space is used.
+        /// @param module_id module creating the allocator, its memory is accounted to the module
         /// @param slot_size_bytes Fixed allocation size in bytes.
         /// @param number_of_slots Number of "size_bytes" sized slots.
+        /// @param options alignment and page backing of the slots, e.g. prefaulted and locked huge pages for real-time capture buffers
         /// @return New allocator or nullptr on failure.
-        virtual IAllocator* createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots) noexcept = 0;
+        virtual IAllocator* createBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, uint32_t number_of_slots, AllocationOptions options) noexcept = 0;
+
+        /// @brief Create buffered allocator that grows in chunks of "options.grow_slots_" slots instead of failing when every slot is owned,
+        /// up to "options.max_slots_" slots. Slots added by growing are freed again when unused. Growth, trimming and allocations
+        /// failing at the maximum are reported to the core log.
+        /// @param module_id module creating the allocator, its memory is accounted to the module
+        /// @param slot_size_bytes Fixed allocation size in bytes.
+        /// @param allocation_options alignment and page backing of the slots
+        /// @return New allocator or nullptr on failure (invalid options or initial slots could not be allocated).
+        virtual IAllocator* createElasticBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, ElasticBufferOptions options, AllocationOptions allocation_options) noexcept = 0;
+
+        /// @brief Create allocator whose data lives in a memory-mapped file, so allocated blobs are written to disk without copying
+        /// (e.g. recording sessions). Every allocation is appended to the file and stays there after its owners are gone.
+        /// With "options.read_only_" an existing file is mapped instead and each allocate call returns the next recorded blob
+        /// ("number_of_bytes" ignored, invalid blob after the last one), changes to the returned data are not written to the file.
+        /// @param module_id module creating the allocator, owned blobs are accounted to the module
+        /// @param path file to create (overwritten if it exists) or to read
+        /// @return New allocator or nullptr on failure (file could not be created or mapped, or is not a recorded file).
+        virtual IAllocator* createMappedFileAllocator(uint64_t module_id, const char* path, MappedFileOptions options) noexcept = 0;
 
         /// @brief Delete previously created allocator.
         virtual void deleteAllocator(IAllocator* allocator) noexcept = 0;
+
+        /// @brief Core thread pool for processing module queues. Prioritized pool is separate from the regular one.
+        /// @return executor owned by the core, valid for the lifetime of the core
+        virtual IExecutor* getExecutor(bool prioritized) noexcept = 0;
     };
 
     /// @brief Interface provided by the core to control module management.
@@ -266,9 +541,17 @@ namespace aergo::module
         virtual uint64_t getRunningModulesCount() noexcept = 0;
 
         /// @brief ID of the module mapping state. ID changes when modules get created or destroyed.
-        /// Can be used to detect changes in module mapping and update UI.
+        /// Can be used to detect changes in module mapping and update UI. To be notified of changes instead of polling,
+        /// subscribe to TOPOLOGY_CHANNEL_TYPE_IDENTIFIER. Blobs returned by getRunningModulesInfo, collectDependencies, getExisting*ChannelsByName
+        /// and getTopologySnapshot are built once per state ID and shared by all callers until the next change, they are read-only.
+        /// Call SharedDataBlob::makeWritable before modifying one, the cache keeps its reference, so the caller gets a private copy.
         virtual uint64_t getModulesMappingStateId() noexcept = 0;
 
+        /// @brief Whole module mapping in a single blob, structure is {TopologyChange header, TopologyEvent events[header.event_count_]},
+        /// the events are MODULE_ADDED for every running module followed by CONNECTION_ADDED for every connection (as a topology
+        /// message from an empty mapping, header.previous_state_id_ is 0). Check returned blob for validity by calling the valid() function.
+        virtual message::SharedDataBlob getTopologySnapshot() noexcept = 0;
+
         /// @brief Attempt to create a new module. Creation fails if loaded_module_id is out of range of loaded modules,
         /// channel_map_info input mapping does not match the module's creation requirements or the createModule call returned
         /// nullptr.
@@ -290,6 +573,15 @@ namespace aergo::module
         /// (module with id does not exist, was already removed or has dependencies if recursive is false).
         virtual bool removeModuleById(uint64_t id, bool recursive) noexcept = 0;
 
+        /// @brief Remove and add a set of modules as one change (single mapping state change). The whole batch is validated first,
+        /// added modules cannot map channels of removed ones. The change is published before threads of added modules start and before
+        /// threads of removed modules stop, all of them are started / stopped in parallel.
+        /// @return true if the batch was applied. false if it was rejected (nothing changed: a module to remove does not exist or has
+        /// dependencies not in the batch, a mapping is invalid, a module failed to be created or started - a failed start is undone with
+        /// a second mapping state change and the IDs of the added modules stay used) or if the removed modules failed to stop their
+        /// threads in time (batch applied).
+        virtual bool applyModuleBatch(ModuleBatch batch) noexcept = 0;
+
         /// @brief Get existing publish channels for specified channel type identifier. 
         /// @return Returns a list of modules and channels inside the modules or empty vector if specified identifier is not tied to any channels yet.
         /// The return structure is {uint64_t size, ChannelIdentifier[size]}. Check returned blob for validity by calling the valid() function.
@@ -299,6 +591,28 @@ namespace aergo::module
         /// @return Returns a list of modules and channels inside the modules or empty vector if specified identifier is not tied to any channels yet.
         /// The return structure is {uint64_t size, ChannelIdentifier[size]}. Check returned blob for validity by calling the valid() function.
         virtual message::SharedDataBlob getExistingResponseChannelsByName(const char* channel_type_identifier) noexcept = 0;
+
+        /// @brief Memory of all allocators created by module "module_id" (zeroed stats if it never created one).
+        /// Module ID UINT64_MAX accounts the core's own allocations.
+        virtual MemoryStats getModuleMemoryStats(uint64_t module_id) noexcept = 0;
+
+        /// @brief Memory of each live allocator created by module "module_id", in creation order.
+        /// The return structure is {uint64_t size, MemoryStats[size]}. Check returned blob for validity by calling the valid() function.
+        virtual message::SharedDataBlob getModuleAllocatorsMemoryStats(uint64_t module_id) noexcept = 0;
+
+        /// @brief Limit live bytes of all allocators of module "module_id" (also ones created later), allocations over the limit fail immediately.
+        /// Data allocated before is not affected. 
+        /// @param quota_bytes 0 for unlimited
+        virtual void setModuleMemoryQuota(uint64_t module_id, uint64_t quota_bytes) noexcept = 0;
+
+        /// @brief Track every "sample_period"-th allocation (of all allocators) until its data is released, to find blobs held for
+        /// long or leaked. Costs one counter decrement per allocation and a few loads per release and sent blob.
+        /// @param sample_period 1 to track all allocations, 0 to stop sampling (default, samples tracked so far are kept)
+        virtual void setAllocationSampling(uint32_t sample_period) noexcept = 0;
+
+        /// @brief Sampled allocations not released yet that were allocated at least "min_age_ns" ago, oldest first.
+        /// The return structure is {uint64_t size, AllocationSample[size]}. Check returned blob for validity by calling the valid() function.
+        virtual message::SharedDataBlob getOutstandingAllocations(uint64_t min_age_ns) noexcept = 0;
     };
 
     /// @brief Reference to the core.
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace aergo::module::dll
+{
+    /// @brief Intrusive doubly linked list of channel indices (0 .. channel_count-1), each index at most once. All operations except iteration are O(1).
+    /// Used to track non-empty channel queues: popping the front and pushing it back while it still has data gives round-robin order.
+    /// Not thread safe.
+    class ReadyList
+    {
+    public:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        ReadyList() = default;
+        explicit ReadyList(uint32_t channel_count)
+        : next_(channel_count, NONE), prev_(channel_count, NONE), linked_(channel_count, false) {}
+
+        /// @brief Append channel at the end, ignored if the channel is already in the list.
+        void pushBack(uint32_t idx)
+        {
+            if (linked_[idx])
+            {
+                return;
+            }
+
+            linked_[idx] = true;
+            next_[idx] = NONE;
+            prev_[idx] = tail_;
+            if (tail_ == NONE)
+            {
+                head_ = idx;
+            }
+            else
+            {
+                next_[tail_] = idx;
+            }
+            tail_ = idx;
+        }
+
+        /// @brief Insert channel at the beginning, ignored if the channel is already in the list.
+        void pushFront(uint32_t idx)
+        {
+            if (linked_[idx])
+            {
+                return;
+            }
+
+            linked_[idx] = true;
+            prev_[idx] = NONE;
+            next_[idx] = head_;
+            if (head_ == NONE)
+            {
+                tail_ = idx;
+            }
+            else
+            {
+                prev_[head_] = idx;
+            }
+            head_ = idx;
+        }
+
+        /// @brief Remove and return the first channel. List must not be empty.
+        uint32_t popFront()
+        {
+            uint32_t idx = head_;
+            remove(idx);
+            return idx;
+        }
+
+        /// @brief Remove channel from the list, ignored if the channel is not in the list.
+        void remove(uint32_t idx)
+        {
+            if (!linked_[idx])
+            {
+                return;
+            }
+
+            if (prev_[idx] == NONE)
+            {
+                head_ = next_[idx];
+            }
+            else
+            {
+                next_[prev_[idx]] = next_[idx];
+            }
+
+            if (next_[idx] == NONE)
+            {
+                tail_ = prev_[idx];
+            }
+            else
+            {
+                prev_[next_[idx]] = prev_[idx];
+            }
+
+            linked_[idx] = false;
+        }
+
+        /// @brief First channel or NONE if empty.
+        uint32_t front() const { return head_; }
+
+        /// @brief Channel following "idx" (which must be in the list) or NONE if "idx" is the last one.
+        uint32_t next(uint32_t idx) const { return next_[idx]; }
+
+        bool empty() const { return head_ == NONE; }
+        bool contains(uint32_t idx) const { return linked_[idx]; }
+
+    private:
+        std::vector<uint32_t> next_;    // next channel in the list, NONE for the last one
+        std::vector<uint32_t> prev_;    // previous channel in the list, NONE for the first one
+        std::vector<bool> linked_;      // true if the channel is in the list
+        uint32_t head_ = NONE;
+        uint32_t tail_ = NONE;
+    };
+}
\ No newline at end of file
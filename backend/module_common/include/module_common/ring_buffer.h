@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace aergo::module::dll
+{
+    /// @brief Fixed-capacity FIFO queue. All slots are allocated in the constructor, push/pop never allocate.
+    /// Popped slots are reset to T(), so resources held by the element are released on pop. Not thread safe.
+    template <typename T>
+    class RingBuffer
+    {
+    public:
+        RingBuffer()
+        : capacity_(0) {}
+
+        /// @param capacity maximum number of elements, min 1
+        explicit RingBuffer(uint32_t capacity)
+        : slots_(std::make_unique<T[]>((capacity > 0) ? capacity : 1)), capacity_((capacity > 0) ? capacity : 1) {}
+
+        RingBuffer(RingBuffer&& other) noexcept = default;
+        RingBuffer& operator=(RingBuffer&& other) noexcept = default;
+
+        /// @return false if full (element is not moved from)
+        bool push(T&& value)
+        {
+            if (size_ == capacity_)
+            {
+                return false;
+            }
+
+            slots_[(head_ + size_) % capacity_] = std::move(value);
+            ++size_;
+            return true;
+        }
+
+        /// @brief Move the oldest element to "value".
+        /// @return false if empty
+        bool pop(T& value)
+        {
+            if (size_ == 0)
+            {
+                return false;
+            }
+
+            value = std::move(slots_[head_]);
+            slots_[head_] = T();
+            head_ = (head_ + 1) % capacity_;
+            --size_;
+            return true;
+        }
+
+        /// @brief Remove the oldest element.
+        /// @return false if empty
+        bool pop()
+        {
+            if (size_ == 0)
+            {
+                return false;
+            }
+
+            slots_[head_] = T();
+            head_ = (head_ + 1) % capacity_;
+            --size_;
+            return true;
+        }
+
+        /// @brief Oldest element. Buffer must not be empty.
+        const T& front() const { return slots_[head_]; }
+
+        void clear()
+        {
+            while (pop()) {}
+            head_ = 0;
+        }
+
+        bool empty() const { return size_ == 0; }
+        bool full() const { return size_ == capacity_; }
+        uint32_t size() const { return size_; }
+        uint32_t capacity() const { return capacity_; }
+
+    private:
+        std::unique_ptr<T[]> slots_;
+        uint32_t capacity_;
+        uint32_t head_ = 0;     // index of the oldest element
+        uint32_t size_ = 0;
+    };
+}
\ No newline at end of file
@@ -65,6 +65,22 @@ void BaseModule::sendMessage(uint32_t publish_producer_id, message::MessageHeade
 
 
 
+IPublishHandle* BaseModule::getPublishHandle(uint32_t publish_producer_id)
+{
+    return core_->getPublishHandle({ .producer_module_id_ = module_id_, .producer_channel_id_ = publish_producer_id });
+}
+
+
+
+void BaseModule::sendMessageByHandle(IPublishHandle* publish_handle, message::MessageHeader message)
+{
+    message.timestamp_ns_ = nowNs();
+
+    core_->sendMessage(publish_handle, message);
+}
+
+
+
 void BaseModule::sendResponse(uint32_t response_producer_id, ChannelIdentifier target_channel, uint64_t request_id, message::MessageHeader message)
 {
     message.id_ = request_id;
@@ -101,20 +117,40 @@ uint64_t BaseModule::sendRequest(uint32_t request_consumer_id, ChannelIdentifier
 
 
 
-BaseModule::AllocatorPtr BaseModule::createDynamicAllocator()
+BaseModule::AllocatorPtr BaseModule::createDynamicAllocator(AllocationOptions options)
+{
+    return std::unique_ptr<aergo::module::IAllocator, std::function<void(IAllocator*)>>(
+        core_->createDynamicAllocator(module_id_, options),
+        [this](IAllocator* allocator_ref) { core_->deleteAllocator(allocator_ref); }
+    );
+}
+
+
+
+BaseModule::AllocatorPtr BaseModule::createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots, AllocationOptions options)
+{
+    return std::unique_ptr<aergo::module::IAllocator, std::function<void(IAllocator*)>>(
+        core_->createBufferAllocator(module_id_, slot_size_bytes, number_of_slots, options),
+        [this](IAllocator* allocator_ref) { core_->deleteAllocator(allocator_ref); }
+    );
+}
+
+
+
+BaseModule::AllocatorPtr BaseModule::createElasticBufferAllocator(uint64_t slot_size_bytes, ElasticBufferOptions options, AllocationOptions allocation_options)
 {
     return std::unique_ptr<aergo::module::IAllocator, std::function<void(IAllocator*)>>(
-        core_->createDynamicAllocator(),
+        core_->createElasticBufferAllocator(module_id_, slot_size_bytes, options, allocation_options),
         [this](IAllocator* allocator_ref) { core_->deleteAllocator(allocator_ref); }
     );
 }
 
 
 
-BaseModule::AllocatorPtr BaseModule::createBufferAllocator(uint64_t slot_size_bytes, uint32_t number_of_slots)
+BaseModule::AllocatorPtr BaseModule::createMappedFileAllocator(const char* path, MappedFileOptions options)
 {
     return std::unique_ptr<aergo::module::IAllocator, std::function<void(IAllocator*)>>(
-        core_->createBufferAllocator(slot_size_bytes, number_of_slots),
+        core_->createMappedFileAllocator(module_id_, path, options),
         [this](IAllocator* allocator_ref) { core_->deleteAllocator(allocator_ref); }
     );
 }
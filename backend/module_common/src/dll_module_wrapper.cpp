@@ -2,30 +2,44 @@
 
 #include <chrono>
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+  #include <immintrin.h>
+#endif
+
 using namespace aergo::module;
 using namespace aergo::module::dll;
 
 
 
-DllModuleWrapper::DllModuleWrapper(std::unique_ptr<aergo::module::IModule> module, const aergo::module::ModuleInfo* module_info, const aergo::module::logging::ILogger* logger)
-: module_(std::move(module)), module_info_(module_info), logger_(logger), metrics_(module_info)
+DllModuleWrapper::DllModuleWrapper(std::unique_ptr<aergo::module::IModule> module, const aergo::module::ModuleInfo* module_info, const aergo::module::logging::ILogger* logger, aergo::module::ICore* core, uint64_t module_id)
+: core_(core), module_id_(module_id), module_(std::move(module)), module_info_(module_info), logger_(logger), metrics_(module_info)
 {
     if (module_ == nullptr || !module_->valid() || module_info_ == nullptr)
     {
         throw std::invalid_argument("DllModuleWrapper: Invalid constructor parameters.");
     }
 
+    pool_mode_ = (module_info_->execution_mode_ == aergo::module::ExecutionMode::POOL && core_ != nullptr);
+    channel_strands_ = module_info_->channel_strands_;
+    scheduling_policy_ = module_info_->scheduling_policy_;
+    regular_wait_strategy_ = module_info_->regular_wait_strategy_;
+    prioritized_wait_strategy_ = module_info_->prioritized_wait_strategy_;
+    wait_spin_ns_ = module_info_->wait_spin_us_ * 1000ull;
+
     messages_channel_count_ = module_info_->subscribe_consumer_count_;
     requests_channel_count_ = module_info_->response_producer_count_;
     responses_channel_count_ = module_info_->request_consumer_count_;
     
     uint32_t total_channels = messages_channel_count_ + requests_channel_count_ + responses_channel_count_;
-    prioritized_queues_.resize(total_channels);
-    regular_queues_.resize(total_channels);
     is_queue_prioritized_.resize(total_channels, false);
+    is_queue_busy_.resize(total_channels, false);
     queue_capacities_.resize(total_channels, 4); // default capacity
+    queue_weights_.resize(total_channels, 1);
+    queue_latency_budgets_ns_.resize(total_channels, 0);
+    queue_ttls_ns_.resize(total_channels, 0);
+    turn_served_.resize(total_channels, 0);
 
-    // Determine which channels are prioritized and their capacities
+    // Determine which channels are prioritized, their capacities and scheduling parameters
     for (uint32_t i = 0; i < messages_channel_count_; ++i)
     {
         if (module_info_->subscribe_consumers_[i].prioritized_)
@@ -40,6 +54,9 @@ DllModuleWrapper::DllModuleWrapper(std::unique_ptr<aergo::module::IModule> modul
         {
             queue_capacities_[i] = 1; // minimum capacity
         }
+        queue_weights_[i] = (module_info_->subscribe_consumers_[i].weight_ >= 1) ? module_info_->subscribe_consumers_[i].weight_ : 1;
+        queue_latency_budgets_ns_[i] = module_info_->subscribe_consumers_[i].latency_budget_us_ * 1000ull;
+        queue_ttls_ns_[i] = module_info_->subscribe_consumers_[i].ttl_us_ * 1000ull;
     }
     for (uint32_t i = 0; i < requests_channel_count_; ++i)
     {
@@ -56,6 +73,9 @@ DllModuleWrapper::DllModuleWrapper(std::unique_ptr<aergo::module::IModule> modul
         {
             queue_capacities_[idx] = 1; // minimum capacity
         }
+        queue_weights_[idx] = (module_info_->response_producers_[i].weight_ >= 1) ? module_info_->response_producers_[i].weight_ : 1;
+        queue_latency_budgets_ns_[idx] = module_info_->response_producers_[i].latency_budget_us_ * 1000ull;
+        queue_ttls_ns_[idx] = module_info_->response_producers_[i].ttl_us_ * 1000ull;
     }
     for (uint32_t i = 0; i < responses_channel_count_; ++i)
     {
@@ -72,7 +92,30 @@ DllModuleWrapper::DllModuleWrapper(std::unique_ptr<aergo::module::IModule> modul
         {
             queue_capacities_[idx] = 1; // minimum capacity
         }
+        queue_weights_[idx] = (module_info_->request_consumers_[i].weight_ >= 1) ? module_info_->request_consumers_[i].weight_ : 1;
+        queue_latency_budgets_ns_[idx] = module_info_->request_consumers_[i].latency_budget_us_ * 1000ull;
+        queue_ttls_ns_[idx] = module_info_->request_consumers_[i].ttl_us_ * 1000ull;
+    }
+
+    // Preallocate all queue slots, so enqueue/dequeue does not allocate
+    queues_.reserve(total_channels);
+    for (uint32_t i = 0; i < total_channels; ++i)
+    {
+        queues_.emplace_back(queue_capacities_[i]);
     }
+
+    prioritized_ready_ = ReadyList(total_channels);
+    regular_ready_ = ReadyList(total_channels);
+}
+
+
+
+DllModuleWrapper::~DllModuleWrapper()
+{
+    // drain tasks scheduled on the core executor point to this object
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_threads_ = true;
+    drain_idle_cv_.wait(lock, [&] { return drainTasksIdle(); });
 }
 
 
@@ -81,6 +124,58 @@ bool DllModuleWrapper::threadStart(uint32_t timeout_ms) noexcept
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
+    if (pool_mode_)
+    {
+        if (pool_running_)
+        {
+            return false; // already started
+        }
+
+        prioritized_executor_ = core_->getExecutor(true);
+        regular_executor_ = core_->getExecutor(false);
+        if (prioritized_executor_ == nullptr || regular_executor_ == nullptr)
+        {
+            return false;
+        }
+
+        if (drain_tasks_.empty())
+        {
+            uint8_t prioritized_workers_count = (module_info_->prioritized_workers_count_ > 0) ? module_info_->prioritized_workers_count_ : 1;
+            uint8_t regular_workers_count = (module_info_->regular_workers_count_ > 0) ? module_info_->regular_workers_count_ : 1;
+
+            for (uint16_t i = 0; i < prioritized_workers_count; ++i)
+            {
+                drain_tasks_.push_back(std::make_unique<DrainTask>(this, true));
+                idle_prioritized_drain_tasks_.push_back(drain_tasks_.back().get());
+            }
+            for (uint16_t i = 0; i < regular_workers_count; ++i)
+            {
+                drain_tasks_.push_back(std::make_unique<DrainTask>(this, false));
+                idle_regular_drain_tasks_.push_back(drain_tasks_.back().get());
+            }
+        }
+
+        stop_threads_ = false;
+        pool_running_ = true;
+
+        // data may have been queued before start
+        DrainTask* prioritized_task = prioritized_ready_.empty() ? nullptr : acquireDrainTask(true);
+        DrainTask* regular_task = regular_ready_.empty() ? nullptr : acquireDrainTask(false);
+
+        lock.unlock();
+
+        if (prioritized_task != nullptr)
+        {
+            submitDrainTask(prioritized_task);
+        }
+        if (regular_task != nullptr)
+        {
+            submitDrainTask(regular_task);
+        }
+
+        return true;
+    }
+
     if (prioritized_worker_threads_.size() > 0 || regular_worker_threads_.size() > 0)
     {
         return false; // already started
@@ -103,52 +198,56 @@ bool DllModuleWrapper::threadStart(uint32_t timeout_ms) noexcept
         regular_worker_threads_.emplace_back(&DllModuleWrapper::regularWorkerThreadFunc, this);
     }
 
-    lock.unlock();
+    // workers count themselves in under mutex_, the last one to start wakes us
+    return worker_count_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+        return prioritized_worker_running_count_ == prioritized_workers_count && regular_worker_running_count_ == regular_workers_count;
+    });
+}
+
+
 
-    // wait for threads to start
-    auto start_time = nowMs();
-    while (nowMs() - start_time < timeout_ms)
+bool DllModuleWrapper::threadStop(uint32_t timeout_ms) noexcept
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (pool_mode_)
     {
-        if (prioritized_worker_running_count_ == prioritized_workers_count && regular_worker_running_count_ == regular_workers_count)
+        if (!pool_running_)
         {
-            return true;
+            return false; // not running
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-
-    return false;
-}
+        stop_threads_ = true;
+        pool_running_ = false;
 
+        // running drain tasks finish their current item, scheduled ones return immediately
+        if (!drain_idle_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return drainTasksIdle(); }))
+        {
+            return false;
+        }
 
+        lock.unlock();
+        metrics_.printLogs(logger_);
 
-bool DllModuleWrapper::threadStop(uint32_t timeout_ms) noexcept
-{
-    std::unique_lock<std::mutex> lock(mutex_);
+        return true;
+    }
     if (prioritized_worker_threads_.size() == 0 && regular_worker_threads_.size() == 0)
     {
         return false; // not running
     }
 
     stop_threads_ = true;
-    
-    lock.unlock();
 
     prioritized_worker_cv_.notify_all();
     regular_worker_cv_.notify_all();
 
-    auto start_time = nowMs();
-    while (nowMs() - start_time < timeout_ms)
-    {
-        if (prioritized_worker_running_count_ == 0 && regular_worker_running_count_ == 0)
-        {
-            break;
-        }
+    bool stopped = worker_count_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+        return prioritized_worker_running_count_ == 0 && regular_worker_running_count_ == 0;
+    });
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    lock.unlock();
 
-    if (prioritized_worker_running_count_ == 0 && regular_worker_running_count_ == 0)
+    if (stopped)
     {
         for (auto& thread : prioritized_worker_threads_)
         {
@@ -182,51 +281,125 @@ bool DllModuleWrapper::threadStop(uint32_t timeout_ms) noexcept
 
 void DllModuleWrapper::processMessage(uint32_t subscribe_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept
 {
-    pushProcessingData(aergo::module::IModule::ProcessingType::MESSAGE, subscribe_consumer_id, source_channel, message);
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(message));
+    if (envelope)
+    {
+        pushProcessingData(aergo::module::IModule::ProcessingType::MESSAGE, subscribe_consumer_id, source_channel, envelope.get());
+    }
 }
 
 
 
 void DllModuleWrapper::processRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept
 {
-    pushProcessingData(aergo::module::IModule::ProcessingType::REQUEST, response_producer_id, source_channel, message);
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(message));
+    if (envelope)
+    {
+        pushProcessingData(aergo::module::IModule::ProcessingType::REQUEST, response_producer_id, source_channel, envelope.get());
+    }
 }
 
 
 
 void DllModuleWrapper::processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept
 {
-    pushProcessingData(aergo::module::IModule::ProcessingType::RESPONSE, request_consumer_id, source_channel, message);
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(message));
+    if (envelope)
+    {
+        pushProcessingData(aergo::module::IModule::ProcessingType::RESPONSE, request_consumer_id, source_channel, envelope.get());
+    }
 }
 
 
 
-void DllModuleWrapper::pushProcessingData(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageHeader message)
+void DllModuleWrapper::processEnvelope(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageEnvelope* envelope) noexcept
+{
+    if (envelope != nullptr)
+    {
+        pushProcessingData(type, local_channel_id, source_channel, envelope);
+    }
+}
+
+
+
+uint64_t DllModuleWrapper::getDeadlineMissCount(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id)
+{
+    uint32_t idx;
+    if (!channelIndex(type, local_channel_id, idx))
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_.deadlineMisses(idx);
+}
+
+
+
+uint64_t DllModuleWrapper::getExpiredCount(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id)
 {
     uint32_t idx;
+    if (!channelIndex(type, local_channel_id, idx))
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_.expired(idx);
+}
+
+
+
+bool DllModuleWrapper::channelIndex(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, uint32_t& idx)
+{
     switch (type)
     {
         case aergo::module::IModule::ProcessingType::MESSAGE:
-            if (local_channel_id >= messages_channel_count_) return;
+            if (local_channel_id >= messages_channel_count_) return false;
             idx = local_channel_id;
-            break;
+            return true;
         case aergo::module::IModule::ProcessingType::REQUEST:
-            if (local_channel_id >= requests_channel_count_) return;
+            if (local_channel_id >= requests_channel_count_) return false;
             idx = messages_channel_count_ + local_channel_id;
-            break;
+            return true;
         case aergo::module::IModule::ProcessingType::RESPONSE:
-            if (local_channel_id >= responses_channel_count_) return;
+            if (local_channel_id >= responses_channel_count_) return false;
             idx = messages_channel_count_ + requests_channel_count_ + local_channel_id;
-            break;
+            return true;
         default:
-            return;
+            return false;
+    }
+}
+
+
+
+void DllModuleWrapper::pushProcessingData(aergo::module::IModule::ProcessingType type, uint32_t local_channel_id, ChannelIdentifier source_channel, message::MessageEnvelope* envelope)
+{
+    const message::MessageHeader& message = envelope->message();
+
+    uint32_t idx;
+    if (!channelIndex(type, local_channel_id, idx))
+    {
+        return;
     }
 
     bool is_prioritized = is_queue_prioritized_[idx];
     uint16_t capacity = queue_capacities_[idx];
-    std::queue<ProcessingData>& target_queue = is_prioritized ? prioritized_queues_[idx] : regular_queues_[idx];
+    RingBuffer<ProcessingData>& target_queue = queues_[idx];
 
     std::unique_lock<std::mutex> lock(mutex_);
+
+    if (isExpired(idx, type, message, nowNs()))
+    {
+        metrics_.recordExpired(idx, false);
+        lock.unlock();
+
+        if (type == aergo::module::IModule::ProcessingType::REQUEST)
+        {
+            answerExpiredRequest(local_channel_id, source_channel, message.id_);
+        }
+        return; // stale, the module never sees it
+    }
     
     bool queue_full = (target_queue.size() >= capacity);
     aergo::module::IModule::QueueStatus queue_status = queue_full ? aergo::module::IModule::QueueStatus::QUEUE_FULL : aergo::module::IModule::QueueStatus::NORMAL;
@@ -247,39 +420,93 @@ void DllModuleWrapper::pushProcessingData(aergo::module::IModule::ProcessingType
     }
     else if (decision == aergo::module::IModule::IngressDecision::ACCEPT_REPLACE_QUEUE)
     {
-        while (!target_queue.empty())
-        {
-            target_queue.pop(); // clear the queue
-        }
+        target_queue.clear();
     }
 
-    // Copy data and blobs to ensure they remain valid
-    std::vector<uint8_t> data(message.data_, message.data_ + message.data_len_);
-    message.data_ = data.data();
-
-    std::vector<message::SharedDataBlob> blobs(message.blobs_, message.blobs_ + message.blob_count_);
-    message.blobs_ = blobs.data();
+    // Share the envelope instead of copying data and blobs, it stays valid until the last receiver releases it
+    envelope->addRef();
 
     ProcessingData processing_data {
         .processing_type_ = type,
         .local_channel_id_ = local_channel_id,
+        .queue_idx_ = idx,
         .source_channel_ = source_channel,
-        .message_ = message,
-        .data_ = std::move(data),
-        .blobs_ = std::move(blobs)
+        .envelope_ = message::EnvelopeRef(envelope)
     };
 
     target_queue.push(std::move(processing_data));
+    if (!is_queue_busy_[idx] && !(is_prioritized ? prioritized_ready_ : regular_ready_).contains(idx))
+    {
+        makeReady(idx, false); // busy strand is made ready in finishProcessing
+    }
+
+    if (pool_mode_)
+    {
+        DrainTask* drain_task = acquireDrainTask(is_prioritized);  // if none is idle, the running ones pick the data up
+        lock.unlock();
 
+        if (drain_task != nullptr)
+        {
+            submitDrainTask(drain_task);
+        }
+        return;
+    }
+
+    bool notify = signalWork(is_prioritized); // a spinning worker picks the data up without the futex wake-up
     lock.unlock();
 
-    if (is_prioritized)
+    if (notify)
     {
-        prioritized_worker_cv_.notify_one();
+        (is_prioritized ? prioritized_worker_cv_ : regular_worker_cv_).notify_one();
     }
-    else
+}
+
+
+
+void DllModuleWrapper::processData(ProcessingData& processing_data)
+{
+    if (processing_data.expired_)
+    {
+        if (processing_data.processing_type_ == aergo::module::IModule::ProcessingType::REQUEST)
+        {
+            answerExpiredRequest(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.envelope_->message().id_);
+        }
+        return;
+    }
+
+    // blobs stay in the envelope shared by all receivers (no owner added per delivery), the module copies a blob only to write it
+    switch (processing_data.processing_type_)
+    {
+        case aergo::module::IModule::ProcessingType::MESSAGE:
+            module_->processMessage(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.envelope_->message());
+            break;
+        case aergo::module::IModule::ProcessingType::REQUEST:
+            module_->processRequest(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.envelope_->message());
+            break;
+        case aergo::module::IModule::ProcessingType::RESPONSE:
+            module_->processResponse(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.envelope_->message());
+            break;
+    }
+}
+
+
+
+void DllModuleWrapper::finishProcessing(const ProcessingData& processing_data)
+{
+    if (!channel_strands_)
+    {
+        return;
+    }
+
+    uint32_t idx = processing_data.queue_idx_;
+    is_queue_busy_[idx] = false;
+    if (!queues_[idx].empty())
     {
-        regular_worker_cv_.notify_one();
+        makeReady(idx, true);
+        if (!pool_mode_ && signalWork(is_queue_prioritized_[idx]))
+        {
+            (is_queue_prioritized_[idx] ? prioritized_worker_cv_ : regular_worker_cv_).notify_one(); // calling worker may pick another channel
+        }
     }
 }
 
@@ -289,9 +516,10 @@ void DllModuleWrapper::regularWorkerThreadFunc()
 {
     std::unique_lock<std::mutex> lock(mutex_);
     ++regular_worker_running_count_;
+    worker_count_cv_.notify_all();
     while (!stop_threads_)
     {
-        regular_worker_cv_.wait(lock, [&] { return stop_threads_ || !regularQueuesEmpty(); });
+        waitForWork(lock, false);
         if (stop_threads_)
         {
             break;
@@ -304,21 +532,12 @@ void DllModuleWrapper::regularWorkerThreadFunc()
         }
 
         lock.unlock();
-        switch (processing_data.processing_type_)
-        {
-            case aergo::module::IModule::ProcessingType::MESSAGE:
-                module_->processMessage(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
-                break;
-            case aergo::module::IModule::ProcessingType::REQUEST:
-                module_->processRequest(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
-                break;
-            case aergo::module::IModule::ProcessingType::RESPONSE:
-                module_->processResponse(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
-                break;
-        }
+        processData(processing_data);
         lock.lock();
+        finishProcessing(processing_data);
     }
     --regular_worker_running_count_;
+    worker_count_cv_.notify_all();
 }
 
 
@@ -327,9 +546,10 @@ void DllModuleWrapper::prioritizedWorkerThreadFunc()
 {
     std::unique_lock<std::mutex> lock(mutex_);
     ++prioritized_worker_running_count_;
+    worker_count_cv_.notify_all();
     while (!stop_threads_)
     {
-        prioritized_worker_cv_.wait(lock, [&] { return stop_threads_ || !prioritizedQueuesEmpty(); });
+        waitForWork(lock, true);
         if (stop_threads_)
         {
             break;
@@ -342,89 +562,306 @@ void DllModuleWrapper::prioritizedWorkerThreadFunc()
         }
 
         lock.unlock();
-        switch (processing_data.processing_type_)
+        processData(processing_data);
+        lock.lock();
+        finishProcessing(processing_data);
+    }
+    --prioritized_worker_running_count_;
+    worker_count_cv_.notify_all();
+}
+
+
+
+void DllModuleWrapper::waitForWork(std::unique_lock<std::mutex>& lock, bool prioritized)
+{
+    ReadyList& ready_list = prioritized ? prioritized_ready_ : regular_ready_;
+    if (stop_threads_ || !ready_list.empty())
+    {
+        return;
+    }
+
+    aergo::module::WaitStrategy strategy = prioritized ? prioritized_wait_strategy_ : regular_wait_strategy_;
+    if (strategy != aergo::module::WaitStrategy::BLOCKING)
+    {
+        std::atomic<uint64_t>& work_signal = prioritized ? prioritized_work_signal_ : regular_work_signal_;
+        std::atomic<uint32_t>& spinning_count = prioritized ? prioritized_spinning_count_ : regular_spinning_count_;
+
+        // ready list was empty under the lock, so any new work changes the signal
+        uint64_t seen_signal = work_signal.load(std::memory_order_acquire);
+        ++spinning_count;
+        lock.unlock();
+
+        uint64_t spin_end_ns = (strategy == aergo::module::WaitStrategy::SPIN_THEN_PARK) ? nowNs() + wait_spin_ns_ : UINT64_MAX;
+        for (uint32_t i = 1; work_signal.load(std::memory_order_acquire) == seen_signal && !stop_threads_; ++i)
         {
-            case aergo::module::IModule::ProcessingType::MESSAGE:
-                module_->processMessage(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
-                break;
-            case aergo::module::IModule::ProcessingType::REQUEST:
-                module_->processRequest(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
-                break;
-            case aergo::module::IModule::ProcessingType::RESPONSE:
-                module_->processResponse(processing_data.local_channel_id_, processing_data.source_channel_, processing_data.message_);
+            cpuRelax();
+            if (i % 64 == 0 && nowNs() > spin_end_ns) // BUSY_POLL never ends
+            {
                 break;
+            }
         }
+
         lock.lock();
+        --spinning_count;
+        if (stop_threads_ || work_signal.load(std::memory_order_acquire) != seen_signal)
+        {
+            return;
+        }
     }
-    --prioritized_worker_running_count_;
+
+    uint32_t& sleeping_count = prioritized ? prioritized_sleeping_count_ : regular_sleeping_count_;
+    ++sleeping_count;
+    (prioritized ? prioritized_worker_cv_ : regular_worker_cv_).wait(lock, [&] { return stop_threads_ || !ready_list.empty(); });
+    --sleeping_count;
 }
 
 
 
-bool DllModuleWrapper::regularQueuesEmpty()
+bool DllModuleWrapper::signalWork(bool prioritized)
 {
-    for (const auto& queue : regular_queues_)
+    (prioritized ? prioritized_work_signal_ : regular_work_signal_).fetch_add(1, std::memory_order_release);
+
+    // sleeping workers register under mutex_, so a worker that is not counted yet checks the ready list before it sleeps
+    uint32_t sleeping_count = prioritized ? prioritized_sleeping_count_ : regular_sleeping_count_;
+    uint32_t spinning_count = (prioritized ? prioritized_spinning_count_ : regular_spinning_count_).load(std::memory_order_acquire);
+    return sleeping_count > 0 && spinning_count == 0;
+}
+
+
+
+void DllModuleWrapper::cpuRelax()
+{
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+
+
+void DllModuleWrapper::drain(DrainTask& task)
+{
+    ReadyList& ready_list = task.prioritized_ ? prioritized_ready_ : regular_ready_;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < drain_batch_size_ && !stop_threads_; ++i)
     {
-        if (!queue.empty())
+        ProcessingData processing_data;
+        if (!popProcessingData(ready_list, processing_data))
         {
-            return false;
+            break;
         }
+
+        lock.unlock();
+        processData(processing_data);
+        lock.lock();
+        finishProcessing(processing_data);
     }
 
-    return true;
+    if (!stop_threads_ && !ready_list.empty())
+    {
+        // keep the slot, but go to the back of the executor queue
+        lock.unlock();
+        submitDrainTask(&task);
+        return;
+    }
+
+    (task.prioritized_ ? idle_prioritized_drain_tasks_ : idle_regular_drain_tasks_).push_back(&task);
+    drain_idle_cv_.notify_all();
+}
+
+
+
+DllModuleWrapper::DrainTask* DllModuleWrapper::acquireDrainTask(bool prioritized)
+{
+    std::vector<DrainTask*>& idle_tasks = prioritized ? idle_prioritized_drain_tasks_ : idle_regular_drain_tasks_;
+    if (!pool_running_ || idle_tasks.empty())
+    {
+        return nullptr;
+    }
+
+    DrainTask* task = idle_tasks.back();
+    idle_tasks.pop_back();
+    return task;
+}
+
+
+
+void DllModuleWrapper::submitDrainTask(DrainTask* task)
+{
+    aergo::module::IExecutor* executor = task->prioritized_ ? prioritized_executor_ : regular_executor_;
+    if (!executor->submit(task))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        (task->prioritized_ ? idle_prioritized_drain_tasks_ : idle_regular_drain_tasks_).push_back(task);
+        drain_idle_cv_.notify_all();
+    }
+}
+
+
+
+bool DllModuleWrapper::drainTasksIdle()
+{
+    return idle_prioritized_drain_tasks_.size() + idle_regular_drain_tasks_.size() == drain_tasks_.size();
+}
+
+
+
+bool DllModuleWrapper::regularQueuesEmpty()
+{
+    return regular_ready_.empty();
 }
 
 
 
 bool DllModuleWrapper::prioritizedQueuesEmpty()
 {
-    for (const auto& queue : prioritized_queues_)
+    return prioritized_ready_.empty();
+}
+
+
+
+bool DllModuleWrapper::popRegularProcessingData(ProcessingData& data)
+{
+    return popProcessingData(regular_ready_, data);
+}
+
+
+
+bool DllModuleWrapper::popPrioritizedProcessingData(ProcessingData& data)
+{
+    return popProcessingData(prioritized_ready_, data);
+}
+
+
+
+bool DllModuleWrapper::popProcessingData(ReadyList& ready_list, ProcessingData& data)
+{
+    if (ready_list.empty())
     {
-        if (!queue.empty())
+        return false;
+    }
+
+    uint32_t idx = (scheduling_policy_ == aergo::module::SchedulingPolicy::EARLIEST_DEADLINE_FIRST) ? earliestDeadlineChannel(ready_list) : ready_list.front();
+    ready_list.remove(idx);
+    queues_[idx].pop(data);
+    ++turn_served_[idx];
+
+    uint64_t now_ns = nowNs();
+    if (isExpired(idx, data.processing_type_, data.envelope_->message(), now_ns))
+    {
+        data.expired_ = true; // still returned, so strands and requests are finished the usual way
+        metrics_.recordExpired(idx, true);
+    }
+    else
+    {
+        uint64_t deadline = deadlineNs(idx, data);
+        if (deadline != NO_DEADLINE && now_ns > deadline)
         {
-            return false;
+            metrics_.recordDeadlineMiss(idx);
         }
     }
 
+    if (channel_strands_)
+    {
+        is_queue_busy_[idx] = true; // leaves the ready list until the item is processed
+    }
+    else if (!queues_[idx].empty())
+    {
+        makeReady(idx, true);
+    }
+
     return true;
 }
 
 
 
-bool DllModuleWrapper::popRegularProcessingData(ProcessingData& data)
+void DllModuleWrapper::makeReady(uint32_t idx, bool continue_turn)
 {
-    for (uint32_t i = 0; i < regular_queues_.size(); ++i)
+    ReadyList& ready_list = is_queue_prioritized_[idx] ? prioritized_ready_ : regular_ready_;
+
+    if (scheduling_policy_ == aergo::module::SchedulingPolicy::WEIGHTED_FAIR && continue_turn && turn_served_[idx] < queue_weights_[idx])
     {
-        uint32_t idx = (next_regular_queue_idx_ + i) % regular_queues_.size();
-        if (!regular_queues_[idx].empty())
-        {
-            data = std::move(regular_queues_[idx].front());
-            regular_queues_[idx].pop();
-            next_regular_queue_idx_ = (idx + 1) % regular_queues_.size();
-            return true;
-        }
+        ready_list.pushFront(idx); // turn is not over yet
+        return;
     }
 
-    return false;
+    turn_served_[idx] = 0;
+    ready_list.pushBack(idx); // other channels get their turn first
 }
 
 
 
-bool DllModuleWrapper::popPrioritizedProcessingData(ProcessingData& data)
+uint32_t DllModuleWrapper::earliestDeadlineChannel(const ReadyList& ready_list)
 {
-    for (uint32_t i = 0; i < prioritized_queues_.size(); ++i)
+    uint32_t best_idx = ready_list.front();
+    uint64_t best_deadline = deadlineNs(best_idx, queues_[best_idx].front());
+
+    for (uint32_t idx = ready_list.next(best_idx); idx != ReadyList::NONE; idx = ready_list.next(idx))
     {
-        uint32_t idx = (next_prioritized_queue_idx_ + i) % prioritized_queues_.size();
-        if (!prioritized_queues_[idx].empty())
+        uint64_t deadline = deadlineNs(idx, queues_[idx].front());
+        if (deadline < best_deadline) // ties keep ready list (round-robin) order
         {
-            data = std::move(prioritized_queues_[idx].front());
-            prioritized_queues_[idx].pop();
-            next_prioritized_queue_idx_ = (idx + 1) % prioritized_queues_.size();
-            return true;
+            best_idx = idx;
+            best_deadline = deadline;
         }
     }
 
-    return false;
+    return best_idx;
+}
+
+
+
+uint64_t DllModuleWrapper::deadlineNs(uint32_t idx, const ProcessingData& data)
+{
+    uint64_t timestamp_ns = data.envelope_->message().timestamp_ns_;
+    if (queue_latency_budgets_ns_[idx] == 0 || timestamp_ns == 0)
+    {
+        return NO_DEADLINE;
+    }
+
+    return timestamp_ns + queue_latency_budgets_ns_[idx];
+}
+
+
+
+bool DllModuleWrapper::isExpired(uint32_t idx, aergo::module::IModule::ProcessingType type, const message::MessageHeader& message, uint64_t now_ns)
+{
+    if (queue_ttls_ns_[idx] != 0 && message.timestamp_ns_ != 0 && now_ns > message.timestamp_ns_ + queue_ttls_ns_[idx])
+    {
+        return true;
+    }
+
+    return type == aergo::module::IModule::ProcessingType::REQUEST && message.deadline_ns_ != 0 && now_ns > message.deadline_ns_;
+}
+
+
+
+void DllModuleWrapper::answerExpiredRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, uint64_t request_id)
+{
+    if (core_ == nullptr)
+    {
+        return;
+    }
+
+    core_->sendResponse(
+        {
+            .producer_module_id_ = module_id_,
+            .producer_channel_id_ = response_producer_id
+        },
+        source_channel,
+        {
+            .data_ = nullptr,
+            .data_len_ = 0,
+            .blobs_ = nullptr,
+            .blob_count_ = 0,
+            .id_ = request_id,
+            .timestamp_ns_ = nowNs(),
+            .success_ = false,
+            .deadline_ns_ = 0
+        }
+    );
 }
 
 
@@ -436,7 +873,7 @@ aergo::module::IModule* DllModuleWrapper::getModule()
 
 
 
-int64_t DllModuleWrapper::nowMs()
+uint64_t DllModuleWrapper::nowNs()
 {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "module_common/message_envelope.h"
+
+#include <cstring>
+#include <new>
+
+using namespace aergo::module::message;
+
+
+
+namespace
+{
+    // blob array follows the envelope, inline data follows the blob array
+    constexpr uint64_t blobsOffset()
+    {
+        return (sizeof(MessageEnvelope) + alignof(SharedDataBlob) - 1) / alignof(SharedDataBlob) * alignof(SharedDataBlob);
+    }
+}
+
+
+
+MessageEnvelope* MessageEnvelope::create(const MessageHeader& message) noexcept
+{
+    uint64_t blob_count = (message.blobs_ != nullptr) ? message.blob_count_ : 0;
+    uint64_t data_len = (message.data_ != nullptr) ? message.data_len_ : 0;
+    uint64_t data_offset = blobsOffset() + blob_count * sizeof(SharedDataBlob);
+
+    uint8_t* memory = static_cast<uint8_t*>(::operator new(data_offset + data_len, std::nothrow));
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    MessageEnvelope* envelope = new (memory) MessageEnvelope();
+    envelope->ref_count_.store(1, std::memory_order_relaxed);
+    envelope->destroy_ = &MessageEnvelope::destroy;
+
+    SharedDataBlob* blobs = reinterpret_cast<SharedDataBlob*>(memory + blobsOffset());
+    for (uint64_t i = 0; i < blob_count; ++i)
+    {
+        new (&blobs[i]) SharedDataBlob(message.blobs_[i]);
+    }
+
+    uint8_t* data = memory + data_offset;
+    if (data_len > 0)
+    {
+        std::memcpy(data, message.data_, data_len);
+    }
+
+    envelope->message_ = message;
+    envelope->message_.data_ = data;
+    envelope->message_.data_len_ = data_len;
+    envelope->message_.blobs_ = blobs;
+    envelope->message_.blob_count_ = blob_count;
+
+    return envelope;
+}
+
+
+
+void MessageEnvelope::addRef() noexcept
+{
+    ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+void MessageEnvelope::release() noexcept
+{
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        destroy_(this);
+    }
+}
+
+
+
+const MessageHeader& MessageEnvelope::message() const noexcept
+{
+    return message_;
+}
+
+
+
+uint32_t MessageEnvelope::refCount() const noexcept
+{
+    return ref_count_.load(std::memory_order_relaxed);
+}
+
+
+
+void MessageEnvelope::destroy(MessageEnvelope* envelope) noexcept
+{
+    for (uint64_t i = 0; i < envelope->message_.blob_count_; ++i)
+    {
+        envelope->message_.blobs_[i].~SharedDataBlob();
+    }
+
+    envelope->~MessageEnvelope();
+    ::operator delete(static_cast<void*>(envelope));
+}
+
+
+
+EnvelopeRef::EnvelopeRef() noexcept
+: envelope_(nullptr) {}
+
+EnvelopeRef::EnvelopeRef(MessageEnvelope* envelope) noexcept
+: envelope_(envelope) {}
+
+
+
+EnvelopeRef::~EnvelopeRef()
+{
+    if (envelope_)
+    {
+        envelope_->release();
+    }
+}
+
+
+
+EnvelopeRef::EnvelopeRef(const EnvelopeRef& other) noexcept
+: envelope_(other.envelope_)
+{
+    if (envelope_)
+    {
+        envelope_->addRef();
+    }
+}
+
+
+
+EnvelopeRef& EnvelopeRef::operator=(const EnvelopeRef& other) noexcept
+{
+    if (this != &other)
+    {
+        if (other.envelope_)
+        {
+            other.envelope_->addRef();
+        }
+        if (envelope_)
+        {
+            envelope_->release();
+        }
+        envelope_ = other.envelope_;
+    }
+
+    return *this;
+}
+
+
+
+EnvelopeRef::EnvelopeRef(EnvelopeRef&& other) noexcept
+: envelope_(other.envelope_)
+{
+    other.envelope_ = nullptr;
+}
+
+
+
+EnvelopeRef& EnvelopeRef::operator=(EnvelopeRef&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (envelope_)
+        {
+            envelope_->release();
+        }
+        envelope_ = other.envelope_;
+        other.envelope_ = nullptr;
+    }
+
+    return *this;
+}
+
+
+
+MessageEnvelope* EnvelopeRef::get() const noexcept
+{
+    return envelope_;
+}
+
+
+
+MessageEnvelope* EnvelopeRef::operator->() const noexcept
+{
+    return envelope_;
+}
+
+
+
+EnvelopeRef::operator bool() const noexcept
+{
+    return envelope_ != nullptr;
+}
\ No newline at end of file
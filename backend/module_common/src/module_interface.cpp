@@ -1,5 +1,6 @@
 #include "module_common/module_interface_.h"
 
+#include <cstring>
 #include <utility>
 
 using namespace aergo::module::message;
@@ -7,47 +8,38 @@ using namespace aergo::module::message;
 
 
 SharedDataBlob::SharedDataBlob()
-: data_(nullptr), allocator_(nullptr) {}
+: data_(nullptr), allocator_(nullptr), is_view_(false), offset_(0), row_bytes_(0), rows_(1), stride_(0) {}
 
 SharedDataBlob::SharedDataBlob(ISharedData* data, IAllocator* allocator)
-: data_(data), allocator_(allocator)
+: data_(data), allocator_(allocator), is_view_(false), offset_(0), row_bytes_(0), rows_(1), stride_(0)
 {
-    if (allocator_)
-    {
-        allocator_->addOwner(data_);
-    }
+    acquire();
 }
 
 
 
 SharedDataBlob::~SharedDataBlob()
 {
-    if (allocator_)
-    {
-        allocator_->removeOwner(data_);
-    }
+    release();
 }
 
 
 
 SharedDataBlob::SharedDataBlob(const SharedDataBlob& other)
-: data_(other.data_), allocator_(other.allocator_)
+: data_(other.data_), allocator_(other.allocator_), is_view_(other.is_view_), offset_(other.offset_), row_bytes_(other.row_bytes_), rows_(other.rows_), stride_(other.stride_)
 {
-    if (allocator_)
-    {
-        allocator_->addOwner(data_);
-    }
+    acquire();
 }
 
 
 
-SharedDataBlob& SharedDataBlob::operator=(SharedDataBlob& other)
+SharedDataBlob& SharedDataBlob::operator=(const SharedDataBlob& other)
 {
-    allocator_ = other.allocator_;
-    data_ = other.data_;
-    if (allocator_)
+    if (this != &other)
     {
-        allocator_->addOwner(data_);
+        // take the new owner first (other may hold the same data), the copy releases the previous data
+        SharedDataBlob copy(other);
+        swap(copy);
     }
 
     return *this;
@@ -56,10 +48,9 @@ SharedDataBlob& SharedDataBlob::operator=(SharedDataBlob& other)
 
 
 SharedDataBlob::SharedDataBlob(SharedDataBlob&& other) noexcept
-: data_(other.data_), allocator_(other.allocator_)
+: SharedDataBlob()
 {
-    other.data_ = nullptr;
-    other.allocator_ = nullptr;
+    swap(other);
 }
 
 
@@ -68,11 +59,8 @@ SharedDataBlob& SharedDataBlob::operator=(SharedDataBlob&& other) noexcept
 {
     if (this != &other)
     {
-        data_ = other.data_;
-        allocator_ = other.allocator_;
-
-        other.data_ = nullptr;
-        other.allocator_ = nullptr;
+        SharedDataBlob moved(std::move(other));
+        swap(moved); // previous data is released with "moved"
     }
 
     return *this;
@@ -80,6 +68,51 @@ SharedDataBlob& SharedDataBlob::operator=(SharedDataBlob&& other) noexcept
 
 
 
+void SharedDataBlob::acquire()
+{
+    if (allocator_ == nullptr)
+    {
+        return;
+    }
+
+    ICountedSharedData* counted = (data_ != nullptr) ? data_->counted() : nullptr;
+    if (counted != nullptr)
+    {
+        counted->owners_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        allocator_->addOwner(data_);
+    }
+}
+
+
+
+void SharedDataBlob::release()
+{
+    if (allocator_ == nullptr)
+    {
+        return;
+    }
+
+    ICountedSharedData* counted = (data_ != nullptr) ? data_->counted() : nullptr;
+    if (counted != nullptr)
+    {
+        uint64_t owners = counted->owners_.load(std::memory_order_relaxed);
+        while (owners > 1)
+        {
+            if (counted->owners_.compare_exchange_weak(owners, owners - 1, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return; // not the last owner, allocator is not involved
+            }
+        }
+    }
+
+    allocator_->removeOwner(data_);
+}
+
+
+
 bool SharedDataBlob::valid()
 {
     return allocator_ != nullptr && data_ != nullptr && data_->valid();
@@ -89,12 +122,130 @@ bool SharedDataBlob::valid()
 
 uint8_t* SharedDataBlob::data()
 {
-    return data_->data();
+    return data_->data() + offset_;
 }
 
 
 
 uint64_t SharedDataBlob::size()
 {
-    return data_->size();
+    return is_view_ ? (rows_ - 1) * stride_ + row_bytes_ : data_->size();
+}
+
+
+
+SharedDataBlob SharedDataBlob::view(uint64_t offset, uint64_t length) const
+{
+    return view2D(offset, length, 1, length);
+}
+
+
+
+SharedDataBlob SharedDataBlob::view2D(uint64_t offset, uint64_t row_bytes, uint64_t rows, uint64_t stride) const
+{
+    SharedDataBlob parent(*this);
+    if (!parent.valid() || rows == 0 || row_bytes > stride)
+    {
+        return SharedDataBlob();
+    }
+
+    // span of the region, checked for overflow before comparing to the parent size
+    uint64_t size = parent.size();
+    if ((rows > 1 && (stride == 0 || rows - 1 > (UINT64_MAX - row_bytes) / stride)) || offset > size || (rows - 1) * stride + row_bytes > size - offset)
+    {
+        return SharedDataBlob();
+    }
+
+    parent.is_view_ = true;
+    parent.offset_ += offset;
+    parent.row_bytes_ = row_bytes;
+    parent.rows_ = rows;
+    parent.stride_ = stride;
+    return parent;
+}
+
+
+
+bool SharedDataBlob::isView() const
+{
+    return is_view_;
+}
+
+
+
+uint64_t SharedDataBlob::rows()
+{
+    return rows_;
+}
+
+
+
+uint64_t SharedDataBlob::rowBytes()
+{
+    return is_view_ ? row_bytes_ : data_->size();
+}
+
+
+
+uint64_t SharedDataBlob::stride()
+{
+    return is_view_ ? stride_ : data_->size();
+}
+
+
+
+bool SharedDataBlob::unique() const
+{
+    // acquire pairs with the release decrement of the previous owners, their accesses happen before our writes
+    if (allocator_ == nullptr || data_ == nullptr)
+    {
+        return false;
+    }
+
+    ICountedSharedData* counted = data_->counted();
+    return counted != nullptr && counted->owners_.load(std::memory_order_acquire) == 1;
+}
+
+
+
+bool SharedDataBlob::makeWritable(IAllocator* allocator)
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    if (unique())
+    {
+        return true;
+    }
+
+    uint64_t size = this->size();
+    SharedDataBlob copy = ((allocator != nullptr) ? allocator : allocator_)->allocate(size);
+    if (!copy.valid() || copy.size() < size)
+    {
+        return false;
+    }
+
+    std::memcpy(copy.data(), data(), size);
+    if (is_view_ || copy.size() != size)
+    {
+        copy = copy.view2D(0, rowBytes(), rows(), stride());
+    }
+
+    swap(copy);
+    return true;
+}
+
+
+
+void SharedDataBlob::swap(SharedDataBlob& other) noexcept
+{
+    std::swap(data_, other.data_);
+    std::swap(allocator_, other.allocator_);
+    std::swap(is_view_, other.is_view_);
+    std::swap(offset_, other.offset_);
+    std::swap(row_bytes_, other.row_bytes_);
+    std::swap(rows_, other.rows_);
+    std::swap(stride_, other.stride_);
 }
\ No newline at end of file
@@ -0,0 +1,800 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "module_common/dll_module_wrapper.h"
+#include "module_common/message_envelope.h"
+#include "utils/executor/work_stealing_executor.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace aergo::module;
+
+
+
+namespace
+{
+    constexpr uint32_t channel_count = 4;
+    constexpr uint64_t messages_per_channel = 50;
+
+    // POOL runs the module on the executors of TestCore
+    constexpr ExecutionMode execution_modes[] = { ExecutionMode::DEDICATED_THREADS, ExecutionMode::POOL };
+
+    class SilentModuleLogger : public logging::ILogger
+    {
+    public:
+        void log(logging::LogType type, const char* message) const noexcept override {}
+    };
+
+
+
+    /// @brief Provides executors for ExecutionMode::POOL and records responses sent by the wrapper, everything else is unused.
+    class TestCore : public ICore
+    {
+    public:
+        struct Response
+        {
+            ChannelIdentifier source_channel_;
+            ChannelIdentifier target_channel_;
+            uint64_t id_;
+            bool success_;
+        };
+
+        void sendMessage(ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+        IPublishHandle* getPublishHandle(ChannelIdentifier source_channel) noexcept override { return nullptr; }
+        void sendMessage(IPublishHandle* publish_handle, message::MessageHeader message) noexcept override {}
+
+        void sendResponse(ChannelIdentifier source_channel, ChannelIdentifier target_channel, message::MessageHeader message) noexcept override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            responses_.push_back({ source_channel, target_channel, message.id_, message.success_ });
+        }
+
+        void sendRequest(ChannelIdentifier source_channel, ChannelIdentifier target_channel, message::MessageHeader message) noexcept override {}
+        IAllocator* createDynamicAllocator(uint64_t module_id, AllocationOptions options) noexcept override { return nullptr; }
+        IAllocator* createBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, uint32_t number_of_slots, AllocationOptions options) noexcept override { return nullptr; }
+        IAllocator* createElasticBufferAllocator(uint64_t module_id, uint64_t slot_size_bytes, ElasticBufferOptions options, AllocationOptions allocation_options) noexcept override { return nullptr; }
+        IAllocator* createMappedFileAllocator(uint64_t module_id, const char* path, MappedFileOptions options) noexcept override { return nullptr; }
+        void deleteAllocator(IAllocator* allocator) noexcept override {}
+        IExecutor* getExecutor(bool prioritized) noexcept override { return prioritized ? &prioritized_executor_ : &regular_executor_; }
+
+        const ModuleInfo* getLoadedModulesInfo(uint64_t loaded_module_id) noexcept override { return nullptr; }
+        uint64_t getLoadedModulesCount() noexcept override { return 0; }
+        RunningModuleInfo getRunningModulesInfo(uint64_t running_module_id) noexcept override { return {}; }
+        uint64_t getRunningModulesCount() noexcept override { return 0; }
+        uint64_t getModulesMappingStateId() noexcept override { return 0; }
+        message::SharedDataBlob getTopologySnapshot() noexcept override { return {}; }
+        bool addModule(uint64_t loaded_module_id, InputChannelMapInfo channel_map_info) noexcept override { return false; }
+        message::SharedDataBlob collectDependencies(uint64_t id) noexcept override { return {}; }
+        bool removeModuleById(uint64_t id, bool recursive) noexcept override { return false; }
+        bool applyModuleBatch(aergo::module::ModuleBatch batch) noexcept override { return false; }
+        message::SharedDataBlob getExistingPublishChannelsByName(const char* channel_type_identifier) noexcept override { return {}; }
+        message::SharedDataBlob getExistingResponseChannelsByName(const char* channel_type_identifier) noexcept override { return {}; }
+        MemoryStats getModuleMemoryStats(uint64_t module_id) noexcept override { return {}; }
+        message::SharedDataBlob getModuleAllocatorsMemoryStats(uint64_t module_id) noexcept override { return {}; }
+        void setModuleMemoryQuota(uint64_t module_id, uint64_t quota_bytes) noexcept override {}
+        void setAllocationSampling(uint32_t sample_period) noexcept override {}
+        message::SharedDataBlob getOutstandingAllocations(uint64_t min_age_ns) noexcept override { return {}; }
+
+        aergo::core::executor::WorkStealingExecutor prioritized_executor_{ 1 };
+        aergo::core::executor::WorkStealingExecutor regular_executor_{ channel_count };
+        std::mutex mutex_;
+        std::vector<Response> responses_;
+    };
+
+
+
+    /// @brief Records per-channel order and how many items run concurrently (per channel and in total).
+    class StrandCheckingModule : public IModule
+    {
+    public:
+        bool valid() noexcept override { return true; }
+        void* query_capability(const std::type_info& id) noexcept override { return nullptr; }
+
+        IngressDecision onIngress(ProcessingType kind, uint32_t local_channel_id, ChannelIdentifier src, const message::MessageHeader& msg, QueueStatus queue_status) noexcept override
+        {
+            return IngressDecision::ACCEPT;
+        }
+
+        void processMessage(uint32_t subscribe_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override
+        {
+            if (++in_flight_[subscribe_consumer_id] > 1)
+            {
+                channel_overlap_ = true;
+            }
+
+            uint32_t total = ++total_in_flight_;
+            uint32_t max_total = max_total_in_flight_;
+            while (total > max_total && !max_total_in_flight_.compare_exchange_weak(max_total, total)) {}
+
+            if (message.id_ != next_id_[subscribe_consumer_id])
+            {
+                out_of_order_ = true;
+            }
+            next_id_[subscribe_consumer_id] = message.id_ + 1;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+            --total_in_flight_;
+            --in_flight_[subscribe_consumer_id];
+            ++processed_;
+        }
+
+        void processRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+        void processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+
+        std::atomic<uint32_t> in_flight_[channel_count] = {};
+        uint64_t next_id_[channel_count] = {};
+        std::atomic<uint32_t> total_in_flight_{0};
+        std::atomic<uint32_t> max_total_in_flight_{0};
+        std::atomic<uint64_t> processed_{0};
+        std::atomic<bool> channel_overlap_{false};
+        std::atomic<bool> out_of_order_{false};
+    };
+
+
+
+    const communication_channel::Consumer strand_consumers[channel_count] = {
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = messages_per_channel },
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = messages_per_channel },
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = messages_per_channel },
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = messages_per_channel }
+    };
+
+    const ModuleInfo strand_module_info = {
+        .display_name_ = "Strands",
+        .display_description_ = "",
+        .publish_producers_ = nullptr,
+        .publish_producer_count_ = 0,
+        .response_producers_ = nullptr,
+        .response_producer_count_ = 0,
+        .subscribe_consumers_ = strand_consumers,
+        .subscribe_consumer_count_ = channel_count,
+        .request_consumers_ = nullptr,
+        .request_consumer_count_ = 0,
+        .auto_create_ = false,
+        .prioritized_workers_count_ = 1,
+        .regular_workers_count_ = channel_count,
+        .execution_mode_ = ExecutionMode::DEDICATED_THREADS,
+        .channel_strands_ = true
+    };
+}
+
+
+
+TEST_CASE("DllModuleWrapper channel strands", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+    TestCore core;
+
+    for (ExecutionMode execution_mode : execution_modes)
+    {
+        auto module = std::make_unique<StrandCheckingModule>();
+        StrandCheckingModule* module_ref = module.get();
+        ModuleInfo module_info = strand_module_info;
+        module_info.execution_mode_ = execution_mode;
+
+        dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, &core, 0);
+        REQUIRE(wrapper.threadStart(1000));
+
+        for (uint64_t id = 0; id < messages_per_channel; ++id)
+        {
+            for (uint32_t channel = 0; channel < channel_count; ++channel)
+            {
+                message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = id, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+                wrapper.processMessage(channel, { .producer_module_id_ = 0, .producer_channel_id_ = channel }, message);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        while (module_ref->processed_ < channel_count * messages_per_channel && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(wrapper.threadStop(1000));
+
+        REQUIRE(module_ref->processed_ == channel_count * messages_per_channel);
+        REQUIRE(!module_ref->channel_overlap_);
+        REQUIRE(!module_ref->out_of_order_);
+        REQUIRE(module_ref->max_total_in_flight_ > 1);
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper destroyed while draining", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+    TestCore core;
+    ModuleInfo module_info = strand_module_info;
+    module_info.execution_mode_ = ExecutionMode::POOL;
+
+    {
+        dll::DllModuleWrapper wrapper(std::make_unique<StrandCheckingModule>(), &module_info, &logger, &core, 0);
+        REQUIRE(wrapper.threadStart(1000));
+
+        for (uint64_t id = 0; id < messages_per_channel; ++id)
+        {
+            for (uint32_t channel = 0; channel < channel_count; ++channel)
+            {
+                message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = id, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+                wrapper.processMessage(channel, { .producer_module_id_ = 0, .producer_channel_id_ = channel }, message);
+            }
+        }
+
+        // no threadStop, the destructor waits for the drain tasks on the executor
+    }
+
+    // executor workers run on without touching the destroyed wrapper
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    core.regular_executor_.stop();
+    core.prioritized_executor_.stop();
+}
+
+
+
+namespace
+{
+    /// @brief Records the (channel, message id) processing order.
+    class RecordingModule : public IModule
+    {
+    public:
+        bool valid() noexcept override { return true; }
+        void* query_capability(const std::type_info& id) noexcept override { return nullptr; }
+
+        IngressDecision onIngress(ProcessingType kind, uint32_t local_channel_id, ChannelIdentifier src, const message::MessageHeader& msg, QueueStatus queue_status) noexcept override
+        {
+            return IngressDecision::ACCEPT;
+        }
+
+        void processMessage(uint32_t subscribe_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            order_.push_back({ subscribe_consumer_id, message.id_ });
+        }
+
+        void processRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requests_.push_back(message.id_);
+        }
+
+        void processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+
+        size_t processed()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return order_.size() + requests_.size();
+        }
+
+        std::mutex mutex_;
+        std::vector<std::pair<uint32_t, uint64_t>> order_;
+        std::vector<uint64_t> requests_;
+    };
+
+
+
+    communication_channel::Consumer scheduledConsumer(uint16_t weight, uint32_t latency_budget_us)
+    {
+        return {
+            .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0,
+            .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "",
+            .prioritized_ = false, .message_queue_capacity_ = 16, .weight_ = weight, .latency_budget_us_ = latency_budget_us
+        };
+    }
+
+
+
+    ModuleInfo scheduledModuleInfo(const communication_channel::Consumer* consumers, uint32_t consumer_count, SchedulingPolicy scheduling_policy, ExecutionMode execution_mode)
+    {
+        return {
+            .display_name_ = "Scheduling",
+            .display_description_ = "",
+            .publish_producers_ = nullptr,
+            .publish_producer_count_ = 0,
+            .response_producers_ = nullptr,
+            .response_producer_count_ = 0,
+            .subscribe_consumers_ = consumers,
+            .subscribe_consumer_count_ = consumer_count,
+            .request_consumers_ = nullptr,
+            .request_consumer_count_ = 0,
+            .auto_create_ = false,
+            .prioritized_workers_count_ = 1,
+            .regular_workers_count_ = 1,
+            .execution_mode_ = execution_mode,
+            .channel_strands_ = false,
+            .scheduling_policy_ = scheduling_policy
+        };
+    }
+
+
+
+    /// @brief Queue messages before the worker starts (so the scheduler sees all of them), then process all of them.
+    void runQueued(dll::DllModuleWrapper& wrapper, RecordingModule* module, const std::vector<std::pair<uint32_t, uint64_t>>& messages, uint64_t timestamp_ns)
+    {
+        for (const auto& [channel, id] : messages)
+        {
+            message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = id, .timestamp_ns_ = timestamp_ns, .success_ = true, .deadline_ns_ = 0 };
+            wrapper.processMessage(channel, { .producer_module_id_ = 0, .producer_channel_id_ = channel }, message);
+        }
+
+        REQUIRE(wrapper.threadStart(1000));
+
+        auto start = std::chrono::steady_clock::now();
+        while (module->processed() < messages.size() && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(wrapper.threadStop(1000));
+        REQUIRE(module->processed() == messages.size());
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper scheduling policies", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+    TestCore core;
+
+    SECTION("weighted fair")
+    {
+        for (ExecutionMode execution_mode : execution_modes)
+        {
+            auto module = std::make_unique<RecordingModule>();
+            RecordingModule* module_ref = module.get();
+            communication_channel::Consumer consumers[2] = { scheduledConsumer(3, 0), scheduledConsumer(1, 0) };
+            ModuleInfo module_info = scheduledModuleInfo(consumers, 2, SchedulingPolicy::WEIGHTED_FAIR, execution_mode);
+            dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, &core, 0);
+
+            std::vector<std::pair<uint32_t, uint64_t>> messages;
+            for (uint64_t id = 0; id < 6; ++id)
+            {
+                messages.push_back({ 0, id });
+                messages.push_back({ 1, id });
+            }
+            runQueued(wrapper, module_ref, messages, 0);
+
+            std::vector<uint32_t> channel_order;
+            for (const auto& [channel, id] : module_ref->order_)
+            {
+                channel_order.push_back(channel);
+            }
+            REQUIRE(channel_order == std::vector<uint32_t>{ 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1, 1 });
+        }
+    }
+
+    SECTION("earliest deadline first")
+    {
+        for (ExecutionMode execution_mode : execution_modes)
+        {
+            auto module = std::make_unique<RecordingModule>();
+            RecordingModule* module_ref = module.get();
+            communication_channel::Consumer consumers[3] = { scheduledConsumer(1, 0), scheduledConsumer(1, 1000), scheduledConsumer(1, 100) };
+            ModuleInfo module_info = scheduledModuleInfo(consumers, 3, SchedulingPolicy::EARLIEST_DEADLINE_FIRST, execution_mode);
+            dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, &core, 0);
+
+            std::vector<std::pair<uint32_t, uint64_t>> messages;
+            for (uint64_t id = 0; id < 4; ++id)
+            {
+                messages.push_back({ 0, id });
+                messages.push_back({ 1, id });
+                messages.push_back({ 2, id });
+            }
+
+            // timestamp 10 ms in the past, all deadlines are already missed
+            uint64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - 10'000'000;
+            runQueued(wrapper, module_ref, messages, timestamp_ns);
+
+            std::vector<std::pair<uint32_t, uint64_t>> expected;
+            for (uint32_t channel : { 2, 1, 0 })
+            {
+                for (uint64_t id = 0; id < 4; ++id)
+                {
+                    expected.push_back({ channel, id });
+                }
+            }
+            REQUIRE(module_ref->order_ == expected);
+
+            REQUIRE(wrapper.getDeadlineMissCount(IModule::ProcessingType::MESSAGE, 0) == 0);
+            REQUIRE(wrapper.getDeadlineMissCount(IModule::ProcessingType::MESSAGE, 1) == 4);
+            REQUIRE(wrapper.getDeadlineMissCount(IModule::ProcessingType::MESSAGE, 2) == 4);
+            REQUIRE(wrapper.getDeadlineMissCount(IModule::ProcessingType::MESSAGE, 3) == 0);
+        }
+    }
+}
+
+
+
+namespace
+{
+    uint64_t steadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper expiry", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+
+    for (ExecutionMode execution_mode : execution_modes)
+    {
+        TestCore core;
+        auto module = std::make_unique<RecordingModule>();
+        RecordingModule* module_ref = module.get();
+
+        const communication_channel::Consumer consumers[1] = {
+            { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = 16, .ttl_us_ = 2000 }
+        };
+        const communication_channel::Producer producers[1] = {
+            { .channel_type_identifier_ = "r", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = 16 }
+        };
+        const ModuleInfo module_info = {
+            .display_name_ = "Expiry",
+            .display_description_ = "",
+            .publish_producers_ = nullptr,
+            .publish_producer_count_ = 0,
+            .response_producers_ = producers,
+            .response_producer_count_ = 1,
+            .subscribe_consumers_ = consumers,
+            .subscribe_consumer_count_ = 1,
+            .request_consumers_ = nullptr,
+            .request_consumer_count_ = 0,
+            .auto_create_ = false,
+            .prioritized_workers_count_ = 1,
+            .regular_workers_count_ = 1,
+            .execution_mode_ = execution_mode
+        };
+
+        constexpr uint64_t module_id = 9;
+        const ChannelIdentifier requester { .producer_module_id_ = 3, .producer_channel_id_ = 1 };
+        dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, &core, module_id);
+
+        auto send = [&](IModule::ProcessingType type, uint64_t id, uint64_t timestamp_ns, uint64_t deadline_ns) {
+            message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = id, .timestamp_ns_ = timestamp_ns, .success_ = true, .deadline_ns_ = deadline_ns };
+            if (type == IModule::ProcessingType::MESSAGE)
+            {
+                wrapper.processMessage(0, { .producer_module_id_ = 0, .producer_channel_id_ = 0 }, message);
+            }
+            else
+            {
+                wrapper.processRequest(0, requester, message);
+            }
+        };
+
+        uint64_t now_ns = steadyNowNs();
+        send(IModule::ProcessingType::MESSAGE, 0, now_ns - 10'000'000, 0);     // stale on arrival
+        send(IModule::ProcessingType::MESSAGE, 1, now_ns, 0);                  // goes stale in the queue
+        send(IModule::ProcessingType::MESSAGE, 2, 0, 0);                       // no timestamp, never expires
+        send(IModule::ProcessingType::REQUEST, 10, now_ns, now_ns - 1);        // deadline passed on arrival
+        send(IModule::ProcessingType::REQUEST, 11, now_ns, now_ns + 1'000'000); // deadline passes in the queue
+        send(IModule::ProcessingType::REQUEST, 12, now_ns, 0);                 // no deadline, no TTL on the channel
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        REQUIRE(wrapper.threadStart(1000));
+
+        auto start = std::chrono::steady_clock::now();
+        while (module_ref->processed() < 2 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // expired items would have been processed by now
+
+        REQUIRE(wrapper.threadStop(1000));
+
+        REQUIRE(module_ref->order_ == std::vector<std::pair<uint32_t, uint64_t>>{ { 0, 2 } });
+        REQUIRE(module_ref->requests_ == std::vector<uint64_t>{ 12 });
+
+        REQUIRE(wrapper.getExpiredCount(IModule::ProcessingType::MESSAGE, 0) == 2);
+        REQUIRE(wrapper.getExpiredCount(IModule::ProcessingType::REQUEST, 0) == 2);
+        REQUIRE(wrapper.getExpiredCount(IModule::ProcessingType::RESPONSE, 0) == 0);
+
+        REQUIRE(core.responses_.size() == 2);
+        for (size_t i = 0; i < core.responses_.size(); ++i)
+        {
+            const auto& response = core.responses_[i];
+            REQUIRE(response.id_ == 10 + i);
+            REQUIRE(!response.success_);
+            REQUIRE(response.source_channel_.producer_module_id_ == module_id);
+            REQUIRE(response.source_channel_.producer_channel_id_ == 0);
+            REQUIRE(response.target_channel_.producer_module_id_ == requester.producer_module_id_);
+            REQUIRE(response.target_channel_.producer_channel_id_ == requester.producer_channel_id_);
+        }
+    }
+}
+
+
+
+namespace
+{
+    class CountingModule : public IModule
+    {
+    public:
+        bool valid() noexcept override { return true; }
+        void* query_capability(const std::type_info& id) noexcept override { return nullptr; }
+
+        IngressDecision onIngress(ProcessingType kind, uint32_t local_channel_id, ChannelIdentifier src, const message::MessageHeader& msg, QueueStatus queue_status) noexcept override
+        {
+            return IngressDecision::ACCEPT;
+        }
+
+        void processMessage(uint32_t subscribe_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override { ++processed_; }
+        void processRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+        void processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+
+        std::atomic<uint64_t> processed_{0};
+    };
+
+
+
+    const communication_channel::Consumer wait_consumers[2] = {
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = true, .message_queue_capacity_ = 256 },
+        { .count_ = communication_channel::Consumer::Count::SINGLE, .min_ = 0, .max_ = 0, .channel_type_identifier_ = "m", .display_name_ = "", .display_description_ = "", .prioritized_ = false, .message_queue_capacity_ = 256 }
+    };
+
+    ModuleInfo waitModuleInfo(WaitStrategy wait_strategy)
+    {
+        return {
+            .display_name_ = "Wait",
+            .display_description_ = "",
+            .publish_producers_ = nullptr,
+            .publish_producer_count_ = 0,
+            .response_producers_ = nullptr,
+            .response_producer_count_ = 0,
+            .subscribe_consumers_ = wait_consumers,
+            .subscribe_consumer_count_ = 2,
+            .request_consumers_ = nullptr,
+            .request_consumer_count_ = 0,
+            .auto_create_ = false,
+            .prioritized_workers_count_ = 1,
+            .regular_workers_count_ = 2,
+            .execution_mode_ = ExecutionMode::DEDICATED_THREADS,
+            .prioritized_wait_strategy_ = wait_strategy,
+            .regular_wait_strategy_ = wait_strategy,
+            .wait_spin_us_ = 50
+        };
+    }
+
+
+
+    /// @brief Send one message and wait (spinning) until the module processed it.
+    void pingPong(dll::DllModuleWrapper& wrapper, CountingModule* module, uint32_t channel)
+    {
+        uint64_t expected = module->processed_ + 1;
+        message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+        wrapper.processMessage(channel, { .producer_module_id_ = 0, .producer_channel_id_ = channel }, message);
+        while (module->processed_ < expected) {}
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper wait strategies", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+
+    for (WaitStrategy wait_strategy : { WaitStrategy::BLOCKING, WaitStrategy::SPIN_THEN_PARK, WaitStrategy::BUSY_POLL })
+    {
+        auto module = std::make_unique<CountingModule>();
+        CountingModule* module_ref = module.get();
+        ModuleInfo module_info = waitModuleInfo(wait_strategy);
+        dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, nullptr, 0);
+        REQUIRE(wrapper.threadStart(1000));
+
+        // mix of messages arriving while workers spin and while they sleep
+        for (uint32_t i = 0; i < 200; ++i)
+        {
+            message::MessageHeader message { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = i, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+            wrapper.processMessage(i % 2, { .producer_module_id_ = 0, .producer_channel_id_ = i % 2 }, message);
+            if (i % 10 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        while (module_ref->processed_ < 200 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(module_ref->processed_ == 200);
+        REQUIRE(wrapper.threadStop(1000)); // spinning workers see the stop too
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper wake-up latency", "[.][benchmark][dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+
+    auto run = [&](const char* name, WaitStrategy wait_strategy, uint32_t channel) {
+        auto module = std::make_unique<CountingModule>();
+        CountingModule* module_ref = module.get();
+        ModuleInfo module_info = waitModuleInfo(wait_strategy);
+        dll::DllModuleWrapper wrapper(std::move(module), &module_info, &logger, nullptr, 0);
+        REQUIRE(wrapper.threadStart(1000));
+
+        BENCHMARK(name)
+        {
+            pingPong(wrapper, module_ref, channel);
+        };
+
+        REQUIRE(wrapper.threadStop(1000));
+    };
+
+    run("prioritized BLOCKING", WaitStrategy::BLOCKING, 0);
+    run("prioritized SPIN_THEN_PARK", WaitStrategy::SPIN_THEN_PARK, 0);
+    run("prioritized BUSY_POLL", WaitStrategy::BUSY_POLL, 0);
+    run("regular BLOCKING", WaitStrategy::BLOCKING, 1);
+    run("regular SPIN_THEN_PARK", WaitStrategy::SPIN_THEN_PARK, 1);
+    run("regular BUSY_POLL", WaitStrategy::BUSY_POLL, 1);
+}
+
+
+namespace
+{
+    /// @brief Owner count in the shared data itself, real memory.
+    class BufferSharedData : public ICountedSharedData
+    {
+    public:
+        BufferSharedData(uint64_t size) : buffer_(size) {}
+
+        bool valid() noexcept override { return true; }
+        uint8_t* data() noexcept override { return buffer_.data(); }
+        uint64_t size() noexcept override { return buffer_.size(); }
+
+    private:
+        std::vector<uint8_t> buffer_;
+
+        friend class BufferAllocator;
+    };
+
+
+
+    /// @brief Frees data on the last owner.
+    class BufferAllocator : public IAllocator
+    {
+    public:
+        message::SharedDataBlob allocate(uint64_t number_of_bytes) noexcept override
+        {
+            ++allocations_;
+            ++live_;
+            return message::SharedDataBlob(new BufferSharedData(number_of_bytes), this);
+        }
+
+        std::atomic<uint64_t> allocations_{0};
+        std::atomic<int64_t> live_{0};
+
+    protected:
+        void addOwner(ISharedData* data) noexcept override {}
+
+        void removeOwner(ISharedData* data) noexcept override
+        {
+            if (--static_cast<BufferSharedData*>(data)->owners_ == 0)
+            {
+                --live_;
+                delete data;
+            }
+        }
+    };
+
+
+
+    /// @brief Reads the first byte of the received blob, the writing module makes a copy of the blob writable and overwrites it.
+    class BlobModule : public IModule
+    {
+    public:
+        BlobModule(bool write) : write_(write) {}
+
+        bool valid() noexcept override { return true; }
+        void* query_capability(const std::type_info& id) noexcept override { return nullptr; }
+
+        IngressDecision onIngress(ProcessingType kind, uint32_t local_channel_id, ChannelIdentifier src, const message::MessageHeader& msg, QueueStatus queue_status) noexcept override
+        {
+            return IngressDecision::ACCEPT;
+        }
+
+        void processMessage(uint32_t subscribe_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override
+        {
+            received_data_ = message.blobs_[0].data();
+            received_value_ = message.blobs_[0].data()[0];
+            received_unique_ = message.blobs_[0].unique();
+            if (write_)
+            {
+                message::SharedDataBlob blob = message.blobs_[0];
+                if (blob.makeWritable())
+                {
+                    written_data_ = blob.data();
+                    blob.data()[0] = 99;
+                }
+            }
+            ++processed_;
+        }
+
+        void processRequest(uint32_t response_producer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+        void processResponse(uint32_t request_consumer_id, ChannelIdentifier source_channel, message::MessageHeader message) noexcept override {}
+
+        bool write_;
+        std::atomic<uint8_t*> received_data_{nullptr};
+        std::atomic<uint8_t> received_value_{0};
+        std::atomic<bool> received_unique_{false};
+        std::atomic<uint8_t*> written_data_{nullptr};
+        std::atomic<uint64_t> processed_{0};
+    };
+
+
+
+    void waitProcessed(BlobModule* module)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (module->processed_ == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+
+
+TEST_CASE("DllModuleWrapper received blobs are shared", "[dll_module_wrapper]")
+{
+    SilentModuleLogger logger;
+    BufferAllocator allocator;
+    ModuleInfo module_info = waitModuleInfo(WaitStrategy::BLOCKING);
+    const ChannelIdentifier source { .producer_module_id_ = 0, .producer_channel_id_ = 0 };
+
+    message::SharedDataBlob blob = allocator.allocate(16);
+    std::memset(blob.data(), 7, 16);
+    uint8_t* original_data = blob.data();
+    message::MessageHeader header { .data_ = nullptr, .data_len_ = 0, .blobs_ = &blob, .blob_count_ = 1, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(header));
+    REQUIRE(envelope);
+    blob = message::SharedDataBlob();   // sender is done, only the envelope holds the data
+
+    {
+        auto writer = std::make_unique<BlobModule>(true);
+        auto reader = std::make_unique<BlobModule>(false);
+        BlobModule* writer_ref = writer.get();
+        BlobModule* reader_ref = reader.get();
+        dll::DllModuleWrapper writer_wrapper(std::move(writer), &module_info, &logger, nullptr, 0);
+        dll::DllModuleWrapper reader_wrapper(std::move(reader), &module_info, &logger, nullptr, 1);
+
+        writer_wrapper.processEnvelope(IModule::ProcessingType::MESSAGE, 0, source, envelope.get());
+        reader_wrapper.processEnvelope(IModule::ProcessingType::MESSAGE, 0, source, envelope.get());
+        envelope = message::EnvelopeRef();
+
+        // the writer runs first, its copy of the blob shares the data with the envelope
+        REQUIRE(writer_wrapper.threadStart(1000));
+        waitProcessed(writer_ref);
+        REQUIRE(writer_wrapper.threadStop(1000));
+
+        REQUIRE(reader_wrapper.threadStart(1000));
+        waitProcessed(reader_ref);
+        REQUIRE(reader_wrapper.threadStop(1000));
+
+        REQUIRE(writer_ref->processed_ == 1);
+        REQUIRE(writer_ref->received_data_ == original_data);
+        REQUIRE(writer_ref->received_unique_);  // deliveries add no owners
+        REQUIRE(writer_ref->written_data_ != nullptr);
+        REQUIRE(writer_ref->written_data_ != original_data);
+        REQUIRE(allocator.allocations_ == 2);
+
+        REQUIRE(reader_ref->processed_ == 1);
+        REQUIRE(reader_ref->received_data_ == original_data);
+        REQUIRE(reader_ref->received_value_ == 7);
+        REQUIRE(reader_ref->received_unique_);
+    }
+
+    REQUIRE(allocator.live_ == 0);
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "module_common/message_envelope.h"
+
+#include <cstring>
+
+using namespace aergo::module;
+
+
+
+namespace
+{
+    class CountingSharedData : public ISharedData
+    {
+    public:
+        bool valid() noexcept override { return true; }
+        uint8_t* data() noexcept override { return nullptr; }
+        uint64_t size() noexcept override { return 0; }
+
+        uint64_t owners_ = 0;
+    };
+
+
+
+    class CountingAllocator : public IAllocator
+    {
+    public:
+        message::SharedDataBlob allocate(uint64_t number_of_bytes) noexcept override { return message::SharedDataBlob(&data_, this); }
+
+        CountingSharedData data_;
+        uint64_t add_owner_calls_ = 0;
+
+    protected:
+        void addOwner(ISharedData* data) noexcept override { ++add_owner_calls_; ++((CountingSharedData*)data)->owners_; }
+        void removeOwner(ISharedData* data) noexcept override { --((CountingSharedData*)data)->owners_; }
+    };
+}
+
+
+
+TEST_CASE("MessageEnvelope", "[message_envelope]")
+{
+    CountingAllocator allocator;
+    uint8_t payload[5] = { 1, 2, 3, 4, 5 };
+
+    SECTION("copies data and references blobs")
+    {
+        message::SharedDataBlob blobs[2] = { allocator.allocate(1), allocator.allocate(1) };
+        REQUIRE(allocator.data_.owners_ == 2);
+
+        message::MessageHeader header { .data_ = payload, .data_len_ = sizeof(payload), .blobs_ = blobs, .blob_count_ = 2, .id_ = 7, .timestamp_ns_ = 11, .success_ = true, .deadline_ns_ = 0 };
+        message::MessageEnvelope* envelope = message::MessageEnvelope::create(header);
+        REQUIRE(envelope != nullptr);
+        REQUIRE(envelope->refCount() == 1);
+        REQUIRE(allocator.data_.owners_ == 4);
+
+        const message::MessageHeader& message = envelope->message();
+        REQUIRE(message.data_ != payload);
+        REQUIRE(message.data_len_ == sizeof(payload));
+        REQUIRE(std::memcmp(message.data_, payload, sizeof(payload)) == 0);
+        REQUIRE(message.blob_count_ == 2);
+        REQUIRE(message.blobs_ != blobs);
+        REQUIRE(message.id_ == 7);
+        REQUIRE(message.timestamp_ns_ == 11);
+        REQUIRE(message.success_);
+
+        payload[0] = 42;
+        REQUIRE(message.data_[0] == 1);
+
+        envelope->release();
+        REQUIRE(allocator.data_.owners_ == 2);
+    }
+
+    SECTION("empty message")
+    {
+        message::MessageHeader header { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = false, .deadline_ns_ = 0 };
+        message::EnvelopeRef envelope(message::MessageEnvelope::create(header));
+        REQUIRE(envelope);
+        REQUIRE(envelope->message().data_len_ == 0);
+        REQUIRE(envelope->message().blob_count_ == 0);
+    }
+
+    SECTION("sharing does not touch the allocator")
+    {
+        message::SharedDataBlob blob = allocator.allocate(1);
+        message::MessageHeader header { .data_ = payload, .data_len_ = sizeof(payload), .blobs_ = &blob, .blob_count_ = 1, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+
+        message::EnvelopeRef envelope(message::MessageEnvelope::create(header));
+        uint64_t add_owner_calls = allocator.add_owner_calls_;
+
+        {
+            std::vector<message::EnvelopeRef> receivers(64, envelope);
+            REQUIRE(envelope->refCount() == 65);
+            REQUIRE(allocator.add_owner_calls_ == add_owner_calls);
+
+            message::EnvelopeRef moved = std::move(receivers[0]);
+            REQUIRE(!receivers[0]);
+            REQUIRE(envelope->refCount() == 65);
+
+            receivers[1] = moved;
+            REQUIRE(envelope->refCount() == 65);
+
+            receivers[2] = message::EnvelopeRef();
+            REQUIRE(envelope->refCount() == 64);
+        }
+
+        REQUIRE(envelope->refCount() == 1);
+        REQUIRE(allocator.data_.owners_ == 2);
+        envelope = message::EnvelopeRef();
+        REQUIRE(allocator.data_.owners_ == 1);
+    }
+}
\ No newline at end of file
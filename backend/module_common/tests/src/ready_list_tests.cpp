@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "module_common/ready_list.h"
+
+using namespace aergo::module;
+
+
+
+TEST_CASE("ReadyList", "[ready_list]")
+{
+    dll::ReadyList list(4);
+    REQUIRE(list.empty());
+
+    SECTION("fifo order, no duplicates")
+    {
+        list.pushBack(2);
+        list.pushBack(0);
+        list.pushBack(2);
+        list.pushBack(3);
+        REQUIRE(list.contains(2));
+        REQUIRE(!list.contains(1));
+
+        REQUIRE(list.popFront() == 2);
+        REQUIRE(!list.contains(2));
+        REQUIRE(list.popFront() == 0);
+        REQUIRE(list.popFront() == 3);
+        REQUIRE(list.empty());
+    }
+
+    SECTION("round-robin rotation")
+    {
+        list.pushBack(0);
+        list.pushBack(1);
+        list.pushBack(2);
+
+        for (uint32_t expected : { 0, 1, 2, 0, 1, 2, 0 })
+        {
+            uint32_t idx = list.popFront();
+            REQUIRE(idx == expected);
+            list.pushBack(idx);
+        }
+    }
+
+    SECTION("push front and remove from the middle")
+    {
+        list.pushBack(1);
+        list.pushBack(2);
+        list.pushFront(3);
+        list.pushFront(1);
+        REQUIRE(list.front() == 3);
+        REQUIRE(list.next(3) == 1);
+        REQUIRE(list.next(1) == 2);
+        REQUIRE(list.next(2) == dll::ReadyList::NONE);
+
+        list.remove(1);
+        list.remove(0);
+        REQUIRE(!list.contains(1));
+        REQUIRE(list.next(3) == 2);
+
+        list.pushBack(1);
+        list.remove(3);
+        REQUIRE(list.popFront() == 2);
+        REQUIRE(list.popFront() == 1);
+        REQUIRE(list.empty());
+    }
+
+        SECTION("reuse after empty")
+    {
+        list.pushBack(1);
+        REQUIRE(list.popFront() == 1);
+        REQUIRE(list.empty());
+
+        list.pushBack(3);
+        list.pushBack(1);
+        REQUIRE(list.popFront() == 3);
+        REQUIRE(list.popFront() == 1);
+        REQUIRE(list.empty());
+    }
+}
\ No newline at end of file
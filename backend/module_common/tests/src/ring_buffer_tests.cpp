@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "module_common/ring_buffer.h"
+#include "module_common/message_envelope.h"
+
+#include <queue>
+#include <vector>
+
+using namespace aergo::module;
+
+
+
+TEST_CASE("RingBuffer", "[ring_buffer]")
+{
+    dll::RingBuffer<uint32_t> buffer(3);
+    uint32_t value = 0;
+
+    REQUIRE(buffer.capacity() == 3);
+    REQUIRE(buffer.empty());
+    REQUIRE(!buffer.pop(value));
+
+    SECTION("fifo order with wrap-around")
+    {
+        for (uint32_t round = 0; round < 10; ++round)
+        {
+            REQUIRE(buffer.push(round * 2));
+            REQUIRE(buffer.push(round * 2 + 1));
+            REQUIRE(buffer.size() == 2);
+
+            REQUIRE(buffer.pop(value));
+            REQUIRE(value == round * 2);
+            REQUIRE(buffer.pop(value));
+            REQUIRE(value == round * 2 + 1);
+            REQUIRE(buffer.empty());
+        }
+    }
+
+    SECTION("full and clear")
+    {
+        REQUIRE(buffer.push(1));
+        REQUIRE(buffer.push(2));
+        REQUIRE(buffer.push(3));
+        REQUIRE(buffer.full());
+        REQUIRE(!buffer.push(4));
+
+        REQUIRE(buffer.pop());
+        REQUIRE(buffer.push(4));
+        REQUIRE(buffer.pop(value));
+        REQUIRE(value == 2);
+
+        buffer.clear();
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.push(5));
+        REQUIRE(buffer.pop(value));
+        REQUIRE(value == 5);
+    }
+
+    SECTION("minimum capacity")
+    {
+        dll::RingBuffer<uint32_t> small(0);
+        REQUIRE(small.capacity() == 1);
+        REQUIRE(small.push(1));
+        REQUIRE(!small.push(2));
+    }
+}
+
+
+
+TEST_CASE("RingBuffer releases popped elements", "[ring_buffer]")
+{
+    message::MessageHeader header { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(header));
+
+    dll::RingBuffer<message::EnvelopeRef> buffer(2);
+    REQUIRE(buffer.push(message::EnvelopeRef(envelope)));
+    REQUIRE(buffer.push(message::EnvelopeRef(envelope)));
+    REQUIRE(envelope->refCount() == 3);
+
+    REQUIRE(buffer.pop());
+    REQUIRE(envelope->refCount() == 2);
+
+    buffer.clear();
+    REQUIRE(envelope->refCount() == 1);
+}
+
+
+
+namespace
+{
+    // channel queue element before ring buffers (owned copies of data and blobs)
+    struct CopyingProcessingData
+    {
+        uint32_t local_channel_id_;
+        message::MessageHeader message_;
+        std::vector<uint8_t> data_;
+        std::vector<message::SharedDataBlob> blobs_;
+    };
+
+    // channel queue element with ring buffers (shared envelope)
+    struct SharedProcessingData
+    {
+        uint32_t local_channel_id_;
+        message::EnvelopeRef envelope_;
+    };
+}
+
+
+
+TEST_CASE("RingBuffer channel queue throughput", "[.][benchmark][ring_buffer]")
+{
+    constexpr uint32_t batch = 64;   // messages per benchmark run, divide by run time for messages/sec
+
+    std::vector<uint8_t> payload(256, 42);
+    message::MessageHeader header { .data_ = payload.data(), .data_len_ = payload.size(), .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = true, .deadline_ns_ = 0 };
+    message::EnvelopeRef envelope(message::MessageEnvelope::create(header));
+
+    std::queue<CopyingProcessingData> deque_queue;
+    BENCHMARK("std::queue, copied payload (64 messages)")
+    {
+        for (uint32_t i = 0; i < batch; ++i)
+        {
+            CopyingProcessingData data { .local_channel_id_ = 0, .message_ = header, .data_ = std::vector<uint8_t>(header.data_, header.data_ + header.data_len_), .blobs_ = {} };
+            data.message_.data_ = data.data_.data();
+            deque_queue.push(std::move(data));
+        }
+
+        uint64_t sum = 0;
+        while (!deque_queue.empty())
+        {
+            CopyingProcessingData data = std::move(deque_queue.front());
+            deque_queue.pop();
+            sum += data.message_.data_[0];
+        }
+        return sum;
+    };
+
+    dll::RingBuffer<SharedProcessingData> ring_buffer(batch);
+    BENCHMARK("RingBuffer, shared envelope (64 messages)")
+    {
+        for (uint32_t i = 0; i < batch; ++i)
+        {
+            envelope->addRef();
+            ring_buffer.push(SharedProcessingData { .local_channel_id_ = 0, .envelope_ = message::EnvelopeRef(envelope.get()) });
+        }
+
+        uint64_t sum = 0;
+        SharedProcessingData data;
+        while (ring_buffer.pop(data))
+        {
+            sum += data.envelope_->message().data_[0];
+        }
+        return sum;
+    };
+}
\ No newline at end of file
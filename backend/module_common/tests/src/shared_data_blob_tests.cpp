@@ -1,7 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstring>
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "module_common/module_interface_.h"
 
@@ -130,4 +132,318 @@ TEST_CASE("SharedDataBlob basic functionality", "[shared_data_blob]")
     }
     REQUIRE(!allocator.exists(4));
 
+}
+
+
+
+TEST_CASE("SharedDataBlob assignment releases previous data", "[shared_data_blob]")
+{
+    TestAllocator allocator;
+
+    {
+        auto blob5 = allocator.allocate(5);
+        auto blob6 = allocator.allocate(6);
+        const message::SharedDataBlob& blob6_ref = blob6;
+
+        blob5 = blob6_ref;
+        REQUIRE(!allocator.exists(5));
+        REQUIRE(allocator.exists(6));
+        REQUIRE(blob5.data() == blob6.data());
+
+        blob5 = blob5;
+        REQUIRE(allocator.exists(6));
+    }
+    REQUIRE(!allocator.exists(6));
+
+    {
+        auto blob7 = allocator.allocate(7);
+        auto blob8 = allocator.allocate(8);
+
+        blob7 = std::move(blob8);
+        REQUIRE(!allocator.exists(7));
+        REQUIRE(allocator.exists(8));
+    }
+    REQUIRE(!allocator.exists(8));
+}
+
+
+
+namespace
+{
+    /// @brief Owner count in the shared data itself.
+    class HeaderCountedSharedData : public ICountedSharedData
+    {
+    public:
+        bool valid() noexcept override { return true; }
+        uint8_t* data() noexcept override { return nullptr; }
+        uint64_t size() noexcept override { return 0; }
+
+        uint64_t owners() { return owners_.load(); }
+        void decrease() { --owners_; }
+    };
+
+
+
+    /// @brief Counts calls, frees on the last owner.
+    class HeaderCountingAllocator : public IAllocator
+    {
+    public:
+        message::SharedDataBlob allocate(uint64_t number_of_bytes) noexcept override
+        {
+            return message::SharedDataBlob(&data_, this);
+        }
+
+        HeaderCountedSharedData data_;
+        uint64_t add_owner_calls_ = 0;
+        uint64_t remove_owner_calls_ = 0;
+        bool freed_ = false;
+
+    protected:
+        void addOwner(ISharedData* data) noexcept override { ++add_owner_calls_; }
+
+        void removeOwner(ISharedData* data) noexcept override
+        {
+            ++remove_owner_calls_;
+            data_.decrease();
+            freed_ = (data_.owners() == 0);
+        }
+    };
+}
+
+
+
+TEST_CASE("SharedDataBlob header owner count", "[shared_data_blob]")
+{
+    // the count lives in ICountedSharedData, the exported interface keeps its layout (vtable pointer only)
+    static_assert(sizeof(ISharedData) == sizeof(void*));
+
+    HeaderCountingAllocator allocator;
+
+    {
+        auto blob = allocator.allocate(1);
+        REQUIRE(allocator.data_.owners() == 1);
+
+        std::vector<message::SharedDataBlob> copies(10, blob);
+        REQUIRE(allocator.data_.owners() == 11);
+
+        copies.clear();
+        REQUIRE(allocator.data_.owners() == 1);
+        REQUIRE(!allocator.freed_);
+    }
+
+    // allocator is entered only for the last owner
+    REQUIRE(allocator.add_owner_calls_ == 0);
+    REQUIRE(allocator.remove_owner_calls_ == 1);
+    REQUIRE(allocator.freed_);
+}
+
+
+TEST_CASE("SharedDataBlob views", "[shared_data_blob]")
+{
+    TestAllocator allocator;
+
+    {
+        message::SharedDataBlob frame = allocator.allocate(1000);
+        uint8_t* frame_data = frame.data();
+        REQUIRE(!frame.isView());
+        REQUIRE(frame.rows() == 1);
+        REQUIRE(frame.rowBytes() == 1000);
+        REQUIRE(frame.stride() == 1000);
+
+        message::SharedDataBlob stripe = frame.view(100, 200);
+        REQUIRE(stripe.valid());
+        REQUIRE(stripe.isView());
+        REQUIRE(stripe.data() == frame_data + 100);
+        REQUIRE(stripe.size() == 200);
+
+        // 10x5 region of a 100 bytes wide image, starting at x = 20, y = 3
+        message::SharedDataBlob region = frame.view2D(3 * 100 + 20, 10, 5, 100);
+        REQUIRE(region.valid());
+        REQUIRE(region.data() == frame_data + 320);
+        REQUIRE(region.rows() == 5);
+        REQUIRE(region.rowBytes() == 10);
+        REQUIRE(region.stride() == 100);
+        REQUIRE(region.size() == 4 * 100 + 10);
+
+        // views of views are relative to the view
+        message::SharedDataBlob sub_stripe = stripe.view(50, 150);
+        REQUIRE(sub_stripe.valid());
+        REQUIRE(sub_stripe.data() == frame_data + 150);
+        REQUIRE(sub_stripe.size() == 150);
+        REQUIRE(stripe.view(50, 151).valid() == false);
+
+        // out of bounds or malformed
+        REQUIRE(frame.view(1000, 0).valid());
+        REQUIRE(!frame.view(1001, 0).valid());
+        REQUIRE(!frame.view(900, 101).valid());
+        REQUIRE(!frame.view(1, UINT64_MAX).valid());
+        REQUIRE(!frame.view2D(0, 101, 2, 100).valid());
+        REQUIRE(!frame.view2D(0, 10, 0, 100).valid());
+        REQUIRE(!frame.view2D(0, 0, 2, 0).valid());
+        REQUIRE(!frame.view2D(0, 10, UINT64_MAX, UINT64_MAX / 2).valid());
+        REQUIRE(!frame.view2D(991, 10, 1, 10).valid());
+        REQUIRE(!message::SharedDataBlob().view(0, 0).valid());
+
+        // views keep the data alive, copies and moves keep the view
+        message::SharedDataBlob region_copy;
+        region_copy = region;
+        message::SharedDataBlob region_moved(std::move(region));
+        frame = message::SharedDataBlob();
+        stripe = message::SharedDataBlob();
+        sub_stripe = message::SharedDataBlob();
+        REQUIRE(allocator.exists(1000));
+        REQUIRE(region_copy.data() == frame_data + 320);
+        REQUIRE(region_moved.size() == 410);
+
+        region_copy = message::SharedDataBlob();
+        REQUIRE(allocator.exists(1000));
+    }
+
+    REQUIRE(!allocator.exists(1000));
+}
+
+
+namespace
+{
+    /// @brief Owner count in the shared data itself, real memory.
+    class BufferSharedData : public ICountedSharedData
+    {
+    public:
+        BufferSharedData(uint64_t size) : buffer_(size) {}
+
+        bool valid() noexcept override { return true; }
+        uint8_t* data() noexcept override { return buffer_.data(); }
+        uint64_t size() noexcept override { return buffer_.size(); }
+
+        uint64_t owners() { return owners_.load(); }
+
+    private:
+        std::vector<uint8_t> buffer_;
+
+        friend class BufferAllocator;
+    };
+
+
+
+    class BufferAllocator : public IAllocator
+    {
+    public:
+        message::SharedDataBlob allocate(uint64_t number_of_bytes) noexcept override
+        {
+            ++allocations_;
+            ++live_;
+            return message::SharedDataBlob(new BufferSharedData(number_of_bytes), this);
+        }
+
+        uint64_t allocations_ = 0;
+        int64_t live_ = 0;
+
+    protected:
+        void addOwner(ISharedData* data) noexcept override {}
+
+        void removeOwner(ISharedData* data) noexcept override
+        {
+            if (--static_cast<BufferSharedData*>(data)->owners_ == 0)
+            {
+                --live_;
+                delete data;
+            }
+        }
+    };
+}
+
+
+
+TEST_CASE("SharedDataBlob copy-on-write", "[shared_data_blob]")
+{
+    BufferAllocator allocator;
+
+    SECTION("sole owner mutates in place")
+    {
+        message::SharedDataBlob frame = allocator.allocate(100);
+        uint8_t* data = frame.data();
+        REQUIRE(frame.unique());
+
+        // chained filters: each takes the blob over and writes in place
+        for (uint8_t stage = 0; stage < 3; ++stage)
+        {
+            message::SharedDataBlob taken(std::move(frame));
+            REQUIRE(taken.makeWritable());
+            REQUIRE(taken.data() == data);
+            taken.data()[0] = stage;
+            frame = std::move(taken);
+        }
+        REQUIRE(allocator.allocations_ == 1);
+        REQUIRE(frame.data()[0] == 2);
+    }
+
+    SECTION("shared data is copied")
+    {
+        message::SharedDataBlob frame = allocator.allocate(100);
+        std::memset(frame.data(), 7, 100);
+        message::SharedDataBlob other_owner = frame;
+        REQUIRE(!frame.unique());
+        REQUIRE(!other_owner.unique());
+
+        REQUIRE(frame.makeWritable());
+        REQUIRE(allocator.allocations_ == 2);
+        REQUIRE(frame.data() != other_owner.data());
+        REQUIRE(frame.unique());
+        REQUIRE(other_owner.unique());
+        REQUIRE(frame.data()[99] == 7);
+
+        frame.data()[0] = 1;
+        REQUIRE(other_owner.data()[0] == 7);
+
+        // copy from a different allocator
+        BufferAllocator other_allocator;
+        message::SharedDataBlob copy = frame;
+        REQUIRE(copy.makeWritable(&other_allocator));
+        REQUIRE(other_allocator.allocations_ == 1);
+    }
+
+    SECTION("views are copied with their layout")
+    {
+        message::SharedDataBlob frame = allocator.allocate(1000);
+        for (int i = 0; i < 1000; ++i)
+        {
+            frame.data()[i] = static_cast<uint8_t>(i);
+        }
+
+        // a view is another owner of the frame
+        message::SharedDataBlob region = frame.view2D(120, 10, 3, 100);
+        REQUIRE(!frame.unique());
+        REQUIRE(!region.unique());
+
+        REQUIRE(region.makeWritable());
+        REQUIRE(region.isView());
+        REQUIRE(region.rows() == 3);
+        REQUIRE(region.rowBytes() == 10);
+        REQUIRE(region.stride() == 100);
+        REQUIRE(region.size() == 210);
+        REQUIRE(region.data()[0] == 120);
+        REQUIRE(region.data()[200] == static_cast<uint8_t>(320));
+        REQUIRE(frame.unique());
+
+        // sole owner of a view writes into the original data
+        message::SharedDataBlob stripe = frame.view(500, 100);
+        frame = message::SharedDataBlob();
+        uint8_t* stripe_data = stripe.data();
+        REQUIRE(stripe.unique());
+        REQUIRE(stripe.makeWritable());
+        REQUIRE(stripe.data() == stripe_data);
+    }
+
+    SECTION("invalid blobs and allocators counting owners are not unique")
+    {
+        message::SharedDataBlob invalid;
+        REQUIRE(!invalid.unique());
+        REQUIRE(!invalid.makeWritable(&allocator));
+
+        TestAllocator counting_allocator;
+        message::SharedDataBlob counted = counting_allocator.allocate(10);
+        REQUIRE(!counted.unique());
+    }
+
+    REQUIRE(allocator.live_ == 0);
 }
\ No newline at end of file
@@ -129,7 +129,10 @@ void ActivationWrapper::processRequest(uint32_t response_producer_id, ChannelIde
             .data_len_ = sizeof(response),
             .blobs_ = extra_data.valid() ? &extra_data : nullptr,
             .blob_count_ = extra_data.valid() ? 1u : 0u,
-            .success_ = true
+            .id_ = 0,
+            .timestamp_ns_ = 0,
+            .success_ = true,
+            .deadline_ns_ = 0
         };
         base_module_ref_->sendResponse(response_producer_id, source_channel, message.id_, message);
     }
@@ -60,7 +60,7 @@ void ModuleA::processRequest(uint32_t response_producer_id, ChannelIdentifier so
         if (message.data_len_ != sizeof(messages::request_response::LargeVariableReq))
         {
             LOG(logging::LogType::WARNING, "Unexpected message data length: " << message.data_len_ << "B (expected " << sizeof(messages::request_response::LargeVariableReq) << "B)")
-            sendResponse(0, source_channel, message.id_, {.success_ = false});
+            sendResponse(0, source_channel, message.id_, { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = false, .deadline_ns_ = 0 });
             return;
         }
         messages::request_response::LargeVariableReq* request = (messages::request_response::LargeVariableReq*)message.data_;
@@ -81,13 +81,13 @@ void ModuleA::processRequest(uint32_t response_producer_id, ChannelIdentifier so
         if (!data_blob.valid())
         {
             log(logging::LogType::WARNING, "Allocated data blob is not valid!");
-            sendResponse(0, source_channel, message.id_, {.success_ = false});
+            sendResponse(0, source_channel, message.id_, { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = false, .deadline_ns_ = 0 });
             return;
         }
         if (data_blob.size() != request->requested_size_)
         {
             LOG(logging::LogType::WARNING, "Data blob size is not " << request->requested_size_ << "B (actual size = " << data_blob.size() << "B)")
-            sendResponse(0, source_channel, message.id_, {.success_ = false});
+            sendResponse(0, source_channel, message.id_, { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = false, .deadline_ns_ = 0 });
             return;
         }
 
@@ -104,14 +104,17 @@ void ModuleA::processRequest(uint32_t response_producer_id, ChannelIdentifier so
             .data_len_ = sizeof(response),
             .blobs_ = &data_blob,
             .blob_count_ = 1,
-            .success_ = true
+            .id_ = 0,
+            .timestamp_ns_ = 0,
+            .success_ = true,
+            .deadline_ns_ = 0
         };
         sendResponse(0, source_channel, message.id_, resp_message);
     }
     else
     {
         LOG(logging::LogType::WARNING, "Unknown request source: " << response_producer_id)
-        sendResponse(response_producer_id, source_channel, message.id_, {.success_ = false});
+        sendResponse(response_producer_id, source_channel, message.id_, { .data_ = nullptr, .data_len_ = 0, .blobs_ = nullptr, .blob_count_ = 0, .id_ = 0, .timestamp_ns_ = 0, .success_ = false, .deadline_ns_ = 0 });
         return;
     }
 }
@@ -142,7 +145,11 @@ void ModuleA::cycleImpl()
             .data_ = (uint8_t*)(&small_message),
             .data_len_ = sizeof(small_message),
             .blobs_ = nullptr,
-            .blob_count_ = 0
+            .blob_count_ = 0,
+            .id_ = 0,
+            .timestamp_ns_ = 0,
+            .success_ = true,
+            .deadline_ns_ = 0
         };
         sendMessage(0, message);
     }
@@ -179,7 +186,11 @@ void ModuleA::cycleImpl()
             .data_ = (uint8_t*)(&large_message),
             .data_len_ = sizeof(large_message),
             .blobs_ = &data_blob,
-            .blob_count_ = 1
+            .blob_count_ = 1,
+            .id_ = 0,
+            .timestamp_ns_ = 0,
+            .success_ = true,
+            .deadline_ns_ = 0
         };
         sendMessage(1, message);
     }
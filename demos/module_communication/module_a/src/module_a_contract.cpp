@@ -3,7 +3,7 @@
 #include "module_common/dll_module_wrapper.h"
 
 
-#define MODULE_A_API_VERSION 2
+#define MODULE_A_API_VERSION 19
 
 static_assert(MODULE_A_API_VERSION == PLUGIN_API_VERSION,
     "Incompatible plugin API version in module.");
@@ -59,7 +59,7 @@ aergo::module::dll::IDllModule* createModule(const char* data_path, ICore* core,
     auto module = std::make_unique<ModuleA>(data_path, core, channel_map_info, logger, module_id);
     if (module->valid())
     {
-        return new aergo::module::dll::DllModuleWrapper(std::move(module), &module_a_info, logger);
+        return new aergo::module::dll::DllModuleWrapper(std::move(module), &module_a_info, logger, core, module_id);
     }
     else
     {